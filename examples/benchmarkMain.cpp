@@ -0,0 +1,63 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+// Benchmarks registered with TIMED_BENCHMARK, main() is provided by the timed_main library. Try
+//   ./benchmarkExample --list
+//   ./benchmarkExample --filter=vector --min-time=200ms
+//   ./benchmarkExample --filter=sum --threads=1,2,4
+//   ./benchmarkExample --filter=sortVector
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "timed/Registry.h"
+
+namespace {
+
+std::vector<uint64_t> data(1 << 16, 1);
+std::vector<uint64_t> buffer;
+
+void sumVector() {
+  uint64_t sum = std::accumulate(data.begin(), data.end(), uint64_t(0));
+  timed::benchmark::doNotOptimize(sum);
+}
+
+void vectorPushBack() {
+  for (uint64_t i = 0; i < 1000; ++i) {
+    buffer.push_back(i);
+  }
+  timed::benchmark::clobberMemory();
+}
+
+std::vector<int64_t> unsorted;
+
+// argument 0: number of elements
+void sortVector(const timed::benchmark::Arguments &args) {
+  std::vector<int64_t> copy(unsorted.begin(), unsorted.begin() + args[0]);
+  std::sort(copy.begin(), copy.end());
+  timed::benchmark::doNotOptimize(copy.data());
+}
+
+}  // namespace
+
+TIMED_BENCHMARK(sumVector).iterations(1000).bytesPerIteration(sizeof(uint64_t) << 16).itemsPerIteration(1 << 16);
+
+TIMED_BENCHMARK(vectorPushBack).iterations(1000).itemsPerIteration(1000).setup([]() {
+  buffer = std::vector<uint64_t>();
+});
+
+TIMED_BENCHMARK(sortVector)
+  .argGeometricRange(1 << 8, 1 << 16, 4)
+  .iterations(50)
+  .complexity()
+  .setup([](const timed::benchmark::Arguments &args) {
+    if (unsorted.size() >= static_cast<size_t>(args[0])) { return; }
+    std::mt19937_64 gen(42);
+    unsorted.resize(static_cast<size_t>(args[0]));
+    for (auto &x: unsorted) { x = static_cast<int64_t>(gen()); }
+  });
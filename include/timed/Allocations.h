@@ -0,0 +1,55 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_ALLOCATIONS_H_
+#define TIMED_ALLOCATIONS_H_
+
+#pragma once
+
+#include <cstdint>
+
+namespace timed {
+
+/**
+ * Heap allocation counters of one thread, maintained by the AllocationTracker library.
+ * Bytes allocated are the requested sizes, live bytes are usable sizes (malloc_usable_size()) of blocks allocated minus
+ * blocks freed by this thread, so memory freed by another thread than the allocating one shows up in that thread.
+ */
+struct AllocationCounters {
+  uint64_t allocations = 0;
+  uint64_t deallocations = 0;
+  uint64_t bytesAllocated = 0;
+  int64_t liveBytes = 0;
+  // highest liveBytes since the thread started or since resetPeakLiveBytes()
+  int64_t peakLiveBytes = 0;
+};
+
+/**
+ * @return true if the AllocationTracker library is linked into the program
+ */
+bool allocationTrackingEnabled();
+
+/**
+ * @return counters of the calling thread (all zero if allocation tracking is not enabled)
+ */
+AllocationCounters threadAllocationCounters();
+
+/**
+ * Set the peak live bytes of the calling thread to its current live bytes.
+ */
+void resetPeakLiveBytes();
+
+namespace detail {
+
+/**
+ * Set by the AllocationTracker library during static initialization: returns the counters of the calling thread.
+ */
+extern AllocationCounters *(*threadAllocationCountersHook)();
+
+}  // namespace detail
+
+}  // namespace timed
+
+#endif  // TIMED_ALLOCATIONS_H_
@@ -12,9 +12,20 @@
 #include <algorithm>
 #include <ostream>
 #include <functional>
-
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+
+#include "timed/Allocations.h"
+#include "timed/Environment.h"
+#include "timed/PerfCounters.h"
+#include "timed/SampleSink.h"
 #include "timed/Timer.h"
 #include "timed/TimeUtils.h"
+#include "timed/utils/Histogram.h"
+#include "timed/utils/Statistics.h"
 
 #define BENCHMARK(func, ...) [](auto&& func, auto&& ...__VA_ARGS__)
 
@@ -22,69 +33,810 @@ namespace timed {
 namespace benchmark {
 
 
+/**
+ * Clock source used for wall time measurements:
+ *  - STEADY: std::chrono::steady_clock (WallTimer)
+ *  - TSC: calibrated CPU time stamp counter (TscTimer), falls back to steady_clock if no invariant TSC is available
+ */
+enum class WallClock { STEADY, TSC };
+
 struct Config {
   std::string title = "Benchmark";
   std::string info;
   unsigned iterations = 1;
+  WallClock wallClock = WallClock::STEADY;
+  // additionally measure the CPU time of the calling thread (cpuTimes always holds whole-process CPU time)
+  bool threadCpuTime = false;
+  // record samples into fixed memory histograms instead of keeping every sample (see Result::histogramOnly)
+  bool histogram = false;
+  unsigned histogramSignificantDigits = 3;
+  // stream raw samples to sink as they are taken instead of keeping them in memory, statistics are kept in histograms
+  // (implies histogram, see Result::useSink()). Used by run() only, not by runScaling(). Every run() begins and ends
+  // the sink once, so one sink can be shared by several runs (e.g. repetitions, MmapSampleSink appends their samples).
+  std::shared_ptr<SampleSink> sink;
+  // adaptive mode (iterations is ignored): op is called in batches that take at least minSampleTime each, samples are
+  // taken until the 95% confidence interval of the mean wall time lies within targetRelativeError of the mean (after at
+  // least minSamples samples and minTime), maxTime has passed or maxSamples samples were taken.
+  // Samples and baselines are per op call (batch time / batch size), precedentOp runs once per batch.
+  bool autoIterations = false;
+  Time minSampleTime = Time::fromNanoseconds(10 * Time::NS_PER_US);
+  double targetRelativeError = 0.01;
+  Time maxTime = Time::fromNanoseconds(Time::NS_PER_S);
+  Time minTime;
+  unsigned minSamples = 10;
+  unsigned maxSamples = 1000000;
+  // warmup before recording: at least warmupIterations samples and warmupTime. With detectSteadyState, warmup
+  // additionally continues until the median of the last steadyStateWindow samples differs from the median of the
+  // window before it by at most steadyStateTolerance (relative), or maxWarmupTime has passed.
+  // Warmup samples are not part of the results, they are kept in Result::warmupWallTimes.
+  unsigned warmupIterations = 0;
+  Time warmupTime;
+  bool detectSteadyState = false;
+  unsigned steadyStateWindow = 10;
+  double steadyStateTolerance = 0.05;
+  Time maxWarmupTime = Time::fromNanoseconds(Time::NS_PER_S);
+  // scaling mode (runScaling()): thread counts to run op with (empty: 1, 2, 4, ... up to hardware_concurrency), every
+  // thread runs iterations iterations. With pinThreads, thread i is pinned to the i-th core the process may run on
+  // (modulo their number).
+  std::vector<unsigned> threadCounts;
+  bool pinThreads = false;
+  // work done by one op call, reported as throughput (bytes/s, items/s) if non zero
+  uint64_t bytesPerIteration = 0;
+  uint64_t itemsPerIteration = 0;
+  // count hardware events (PerfCounterTimer) around every measured sample and report them per op call. If the counters
+  // are not available, the run continues without them (see Result::perfCountersError). Used by run() only.
+  bool perfCounters = false;
+  std::vector<PerfEvent> perfEvents = defaultPerfEvents();
+  // upper limit of Result::allocationsPerOp() checked by runRegistered() (negative: no limit), e.g. 0 for paths that
+  // must not allocate. Needs the AllocationTracker library, without it every limit counts as exceeded.
+  double maxAllocationsPerOp = -1;
+  // noise control for run(): pin the calling thread to the pinCpu-th core it may run on (modulo their number, negative:
+  // no pinning), run it with SCHED_FIFO and priority realtimePriority (0: keep the scheduling policy) and lock all
+  // memory of the process (mlockall). Everything is restored after the run, settings that cannot be applied
+  // (permissions, platform) are recorded in Result::warnings.
+  int pinCpu = -1;
+  int realtimePriority = 0;
+  bool lockMemory = false;
 };
 
 std::ostream &operator<<(std::ostream &os, const Config &config);
 
 
+struct PerfCounterValue {
+  PerfEvent event = PerfEvent::CYCLES;
+  // mean count per op call
+  double perOp = 0;
+};
+
+
 struct Result {
   std::string title = "Benchmark";
   std::string info;
   std::vector<Time> wallTimes;
   std::vector<Time> cpuTimes;
+  std::vector<Time> threadCpuTimes;
+  // estimated timer overhead per sample, subtracted (clamped at zero) by adjusted*Times() and the printed statistics
   Time wallTimeBaseline;
   Time cpuTimeBaseline;
+  Time threadCpuTimeBaseline;
+  // op calls per sample (> 1 in adaptive mode only), samples and baselines are per op call
+  uint64_t batchSize = 1;
+  // work done by one op call (copied from Config, may be set after the run)
+  uint64_t bytesPerIteration = 0;
+  uint64_t itemsPerIteration = 0;
+  // discarded wall times of the warmup phase (per op call, not baseline adjusted)
+  std::vector<Time> warmupWallTimes;
+  // if true, add*Time() records baseline adjusted samples into the histograms below and the sample vectors stay empty
+  bool histogramOnly = false;
+  utils::Histogram wallHistogram;
+  utils::Histogram cpuHistogram;
+  utils::Histogram threadCpuHistogram;
+  // if set (histogramOnly is set as well), add*Time() additionally pass the raw samples to sink
+  std::shared_ptr<SampleSink> sink;
+  // hardware event counts per op call (Config::perfCounters), they include the overhead of the wall and CPU timers
+  std::vector<PerfCounterValue> perfCounters;
+  // why perfCounters is empty although Config::perfCounters was set
+  std::string perfCountersError;
+  // heap allocations of the calling thread while op ran (measured samples of all runs), only if the AllocationTracker
+  // library is linked
+  bool allocationsTracked = false;
+  uint64_t allocations = 0;
+  uint64_t allocatedBytes = 0;
+  // most heap bytes live at once during one sample, above the live bytes at the start of the sample
+  int64_t peakLiveBytes = 0;
+  // machine the samples were taken on (set by run())
+  MachineContext machine;
+  // noisy settings of the machine (environmentWarnings()) and Config settings that could not be applied
+  std::vector<std::string> warnings;
+
+  /**
+   * Switch to histogram mode with the given precision. Must be called before samples are added.
+   */
+  void useHistograms(unsigned significantDigits);
+
+  /**
+   * Switch to histogram mode and stream raw samples to sink. Must be called before samples are added, sink->begin()
+   * must have been called before the first sample.
+   */
+  void useSink(std::shared_ptr<SampleSink> sampleSink, unsigned significantDigits);
+
+  /**
+   * @return number of recorded wall time samples
+   */
+  [[nodiscard]] size_t size() const;
 
   void addWallTime(Time time);
 
   void addCpuTime(Time time);
 
+  void addThreadCpuTime(Time time);
+
   [[nodiscard]] std::vector<Time> adjustedWallTimes() const;
 
+  /**
+   * @return mean baseline adjusted wall time of one op call
+   */
+  [[nodiscard]] Time meanAdjustedWallTime() const;
+
+  /**
+   * @return bytesPerIteration / meanAdjustedWallTime() (0 if unknown)
+   */
+  [[nodiscard]] double bytesPerSecond() const;
+
+  /**
+   * @return itemsPerIteration / meanAdjustedWallTime() (0 if unknown)
+   */
+  [[nodiscard]] double itemsPerSecond() const;
+
+  /**
+   * @return count of event per op call, 0 if it was not counted
+   */
+  [[nodiscard]] double perfCounter(PerfEvent event) const;
+
+  /**
+   * @return instructions per cycle, 0 if they were not counted
+   */
+  [[nodiscard]] double instructionsPerCycle() const;
+
+  /**
+   * @return heap allocations per op call (0 if not tracked)
+   */
+  [[nodiscard]] double allocationsPerOp() const;
+
+  /**
+   * @return allocated heap bytes per op call (0 if not tracked)
+   */
+  [[nodiscard]] double allocatedBytesPerOp() const;
+
   [[nodiscard]] std::vector<Time> adjustedCPUTimes() const;
+
+  [[nodiscard]] std::vector<Time> adjustedThreadCPUTimes() const;
 };
 
 std::ostream &operator<<(std::ostream &os, const Result &result);
 
 
-class Benchmark {
+/**
+ * Result of one thread count of a scaling run (BasicBenchmark::runScaling()).
+ */
+struct ScalingResult {
+  unsigned threads = 1;
+  // op calls of all threads together
+  uint64_t operations = 0;
+  // from releasing the threads until the last thread finished
+  Time wallTime;
+  // op calls per second of all threads together
+  double throughput = 0;
+  // throughput per thread relative to the throughput per thread of the smallest thread count (1: perfect scaling)
+  double efficiency = 0;
+  // true if every thread was pinned to a core
+  bool pinned = false;
+  // per call wall times of all threads (wallTimes and wallTimeBaseline only)
+  Result latencies;
+};
+
+std::ostream &operator<<(std::ostream &os, const ScalingResult &result);
+
+
+/**
+ * Default precedent operation: does nothing.
+ */
+struct NoOp {
+  void operator()() const {}
+};
+
+namespace detail {
+
+// timers used inside the measurement loop only need the running total, AccumulatorStorage never allocates
+using LoopWallTimer = BasicWallTimer<AccumulatorStorage<SteadyClockInterval>>;
+using LoopTscTimer = BasicTscTimer<AccumulatorStorage<TscInterval>>;
+using LoopCPUTimer = BasicCPUTimer<AccumulatorStorage<CPUClockInterval>>;
+
+#if !defined(__GNUC__) && !defined(__clang__)
+void useCharPointer(const volatile char *);
+#endif
+
+/**
+ * Pin the calling thread to the cpu-th core (modulo their number) of the cores it is allowed to run on (its affinity
+ * mask, e.g. restricted by taskset or a container cpuset).
+ * @return false if pinning failed or is not supported on this platform
+ */
+bool pinCurrentThread(unsigned cpu);
+
+/**
+ * @return 1, 2, 4, ... up to std::thread::hardware_concurrency() (included even if it is not a power of two)
+ */
+std::vector<unsigned> defaultThreadCounts();
+
+/**
+ * @return counters of config.perfEvents if config.perfCounters is set and they are available, else nullptr (and
+ *         result.perfCountersError is set if they were requested)
+ */
+std::unique_ptr<PerfCounterTimer> openPerfCounters(const Config &config, Result &result);
+
+/**
+ * Store the counts of perfCounters divided by operations in result.perfCounters.
+ */
+void setPerfCounters(const PerfCounterTimer &perfCounters, uint64_t operations, Result &result);
+
+/**
+ * Applies the noise control settings of config (pinCpu, realtimePriority, lockMemory) to the calling thread and
+ * restores the previous settings on destruction. Records the machine context and warnings in result.
+ */
+class ScopedEnvironment {
+ public:
+  ScopedEnvironment(const Config &config, Result &result);
+
+  ScopedEnvironment(const ScopedEnvironment &) = delete;
+
+  ScopedEnvironment &operator=(const ScopedEnvironment &) = delete;
+
+  ~ScopedEnvironment();
+
+ private:
+  // previous affinity mask (cpu_set_t), empty if the thread was not pinned
+  std::vector<unsigned char> _affinity;
+  bool _realtime = false;
+  int _policy = 0;
+  int _priority = 0;
+  bool _lockedMemory = false;
+};
+
+/**
+ * Sums the heap allocations of the calling thread from start() to stop() (AllocationTracker library).
+ */
+class AllocationProbe {
+ public:
+  /**
+   * @return true if the AllocationTracker library is linked
+   */
+  [[nodiscard]] bool enabled() const;
+
+  void start();
+
+  void stop();
+
+  /**
+   * Add the sums to result (allocationsTracked, allocations, allocatedBytes, peakLiveBytes).
+   */
+  void store(Result &result) const;
+
+ private:
+  bool _enabled = allocationTrackingEnabled();
+  AllocationCounters _start;
+  uint64_t _allocations = 0;
+  uint64_t _bytes = 0;
+  int64_t _peakLiveBytes = 0;
+};
+
+/**
+ * Timer overhead of one sample of the measurement loop, per timer.
+ */
+struct LoopOverhead {
+  Time wall;
+  Time cpu;
+  Time threadCpu;
+};
+
+// _____________________________________________________________________________________________________________________
+// the timers are nested exactly like in BasicBenchmark::runBatch(), so the wall overhead includes starting and stopping
+// the CPU timers
+template<typename WallTimerT>
+LoopOverhead measureLoopOverhead(bool threadCpuTime) {
+  constexpr int WARMUP = 100;
+  constexpr int SAMPLES = 1000;
+  WallTimerT wallTimer;
+  LoopCPUTimer cpuTimer;
+  LoopCPUTimer threadCpuTimer(CPUClock::THREAD);
+  std::vector<Time> wallTimes;
+  std::vector<Time> cpuTimes;
+  std::vector<Time> threadCpuTimes;
+  wallTimes.reserve(SAMPLES);
+  cpuTimes.reserve(SAMPLES);
+  threadCpuTimes.reserve(SAMPLES);
+  for (int i = 0; i < WARMUP + SAMPLES; ++i) {
+    wallTimer.start();
+    cpuTimer.start();
+    if (threadCpuTime) threadCpuTimer.start();
+    if (threadCpuTime) threadCpuTimer.stop();
+    cpuTimer.stop();
+    wallTimer.stop();
+    if (i < WARMUP) continue;
+    wallTimes.push_back(wallTimer.getTime());
+    cpuTimes.push_back(cpuTimer.getTime());
+    if (threadCpuTime) threadCpuTimes.push_back(threadCpuTimer.getTime());
+  }
+  // a low percentile: preempted or cache missing calibration runs must not inflate the overhead
+  utils::Summarizer summarizer;
+  auto low = [&summarizer](const std::vector<Time> &times) {
+    return times.empty() ? Time() : Time::fromNanoseconds(static_cast<int64_t>(summarizer.percentiles(times, {5})[0]));
+  };
+  return {low(wallTimes), low(cpuTimes), low(threadCpuTimes)};
+}
+
+// _____________________________________________________________________________________________________________________
+// measured once per wall timer type and thread CPU time setting per process
+template<typename WallTimerT>
+const LoopOverhead &loopOverhead(bool threadCpuTime) {
+  if (threadCpuTime) {
+    static const LoopOverhead overhead = measureLoopOverhead<WallTimerT>(true);
+    return overhead;
+  }
+  static const LoopOverhead overhead = measureLoopOverhead<WallTimerT>(false);
+  return overhead;
+}
+
+}  // namespace detail
+
+/**
+ * Prevent the compiler from optimizing away the computation of value: value is treated as read (and, for the non-const
+ * overload, modified) by an opaque instruction and has to be materialized in a register or in memory.
+ */
+template<typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  detail::useCharPointer(&reinterpret_cast<const volatile char &>(value));
+  _ReadWriteBarrier();
+#endif
+}
+
+template<typename T>
+inline void doNotOptimize(T &value) {
+#if defined(__clang__)
+  asm volatile("" : "+r,m"(value) : : "memory");
+#elif defined(__GNUC__)
+  if constexpr (std::is_trivially_copyable<T>::value && sizeof(T) <= sizeof(void *)) {
+    asm volatile("" : "+m,r"(value) : : "memory");
+  } else {
+    asm volatile("" : "+m"(value) : : "memory");
+  }
+#else
+  detail::useCharPointer(&reinterpret_cast<const volatile char &>(value));
+  _ReadWriteBarrier();
+#endif
+}
+
+/**
+ * Force all pending memory writes to be performed: the compiler has to assume that any memory may be read here.
+ */
+inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : : "memory");
+#else
+  _ReadWriteBarrier();
+#endif
+}
+
+/**
+ * BasicBenchmark: runs and measures op.
+ * Op and PrecedentOp are stored by value and called directly, so lambdas are inlined into the measurement loop. With
+ * class template argument deduction `BasicBenchmark benchmark(config, []() { ... });` creates such a benchmark.
+ * Benchmark (std::function ops) is the type erased variant.
+ */
+template<typename Op, typename PrecedentOp = NoOp>
+class BasicBenchmark {
  public:
-  explicit Benchmark(std::function<void()> op);
+  explicit BasicBenchmark(Op op);
 
-  Benchmark(std::function<void()> op, std::function<void()> precedentOp);
+  BasicBenchmark(Op op, PrecedentOp precedentOp);
 
-  Benchmark(Config &config, std::function<void()> op);
+  BasicBenchmark(const Config &config, Op op);
 
-  Benchmark(Config &config, std::function<void()> op, std::function<void()> precedentOp);
+  BasicBenchmark(const Config &config, Op op, PrecedentOp precedentOp);
 
   Result &run(bool verbose = false);
 
+  /**
+   * Run op concurrently with every thread count of Config::threadCounts. For each thread count, all threads are
+   * created first and released together through a barrier, each thread then runs Config::iterations iterations of
+   * precedentOp and the timed op. op (and precedentOp) must be safe to call from several threads at once.
+   * @return one ScalingResult per thread count, in the order of Config::threadCounts
+   */
+  std::vector<ScalingResult> runScaling(bool verbose = false);
+
   Result &getResult();
 
   const Result& getResult() const;
 
   const Config &getConfig() const;
 
+  friend std::ostream &operator<<(std::ostream &os, const BasicBenchmark &benchmark) {
+    if (benchmark._run) {
+      os << benchmark._result;
+    } else {
+      os << benchmark._config;
+    }
+    return os;
+  }
+
  private:
+  void init();
+
+  template<typename WallTimerT>
+  Result &runWith(bool verbose);
+
+  template<typename WallTimerT>
+  Result &runAuto(bool verbose);
+
+  template<typename WallTimerT>
+  std::vector<ScalingResult> runScalingWith(bool verbose);
 
+  // run precedentOp once and op batchSize times while the timers are running, perfCounters and allocations (if any) are
+  // read around the timers so that the wall and CPU times do not include reading them
+  template<typename WallTimerT, typename CPUTimerT>
+  void runBatch(uint64_t batchSize, WallTimerT &wallTimer, CPUTimerT &cpuTimer, CPUTimerT &threadCpuTimer,
+                PerfCounterTimer *perfCounters = nullptr, detail::AllocationProbe *allocations = nullptr);
+
+  template<typename WallTimerT>
   void setTimerBaselines();
 
+  template<typename WallTimerT, typename CPUTimerT>
+  void warmup(uint64_t batchSize, WallTimerT &wallTimer, CPUTimerT &cpuTimer, CPUTimerT &threadCpuTimer);
+
+  // compares the samples of warmupWallTimes from index first on (the samples of the current warmup)
+  [[nodiscard]] bool steadyStateReached(size_t first);
+
+  // median of [first, last), computed on _warmupScratch so that the steady state check does not allocate once the
+  // scratch buffer has reached the window size
+  Time windowMedian(std::vector<Time>::const_iterator first, std::vector<Time>::const_iterator last);
+
   // operation that will be benchmarked
-  std::function<void()> _op;
+  Op _op;
   // operation that is run before each iteration to clean up and/or reset things
-  std::function<void()> _precedentOp;
+  PrecedentOp _precedentOp;
   Config _config;
   Result _result;
   bool _run = false;
-
-  friend std::ostream &operator<<(std::ostream &os, const Benchmark &benchmark);
+  std::vector<Time> _warmupScratch;
 };
 
-std::ostream &operator<<(std::ostream &os, const Benchmark &benchmark);
+// ===== BasicBenchmark ================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+BasicBenchmark<Op, PrecedentOp>::BasicBenchmark(Op op) : _op(std::move(op)), _precedentOp(NoOp()) {}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+BasicBenchmark<Op, PrecedentOp>::BasicBenchmark(Op op, PrecedentOp precedentOp)
+    : _op(std::move(op)), _precedentOp(std::move(precedentOp)) {}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+BasicBenchmark<Op, PrecedentOp>::BasicBenchmark(const Config &config, Op op)
+    : _op(std::move(op)), _precedentOp(NoOp()), _config(config) {
+  init();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+BasicBenchmark<Op, PrecedentOp>::BasicBenchmark(const Config &config, Op op, PrecedentOp precedentOp)
+    : _op(std::move(op)), _precedentOp(std::move(precedentOp)), _config(config) {
+  init();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+Result &BasicBenchmark<Op, PrecedentOp>::run(bool verbose) {
+  detail::ScopedEnvironment environment(_config, _result);
+  if (_config.wallClock == WallClock::TSC) {
+    return _config.autoIterations ? runAuto<detail::LoopTscTimer>(verbose) : runWith<detail::LoopTscTimer>(verbose);
+  }
+  return _config.autoIterations ? runAuto<detail::LoopWallTimer>(verbose) : runWith<detail::LoopWallTimer>(verbose);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+std::vector<ScalingResult> BasicBenchmark<Op, PrecedentOp>::runScaling(bool verbose) {
+  if (_config.wallClock == WallClock::TSC) {
+    return runScalingWith<detail::LoopTscTimer>(verbose);
+  }
+  return runScalingWith<detail::LoopWallTimer>(verbose);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+Result &BasicBenchmark<Op, PrecedentOp>::getResult() {
+  return _result;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+const Result &BasicBenchmark<Op, PrecedentOp>::getResult() const {
+  return _result;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+const Config &BasicBenchmark<Op, PrecedentOp>::getConfig() const {
+  return _config;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+void BasicBenchmark<Op, PrecedentOp>::init() {
+  _result.title = _config.title;
+  _result.info = _config.info;
+  _result.bytesPerIteration = _config.bytesPerIteration;
+  _result.itemsPerIteration = _config.itemsPerIteration;
+  if (_config.sink) {
+    _result.useSink(_config.sink, _config.histogramSignificantDigits);
+  } else if (_config.histogram) {
+    _result.useHistograms(_config.histogramSignificantDigits);
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+template<typename WallTimerT>
+Result &BasicBenchmark<Op, PrecedentOp>::runWith(bool verbose) {
+  if (_result.sink) _result.sink->begin(_config.threadCpuTime ? 3 : 2);
+  setTimerBaselines<WallTimerT>();
+  WallTimerT wallTimer;
+  detail::LoopCPUTimer cpuTimer;
+  detail::LoopCPUTimer threadCpuTimer(CPUClock::THREAD);
+  auto perfCounters = detail::openPerfCounters(_config, _result);
+  detail::AllocationProbe allocationProbe;
+  detail::AllocationProbe *allocations = allocationProbe.enabled() ? &allocationProbe : nullptr;
+  warmup(1, wallTimer, cpuTimer, threadCpuTimer);
+  for (unsigned i = 0; i < _config.iterations; ++i) {
+    if (verbose) std::cout << '\r' << i << "/" << _config.iterations << std::flush;
+    runBatch(1, wallTimer, cpuTimer, threadCpuTimer, perfCounters.get(), allocations);
+    _result.addWallTime(wallTimer.getTime());
+    _result.addCpuTime(cpuTimer.getTime());
+    if (_config.threadCpuTime) _result.addThreadCpuTime(threadCpuTimer.getTime());
+  }
+  if (perfCounters) detail::setPerfCounters(*perfCounters, _config.iterations, _result);
+  if (allocations) allocations->store(_result);
+  if (_result.sink) _result.sink->end();
+  if (verbose) std::cout << '\r' << "✅              " << std::endl;
+  _run = true;
+  return _result;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+template<typename WallTimerT>
+Result &BasicBenchmark<Op, PrecedentOp>::runAuto(bool verbose) {
+  if (_result.sink) _result.sink->begin(_config.threadCpuTime ? 3 : 2);
+  setTimerBaselines<WallTimerT>();
+  WallTimerT wallTimer;
+  detail::LoopCPUTimer cpuTimer;
+  detail::LoopCPUTimer threadCpuTimer(CPUClock::THREAD);
+  detail::LoopWallTimer budgetTimer;
+  budgetTimer.start();
+  // grow the batch until a single batch reaches minSampleTime, at most by a factor of 10 per step
+  uint64_t batchSize = 1;
+  while (true) {
+    runBatch(batchSize, wallTimer, cpuTimer, threadCpuTimer);
+    Time batchTime = wallTimer.getTime() - _result.wallTimeBaseline;
+    if (batchTime >= _config.minSampleTime || budgetTimer.getTime() >= _config.maxTime) break;
+    double factor = batchTime.count() == 0
+                    ? 10.0
+                    : std::min(10.0, 1.4 * static_cast<double>(_config.minSampleTime.count()) /
+                                     static_cast<double>(batchTime.count()));
+    batchSize = static_cast<uint64_t>(std::ceil(static_cast<double>(batchSize) * factor));
+  }
+  _result.batchSize = batchSize;
+  _result.wallTimeBaseline = _result.wallTimeBaseline / batchSize;
+  _result.cpuTimeBaseline = _result.cpuTimeBaseline / batchSize;
+  _result.threadCpuTimeBaseline = _result.threadCpuTimeBaseline / batchSize;
+  warmup(batchSize, wallTimer, cpuTimer, threadCpuTimer);
+  auto perfCounters = detail::openPerfCounters(_config, _result);
+  detail::AllocationProbe allocationProbe;
+  detail::AllocationProbe *allocations = allocationProbe.enabled() ? &allocationProbe : nullptr;
+  // running mean and variance (Welford) of the adjusted per op wall times for the stopping rule
+  double mean = 0;
+  double m2 = 0;
+  unsigned n = 0;
+  while (n < _config.maxSamples) {
+    runBatch(batchSize, wallTimer, cpuTimer, threadCpuTimer, perfCounters.get(), allocations);
+    Time wallTime = wallTimer.getTime() / batchSize;
+    _result.addWallTime(wallTime);
+    _result.addCpuTime(cpuTimer.getTime() / batchSize);
+    if (_config.threadCpuTime) _result.addThreadCpuTime(threadCpuTimer.getTime() / batchSize);
+    auto x = static_cast<double>((wallTime - _result.wallTimeBaseline).count());
+    ++n;
+    double delta = x - mean;
+    mean += delta / n;
+    m2 += delta * (x - mean);
+    if (verbose) std::cout << '\r' << n << " samples x " << batchSize << std::flush;
+    if (n >= _config.minSamples && n > 1) {
+      double halfWidth = 1.96 * std::sqrt(m2 / (n - 1)) / std::sqrt(static_cast<double>(n));
+      if (halfWidth <= _config.targetRelativeError * mean && budgetTimer.getTime() >= _config.minTime) break;
+    }
+    if (budgetTimer.getTime() >= _config.maxTime) break;
+  }
+  if (perfCounters) detail::setPerfCounters(*perfCounters, n * batchSize, _result);
+  if (allocations) allocations->store(_result);
+  if (_result.sink) _result.sink->end();
+  if (verbose) std::cout << '\r' << "✅              " << std::endl;
+  _run = true;
+  return _result;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+template<typename WallTimerT>
+std::vector<ScalingResult> BasicBenchmark<Op, PrecedentOp>::runScalingWith(bool verbose) {
+  using Clock = std::chrono::steady_clock;
+  std::vector<unsigned> threadCounts = _config.threadCounts.empty() ? detail::defaultThreadCounts()
+                                                                    : _config.threadCounts;
+  // every thread only starts and stops its wall timer around op
+  bool tsc = std::is_same<WallTimerT, detail::LoopTscTimer>::value && detail::LoopTscTimer::usesTsc();
+  Time baseline = timerOverhead(tsc ? ClockSource::TSC : ClockSource::STEADY);
+  std::vector<ScalingResult> results;
+  for (unsigned threads: threadCounts) {
+    if (threads == 0) { continue; }
+    if (verbose) std::cout << '\r' << threads << " threads" << std::flush;
+    std::vector<std::vector<Time>> latencies(threads, std::vector<Time>(_config.iterations));
+    std::vector<Clock::time_point> finished(threads);
+    std::atomic<unsigned> ready{0};
+    std::atomic<unsigned> pinned{0};
+    std::atomic<bool> released{false};
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t]() {
+        if (_config.pinThreads && detail::pinCurrentThread(t)) { pinned.fetch_add(1, std::memory_order_relaxed); }
+        WallTimerT timer;
+        auto &samples = latencies[t];
+        ready.fetch_add(1, std::memory_order_release);
+        while (!released.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+        for (unsigned i = 0; i < _config.iterations; ++i) {
+          _precedentOp();
+          timer.start();
+          _op();
+          timer.stop();
+          samples[i] = timer.getTime();
+        }
+        finished[t] = Clock::now();
+      });
+    }
+    // barrier: release all threads at once after every thread has been created (and pinned)
+    while (ready.load(std::memory_order_acquire) < threads) { std::this_thread::yield(); }
+    Clock::time_point start = Clock::now();
+    released.store(true, std::memory_order_release);
+    for (auto &worker: workers) { worker.join(); }
+    ScalingResult result;
+    result.threads = threads;
+    result.operations = static_cast<uint64_t>(threads) * _config.iterations;
+    auto end = *std::max_element(finished.begin(), finished.end());
+    result.wallTime = Time::fromNanoseconds(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    if (result.wallTime.count() > 0) {
+      result.throughput = static_cast<double>(result.operations) / result.wallTime.getSeconds();
+    }
+    result.pinned = _config.pinThreads && pinned.load() == threads;
+    result.latencies.title = _config.title + " (" + std::to_string(threads) + " threads)";
+    result.latencies.info = _config.info;
+    result.latencies.bytesPerIteration = _config.bytesPerIteration;
+    result.latencies.itemsPerIteration = _config.itemsPerIteration;
+    result.latencies.wallTimeBaseline = baseline;
+    result.latencies.wallTimes.reserve(result.operations);
+    for (const auto &samples: latencies) {
+      result.latencies.wallTimes.insert(result.latencies.wallTimes.end(), samples.begin(), samples.end());
+    }
+    results.push_back(std::move(result));
+  }
+  // threadCounts need not be ascending, the reference is the result with the smallest thread count
+  auto smallest = std::min_element(results.begin(), results.end(), [](const ScalingResult &a, const ScalingResult &b) {
+    return a.threads < b.threads;
+  });
+  if (smallest != results.end() && smallest->throughput > 0) {
+    double reference = smallest->throughput / smallest->threads;
+    for (auto &result: results) {
+      result.efficiency = result.throughput / result.threads / reference;
+    }
+  }
+  if (verbose) std::cout << '\r' << "✅              " << std::endl;
+  return results;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+template<typename WallTimerT, typename CPUTimerT>
+void BasicBenchmark<Op, PrecedentOp>::runBatch(uint64_t batchSize, WallTimerT &wallTimer, CPUTimerT &cpuTimer,
+                                               CPUTimerT &threadCpuTimer, PerfCounterTimer *perfCounters,
+                                               detail::AllocationProbe *allocations) {
+  _precedentOp();
+  if (allocations) allocations->start();
+  if (perfCounters) perfCounters->start();
+  wallTimer.start();
+  cpuTimer.start();
+  if (_config.threadCpuTime) threadCpuTimer.start();
+  for (uint64_t i = 0; i < batchSize; ++i) {
+    _op();
+  }
+  if (_config.threadCpuTime) threadCpuTimer.stop();
+  cpuTimer.stop();
+  wallTimer.stop();
+  if (perfCounters) perfCounters->stop();
+  if (allocations) allocations->stop();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+template<typename WallTimerT>
+void BasicBenchmark<Op, PrecedentOp>::setTimerBaselines() {
+  const auto &overhead = detail::loopOverhead<WallTimerT>(_config.threadCpuTime);
+  _result.wallTimeBaseline = overhead.wall;
+  _result.cpuTimeBaseline = overhead.cpu;
+  _result.threadCpuTimeBaseline = _config.threadCpuTime ? overhead.threadCpu : Time();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+template<typename WallTimerT, typename CPUTimerT>
+void BasicBenchmark<Op, PrecedentOp>::warmup(uint64_t batchSize, WallTimerT &wallTimer, CPUTimerT &cpuTimer,
+                                             CPUTimerT &threadCpuTimer) {
+  detail::LoopWallTimer warmupTimer;
+  warmupTimer.start();
+  auto &samples = _result.warmupWallTimes;
+  // samples of earlier run() calls are kept, but count neither for the minimum nor for the steady state
+  size_t first = samples.size();
+  while (true) {
+    Time elapsed = warmupTimer.getTime();
+    bool minimumDone = samples.size() - first >= _config.warmupIterations && elapsed >= _config.warmupTime;
+    if (minimumDone && (!_config.detectSteadyState || steadyStateReached(first) || elapsed >= _config.maxWarmupTime)) {
+      break;
+    }
+    runBatch(batchSize, wallTimer, cpuTimer, threadCpuTimer);
+    samples.push_back(wallTimer.getTime() / batchSize);
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+bool BasicBenchmark<Op, PrecedentOp>::steadyStateReached(size_t first) {
+  const auto &samples = _result.warmupWallTimes;
+  size_t window = std::max(_config.steadyStateWindow, 1U);
+  if (samples.size() - first < 2 * window) { return false; }
+  auto last = samples.end() - static_cast<std::ptrdiff_t>(window);
+  auto previous = last - static_cast<std::ptrdiff_t>(window);
+  auto current = static_cast<double>(windowMedian(last, samples.end()));
+  auto before = static_cast<double>(windowMedian(previous, last));
+  return std::abs(current - before) <= _config.steadyStateTolerance * before;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Op, typename PrecedentOp>
+Time BasicBenchmark<Op, PrecedentOp>::windowMedian(std::vector<Time>::const_iterator first,
+                                                   std::vector<Time>::const_iterator last) {
+  _warmupScratch.assign(first, last);
+  auto mid = _warmupScratch.begin() + static_cast<std::ptrdiff_t>(_warmupScratch.size() / 2U);
+  std::nth_element(_warmupScratch.begin(), mid, _warmupScratch.end());
+  if (1U == (_warmupScratch.size() & 1U)) { return *mid; }
+  // the lower middle value is the largest value left of mid
+  return (*std::max_element(_warmupScratch.begin(), mid) + *mid) / 2U;
+}
+
+
+using Benchmark = BasicBenchmark<std::function<void()>, std::function<void()>>;
+
+extern template class BasicBenchmark<std::function<void()>, std::function<void()>>;
 
 
 Result timed(std::function<void()> op, unsigned iterations = 5, std::function<void()> cleanOp = [](){});
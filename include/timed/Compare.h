@@ -0,0 +1,96 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_COMPARE_H_
+#define TIMED_COMPARE_H_
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "timed/Benchmark.h"
+
+namespace timed {
+namespace benchmark {
+
+enum class Verdict { FASTER, SLOWER, UNCHANGED };
+
+const char *toString(Verdict verdict);
+
+struct CompareOptions {
+  // relative change of the median that is considered relevant (0.05: 5% slower or faster)
+  double threshold = 0.05;
+  // significance level of the Mann-Whitney U test
+  double alpha = 0.05;
+  // confidence level of the bootstrap interval of the median ratio
+  double confidence = 0.95;
+  unsigned bootstrapResamples = 1000;
+  uint64_t seed = 0;
+};
+
+/**
+ * Comparison of the baseline adjusted wall times of a contender result with a baseline result.
+ * The verdict is SLOWER (FASTER) if the Mann-Whitney U test is significant at alpha and the median ratio exceeds
+ * 1 + threshold (falls below 1 - threshold), else UNCHANGED.
+ */
+struct Comparison {
+  std::string title;
+  size_t baselineSamples = 0;
+  size_t contenderSamples = 0;
+  Time baselineMedian;
+  Time contenderMedian;
+  // contender median / baseline median (> 1: contender is slower)
+  double ratio = 1;
+  // bootstrap confidence interval of ratio
+  double ratioLow = 1;
+  double ratioHigh = 1;
+  double pValue = 1;
+  Verdict verdict = Verdict::UNCHANGED;
+};
+
+std::ostream &operator<<(std::ostream &os, const Comparison &comparison);
+
+/**
+ * @throws std::runtime_error if one of the results has no raw samples (histogram-only or empty)
+ */
+Comparison compare(const Result &baseline, const Result &contender, const CompareOptions &options = CompareOptions());
+
+/**
+ * Paired comparison of results whose samples were taken alternately (InterleavedBenchmark): sample i of both results
+ * belongs to round i. ratio is the median of the per round ratios contender / baseline, its confidence interval is
+ * bootstrapped over rounds and pValue is that of the Wilcoxon signed-rank test of the per round differences. Drift that
+ * affects both samples of a round cancels out in the ratios.
+ * @throws std::runtime_error if one of the results has no raw samples or the sample counts differ
+ */
+Comparison comparePaired(const Result &baseline, const Result &contender,
+                         const CompareOptions &options = CompareOptions());
+
+/**
+ * Compare every contender with the baseline of the same title. Contenders without baseline and results without raw
+ * samples are skipped.
+ * @return comparisons in the order of contenders
+ */
+std::vector<Comparison> compare(const std::vector<Result> &baseline, const std::vector<Result> &contender,
+                                const CompareOptions &options = CompareOptions());
+
+/**
+ * @return true if any comparison is SLOWER
+ */
+bool hasRegression(const std::vector<Comparison> &comparisons);
+
+/**
+ * Read all results of a file written with the binary output format (writeSamples() streams one after the other).
+ * @throws std::runtime_error if the file cannot be opened or is corrupt
+ */
+std::vector<Result> loadBaseline(const std::string &path);
+
+}  // namespace benchmark
+}  // namespace timed
+
+#endif  // TIMED_COMPARE_H_
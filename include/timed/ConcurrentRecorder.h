@@ -0,0 +1,171 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_CONCURRENTRECORDER_H_
+#define TIMED_CONCURRENTRECORDER_H_
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "timed/Benchmark.h"
+#include "timed/TimeUtils.h"
+
+namespace timed {
+
+namespace detail {
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * Wall and (optional) CPU time of a single sample. A negative cpu tick count marks a sample without CPU time.
+ */
+struct Sample {
+  Time wall;
+  Time cpu;
+};
+
+/**
+ * Fixed size block of samples. Filled by exactly one thread, count is published with release semantics.
+ */
+struct alignas(CACHE_LINE_SIZE) SampleBlock {
+  static constexpr std::size_t CAPACITY = 4096;
+
+  std::atomic<std::size_t> count{0};
+  std::atomic<SampleBlock *> next{nullptr};
+  Sample samples[CAPACITY];
+};
+
+/**
+ * Single producer (the recording thread), single consumer (the collector) queue of sample blocks.
+ * Producer and consumer state live on separate cache lines.
+ */
+class SampleBuffer {
+ public:
+  SampleBuffer();
+
+  ~SampleBuffer();
+
+  SampleBuffer(const SampleBuffer &) = delete;
+  SampleBuffer &operator=(const SampleBuffer &) = delete;
+
+  /**
+   * Append a sample. Must only be called by the owning thread.
+   */
+  void push(Sample sample) {
+    if (_tailCount == SampleBlock::CAPACITY) { grow(); }
+    _tail->samples[_tailCount] = sample;
+    _tail->count.store(++_tailCount, std::memory_order_release);
+  }
+
+  /**
+   * Move all published samples into result and release fully consumed blocks. Must only be called by one collector at
+   * a time.
+   * @return number of moved samples
+   */
+  size_t drain(benchmark::Result &result);
+
+ private:
+  void grow();
+
+  // producer
+  alignas(CACHE_LINE_SIZE) SampleBlock *_tail;
+  std::size_t _tailCount = 0;
+  // consumer
+  alignas(CACHE_LINE_SIZE) SampleBlock *_head;
+  std::size_t _headIndex = 0;
+};
+
+struct ThreadBufferCache {
+  uint64_t recorderId = 0;
+  SampleBuffer *buffer = nullptr;
+};
+
+}  // namespace detail
+
+/**
+ * ConcurrentRecorder: collects samples from many threads without locking on the record path.
+ * Every thread appends into its own cache line aligned buffer; collect() merges everything recorded so far into a
+ * benchmark::Result while the recording threads keep running.
+ * The recorder must outlive all recording threads' calls to record(). All threads must use the same record() overload
+ * (wall times only, or wall and CPU times), so that the i-th CPU time of a collected result belongs to the i-th wall
+ * time.
+ */
+class ConcurrentRecorder {
+ public:
+  ConcurrentRecorder();
+
+  ~ConcurrentRecorder();
+
+  ConcurrentRecorder(const ConcurrentRecorder &) = delete;
+  ConcurrentRecorder &operator=(const ConcurrentRecorder &) = delete;
+
+  /**
+   * Record a wall time sample from the calling thread.
+   * @throws std::runtime_error if record(Time, Time) was used before
+   */
+  void record(Time wallTime) {
+    checkMode(Mode::WALL);
+    buffer().push({wallTime, Time::fromNanoseconds(-1)});
+  }
+
+  /**
+   * Record a wall time and CPU time sample from the calling thread.
+   * @throws std::runtime_error if record(Time) was used before
+   */
+  void record(Time wallTime, Time cpuTime) {
+    checkMode(Mode::WALL_AND_CPU);
+    buffer().push({wallTime, cpuTime});
+  }
+
+  /**
+   * Move all samples recorded since the last collect() into result (wallTimes and cpuTimes).
+   * @return number of collected samples
+   */
+  size_t collect(benchmark::Result &result);
+
+  /**
+   * @return number of threads that have recorded into this recorder
+   */
+  [[nodiscard]] size_t threadCount() const;
+
+ private:
+  enum Mode : int { UNSET = 0, WALL = 1, WALL_AND_CPU = 2 };
+
+  void checkMode(Mode mode) {
+    if (_mode.load(std::memory_order_relaxed) != mode) { setMode(mode); }
+  }
+
+  // the first record() fixes the mode, throws if it was fixed to another one
+  void setMode(Mode mode);
+
+  detail::SampleBuffer &buffer() {
+    if (_cache.recorderId == _id) { return *_cache.buffer; }
+    return registerThread();
+  }
+
+  detail::SampleBuffer &registerThread();
+
+  const uint64_t _id;
+  std::atomic<int> _mode{UNSET};
+  mutable std::mutex _mutex;
+  std::vector<std::unique_ptr<detail::SampleBuffer>> _buffers;
+  // buffer of every thread that recorded, owned by _buffers. A thread id reused by a new thread inherits the buffer of
+  // the exited thread, which is safe: there is still one producer per buffer.
+  std::unordered_map<std::thread::id, detail::SampleBuffer *> _threadBuffers;
+
+  static thread_local detail::ThreadBufferCache _cache;
+};
+
+}  // namespace timed
+
+#endif  // TIMED_CONCURRENTRECORDER_H_
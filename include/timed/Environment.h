@@ -0,0 +1,50 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_ENVIRONMENT_H_
+#define TIMED_ENVIRONMENT_H_
+
+#pragma once
+
+#include <array>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace timed {
+
+/**
+ * Machine a benchmark ran on. Unknown values are empty (strings), 0 (cores) or -1 (turbo, load averages).
+ */
+struct MachineContext {
+  std::string cpuModel;
+  unsigned cores = 0;
+  // cpufreq scaling governor of cpu0, e.g. "performance" or "powersave"
+  std::string governor;
+  // 1 if turbo/boost is enabled, 0 if disabled
+  int turbo = -1;
+  // operating system and kernel release, e.g. "Linux 6.8.0"
+  std::string kernel;
+  // 1, 5 and 15 minute load averages
+  std::array<double, 3> loadAverage = {-1, -1, -1};
+};
+
+std::ostream &operator<<(std::ostream &os, const MachineContext &context);
+
+/**
+ * Read the machine context. CPU model, cores and kernel are read once per process, governor, turbo and load averages
+ * on every call.
+ */
+MachineContext machineContext();
+
+/**
+ * @return warnings about settings that make timings noisy: a governor other than "performance", enabled turbo, a load
+ *         average above the number of cores
+ */
+std::vector<std::string> environmentWarnings(const MachineContext &context);
+
+}  // namespace timed
+
+#endif  // TIMED_ENVIRONMENT_H_
@@ -0,0 +1,183 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_EXPORT_H_
+#define TIMED_EXPORT_H_
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "timed/Benchmark.h"
+#include "timed/TimeUtils.h"
+#include "timed/utils/Complexity.h"
+
+namespace timed {
+namespace benchmark {
+
+// ===== JSON ==========================================================================================================
+// Every writer emits a single JSON object on one line, times are integer nanoseconds (baseline adjusted).
+
+/**
+ * Metadata, throughput and summary statistics (min, max, mean, stddev, median, p90, p99, p99.9) of every recorded
+ * time column.
+ */
+void writeJson(std::ostream &os, const Result &result);
+
+void writeJson(std::ostream &os, const ScalingResult &result);
+
+void writeJson(std::ostream &os, const std::string &name, const utils::ComplexityFit &fit);
+
+/**
+ * @return s as JSON string literal (including the quotes)
+ */
+std::string jsonString(const std::string &s);
+
+
+// ===== CSV ===========================================================================================================
+/**
+ * Header matching writeCsv(): benchmark,sample,wall_ns,cpu_ns,thread_cpu_ns
+ */
+void writeCsvHeader(std::ostream &os);
+
+/**
+ * One row per raw (not baseline adjusted) sample, missing columns are left empty. Histogram-only results have no raw
+ * samples and write no rows.
+ */
+void writeCsv(std::ostream &os, const Result &result);
+
+
+// ===== binary samples ================================================================================================
+/**
+ * SampleWriter: compact, streamable encoding of sample columns (e.g. wall and CPU times).
+ *
+ * Layout (varint: unsigned LEB128, zigzag: signed value as zigzag encoded varint):
+ *   header: "TIMEDSMP", varint version (1), varint title length, title, varint batch size, varint column count,
+ *           per column: varint name length, name, zigzag baseline (ns)
+ *   blocks: varint row count (0 terminates the stream), varint payload size in bytes,
+ *           payload: per column, row count zigzag deltas (ns) to the previous value of the column in this block (the
+ *           first value is stored as delta to 0)
+ * Rows are buffered until a block is full, so writing and reading need memory for one block only. Blocks are
+ * independent, a reader may skip them by their payload size.
+ */
+class SampleWriter {
+ public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 16;
+  // larger block sizes are clamped, SampleReader rejects blocks with more rows as corrupt
+  static constexpr size_t MAX_BLOCK_SIZE = 1 << 20;
+
+  /**
+   * Writes the header.
+   * @throws std::runtime_error if columns and baselines differ in size or there are no columns
+   */
+  SampleWriter(std::ostream &os, const std::string &title, const std::vector<std::string> &columns,
+               const std::vector<Time> &baselines, uint64_t batchSize = 1, size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+  /**
+   * Calls finish() (errors are ignored, call finish() explicitly to see them).
+   */
+  ~SampleWriter();
+
+  SampleWriter(const SampleWriter &) = delete;
+
+  SampleWriter &operator=(const SampleWriter &) = delete;
+
+  /**
+   * @param row: one value per column
+   */
+  void add(const Time *row);
+
+  void add(const std::vector<Time> &row);
+
+  /**
+   * Write the buffered rows and the terminating block. No rows may be added afterwards.
+   */
+  void finish();
+
+ private:
+  void _flush();
+
+  std::ostream &_os;
+  size_t _blockSize;
+  std::vector<std::vector<Time>> _columns;
+  std::string _buffer;
+  bool _finished = false;
+};
+
+/**
+ * SampleReader: reads one stream written by SampleWriter block by block.
+ */
+class SampleReader {
+ public:
+  /**
+   * Reads the header.
+   * @throws std::runtime_error if is does not start with a valid header
+   */
+  explicit SampleReader(std::istream &is);
+
+  [[nodiscard]] const std::string &title() const;
+
+  [[nodiscard]] uint64_t batchSize() const;
+
+  [[nodiscard]] const std::vector<std::string> &columns() const;
+
+  [[nodiscard]] const std::vector<Time> &baselines() const;
+
+  /**
+   * @param row: set to the values of the next row (one per column)
+   * @return false after the last row
+   * @throws std::runtime_error if the stream is truncated or corrupt
+   */
+  bool next(std::vector<Time> &row);
+
+ private:
+  bool _readBlock();
+
+  std::istream &_is;
+  std::string _title;
+  uint64_t _batchSize = 1;
+  std::vector<std::string> _columnNames;
+  std::vector<Time> _baselines;
+  std::vector<std::vector<Time>> _block;
+  size_t _rows = 0;
+  size_t _position = 0;
+  bool _end = false;
+  std::string _buffer;
+};
+
+/**
+ * Write the raw samples of result: columns "wall", "cpu" and, if recorded, "thread_cpu".
+ * @throws std::runtime_error for histogram-only results
+ */
+void writeSamples(std::ostream &os, const Result &result);
+
+/**
+ * Read a stream written by writeSamples() into a Result (samples, baselines, title and batch size). Further streams may
+ * follow in is.
+ */
+Result readSamples(std::istream &is);
+
+/**
+ * Write result completely: a "TIMEDRES" header (magic, varint version), the metadata that writeSamples() does not keep
+ * (info, throughput, warmup samples, counters, allocations, machine context, warnings) and the writeSamples() stream.
+ * Used to pass results between processes (runIsolated()).
+ * @throws std::runtime_error for histogram-only results
+ */
+void writeResult(std::ostream &os, const Result &result);
+
+/**
+ * Read a result written by writeResult(). Further streams may follow in is.
+ * @throws std::runtime_error if the stream is truncated or corrupt
+ */
+Result readResult(std::istream &is);
+
+}  // namespace benchmark
+}  // namespace timed
+
+#endif  // TIMED_EXPORT_H_
@@ -0,0 +1,84 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_INTERLEAVED_H_
+#define TIMED_INTERLEAVED_H_
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "timed/Benchmark.h"
+#include "timed/Compare.h"
+
+namespace timed {
+namespace benchmark {
+
+struct InterleavedResult {
+  // one result per op in the order the ops were added, sample i of every result was taken in round i
+  std::vector<Result> results;
+  // every other op compared with the first one (comparePaired())
+  std::vector<Comparison> comparisons;
+};
+
+/**
+ * Prints every result followed by the speed of every op relative to the first one.
+ */
+std::ostream &operator<<(std::ostream &os, const InterleavedResult &result);
+
+/**
+ * InterleavedBenchmark: runs several ops in rounds, every round samples each op once in a new random order. Frequency,
+ * temperature and load drift during the run affect all ops alike instead of biasing the one that happened to run last,
+ * and the samples of a round can be compared pairwise (comparePaired()).
+ *
+ * Used Config settings: iterations (number of rounds), warmupIterations and warmupTime (discarded rounds), wallClock,
+ * threadCpuTime, info, bytesPerIteration, itemsPerIteration and the noise control settings (pinCpu, realtimePriority,
+ * lockMemory), which apply to the whole run. With autoIterations, every op is called in batches that take at least
+ * minSampleTime (batch sizes are calibrated per op within maxTime), samples and baselines are per op call.
+ * The order of the rounds and the bootstrap intervals are deterministic for CompareOptions::seed.
+ */
+class InterleavedBenchmark {
+ public:
+  explicit InterleavedBenchmark(Config config = Config(), CompareOptions options = CompareOptions());
+
+  /**
+   * @param precedentOp: run before every sample of op (not measured), see BasicBenchmark
+   */
+  InterleavedBenchmark &add(std::string title, std::function<void()> op, std::function<void()> precedentOp = NoOp());
+
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @throws std::runtime_error if no op was added
+   */
+  const InterleavedResult &run(bool verbose = false);
+
+  [[nodiscard]] const InterleavedResult &getResult() const;
+
+  [[nodiscard]] const Config &getConfig() const;
+
+ private:
+  struct Entry {
+    std::string title;
+    std::function<void()> op;
+    std::function<void()> precedentOp;
+  };
+
+  template<typename WallTimerT>
+  void runWith(bool verbose);
+
+  std::vector<Entry> _entries;
+  Config _config;
+  CompareOptions _options;
+  InterleavedResult _result;
+};
+
+}  // namespace benchmark
+}  // namespace timed
+
+#endif  // TIMED_INTERLEAVED_H_
@@ -0,0 +1,172 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_INTERVALSTORAGE_H_
+#define TIMED_INTERVALSTORAGE_H_
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace timed {
+
+/**
+ * Storage policies for Timer<Interval, Storage>.
+ * Every policy keeps a running total of all closed intervals, so the elapsed time is available in O(1) regardless of
+ * how much interval history is kept. They differ in what history is kept:
+ *  - AccumulatorStorage: only the current interval, never allocates
+ *  - RingBufferStorage: the last Capacity intervals in an inline buffer, never allocates
+ *  - VectorStorage: all intervals in a std::vector (may allocate on open())
+ *
+ * Interface:
+ *  - clear(): remove all intervals and reset the total
+ *  - open(now): begin a new interval at now
+ *  - close(now): end the current interval at now, returns its duration
+ *  - back(): the current (last opened) interval
+ *  - total(): summed duration of all closed intervals
+ *  - intervals(): kept interval history, oldest first
+ */
+
+/**
+ * AccumulatorStorage: keeps the running total and the current interval only.
+ * @tparam Interval: pair of time points
+ */
+template<typename Interval>
+class AccumulatorStorage {
+ public:
+  using TimePoint = typename Interval::first_type;
+  using Duration = decltype(std::declval<TimePoint>() - std::declval<TimePoint>());
+
+  void clear() {
+    _total = Duration{};
+    _hasInterval = false;
+  }
+
+  void open(TimePoint now) {
+    _current.first = now;
+    _current.second = now;
+    _hasInterval = true;
+  }
+
+  Duration close(TimePoint now) {
+    _current.second = now;
+    Duration d = _current.second - _current.first;
+    _total += d;
+    return d;
+  }
+
+  [[nodiscard]] const Interval &back() const { return _current; }
+
+  [[nodiscard]] Duration total() const { return _total; }
+
+  [[nodiscard]] std::vector<Interval> intervals() const {
+    if (!_hasInterval) { return {}; }
+    return {_current};
+  }
+
+ private:
+  Interval _current{};
+  Duration _total{};
+  bool _hasInterval = false;
+};
+
+/**
+ * RingBufferStorage: keeps the last Capacity intervals in an inline buffer. Older intervals are overwritten but are
+ * still part of total().
+ * @tparam Interval: pair of time points
+ * @tparam Capacity: number of intervals kept
+ */
+template<typename Interval, std::size_t Capacity = 16>
+class RingBufferStorage {
+  static_assert(Capacity > 0, "RingBufferStorage requires a capacity of at least one interval");
+
+ public:
+  using TimePoint = typename Interval::first_type;
+  using Duration = decltype(std::declval<TimePoint>() - std::declval<TimePoint>());
+
+  void clear() {
+    _total = Duration{};
+    _size = 0;
+    _last = Capacity - 1;
+  }
+
+  void open(TimePoint now) {
+    _last = (_last + 1) % Capacity;
+    _buffer[_last].first = now;
+    _buffer[_last].second = now;
+    if (_size < Capacity) { ++_size; }
+  }
+
+  Duration close(TimePoint now) {
+    _buffer[_last].second = now;
+    Duration d = _buffer[_last].second - _buffer[_last].first;
+    _total += d;
+    return d;
+  }
+
+  [[nodiscard]] const Interval &back() const { return _buffer[_last]; }
+
+  [[nodiscard]] Duration total() const { return _total; }
+
+  [[nodiscard]] std::vector<Interval> intervals() const {
+    std::vector<Interval> ret;
+    ret.reserve(_size);
+    std::size_t first = (_last + Capacity + 1 - _size) % Capacity;
+    for (std::size_t i = 0; i < _size; ++i) {
+      ret.push_back(_buffer[(first + i) % Capacity]);
+    }
+    return ret;
+  }
+
+ private:
+  std::array<Interval, Capacity> _buffer{};
+  Duration _total{};
+  std::size_t _size = 0;
+  std::size_t _last = Capacity - 1;
+};
+
+/**
+ * VectorStorage: keeps every interval in a std::vector.
+ * @tparam Interval: pair of time points
+ */
+template<typename Interval>
+class VectorStorage {
+ public:
+  using TimePoint = typename Interval::first_type;
+  using Duration = decltype(std::declval<TimePoint>() - std::declval<TimePoint>());
+
+  void clear() {
+    _total = Duration{};
+    _intervals.clear();
+  }
+
+  void open(TimePoint now) {
+    _intervals.emplace_back(now, now);
+  }
+
+  Duration close(TimePoint now) {
+    _intervals.back().second = now;
+    Duration d = _intervals.back().second - _intervals.back().first;
+    _total += d;
+    return d;
+  }
+
+  [[nodiscard]] const Interval &back() const { return _intervals.back(); }
+
+  [[nodiscard]] Duration total() const { return _total; }
+
+  [[nodiscard]] std::vector<Interval> intervals() const { return _intervals; }
+
+ private:
+  std::vector<Interval> _intervals;
+  Duration _total{};
+};
+
+}  // namespace timed
+
+#endif  // TIMED_INTERVALSTORAGE_H_
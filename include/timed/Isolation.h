@@ -0,0 +1,42 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_ISOLATION_H_
+#define TIMED_ISOLATION_H_
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "timed/Benchmark.h"
+#include "timed/TimeUtils.h"
+
+namespace timed {
+namespace benchmark {
+
+struct IsolatedRun {
+  std::vector<Result> results;
+  // empty if the child process returned its results, else why it failed (exception, signal, exit status, timeout)
+  std::string error;
+
+  [[nodiscard]] bool ok() const { return error.empty(); }
+};
+
+/**
+ * Call run in a forked child process and return its results: the child starts with a copy of the parent's memory but
+ * cannot leave heap fragmentation, warm caches or threads behind for later benchmarks. The results are streamed back
+ * over a pipe (writeResult()), so they must have raw samples (no histogram-only results).
+ * A crash, an exception, an exit without results or a timeout of the child is reported in IsolatedRun::error, a child
+ * that exceeds timeout (zero: no limit) is killed. POSIX only, elsewhere error is always set.
+ * stdout and stderr are flushed before forking so that buffered output is not written twice.
+ */
+IsolatedRun runIsolated(const std::function<std::vector<Result>()> &run, Time timeout = Time());
+
+}  // namespace benchmark
+}  // namespace timed
+
+#endif  // TIMED_ISOLATION_H_
@@ -0,0 +1,90 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_PERFCOUNTERS_H_
+#define TIMED_PERFCOUNTERS_H_
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace timed {
+
+/**
+ * Hardware events counted by PerfCounterTimer (user space only).
+ */
+enum class PerfEvent { CYCLES, INSTRUCTIONS, CACHE_REFERENCES, CACHE_MISSES, BRANCHES, BRANCH_MISSES };
+
+const char *toString(PerfEvent event);
+
+/**
+ * @return CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES
+ */
+std::vector<PerfEvent> defaultPerfEvents();
+
+/**
+ * PerfCounterTimer: counts hardware events from start() to stop() using one Linux perf_event_open() counter group.
+ * The counters run from construction on, start() and stop() each read all counters of the group with a single read().
+ * Counts are summed over all start()/stop() pairs and scaled by time enabled / time running if the kernel multiplexed
+ * the group. Only events of the constructing thread are counted.
+ *
+ * If the counters cannot be opened (no Linux, perf_event_paranoid too high, no PMU in a virtual machine, seccomp), the
+ * timer is not available(): start() and stop() do nothing and error() tells why. Events the CPU does not support are
+ * left out, events() only lists the counted ones.
+ */
+class PerfCounterTimer {
+ public:
+  explicit PerfCounterTimer(const std::vector<PerfEvent> &events = defaultPerfEvents());
+
+  PerfCounterTimer(const PerfCounterTimer &) = delete;
+
+  PerfCounterTimer &operator=(const PerfCounterTimer &) = delete;
+
+  ~PerfCounterTimer();
+
+  [[nodiscard]] bool available() const;
+
+  [[nodiscard]] const std::string &error() const;
+
+  void start();
+
+  void stop();
+
+  void reset();
+
+  /**
+   * @return counted events, in the order of getCounts()
+   */
+  [[nodiscard]] const std::vector<PerfEvent> &events() const;
+
+  /**
+   * @return counts summed over all start()/stop() pairs since construction or reset()
+   */
+  [[nodiscard]] const std::vector<double> &getCounts() const;
+
+  /**
+   * @return count of event, 0 if it is not counted
+   */
+  [[nodiscard]] double getCount(PerfEvent event) const;
+
+ private:
+  // one read() of the group: time enabled, time running and one value per event
+  bool _read(std::vector<uint64_t> &values);
+
+  std::vector<PerfEvent> _events;
+  std::vector<int> _fds;
+  std::string _error;
+  std::vector<uint64_t> _buffer;
+  std::vector<uint64_t> _startValues;
+  std::vector<uint64_t> _stopValues;
+  std::vector<double> _counts;
+  bool _started = false;
+};
+
+}  // namespace timed
+
+#endif  // TIMED_PERFCOUNTERS_H_
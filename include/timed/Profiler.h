@@ -0,0 +1,176 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_PROFILER_H_
+#define TIMED_PROFILER_H_
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "timed/Timer.h"
+#include "timed/TimeUtils.h"
+
+// ----- zone macros ---------------------------------------------------------------------------------------------------
+#define TIMED_CONCAT_IMPL(a, b) a##b
+#define TIMED_CONCAT(a, b) TIMED_CONCAT_IMPL(a, b)
+
+/**
+ * TIMED_ZONE("name"): time the rest of the enclosing scope as zone "name" of the calling thread's call tree.
+ * The zone site is a constexpr static, so the name is interned at compile time and identified by address.
+ * Define TIMED_DISABLE_PROFILER to compile all zones out.
+ */
+#ifdef TIMED_DISABLE_PROFILER
+#define TIMED_ZONE(name) do {} while (false)
+#else
+#define TIMED_ZONE(name)                                                                                               \
+  static constexpr ::timed::profiler::ZoneSite TIMED_CONCAT(_timedZoneSite, __LINE__){name, __FILE__, __LINE__};     \
+  ::timed::profiler::ScopedTimer TIMED_CONCAT(_timedZone, __LINE__)(TIMED_CONCAT(_timedZoneSite, __LINE__))
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace timed {
+namespace profiler {
+
+/**
+ * Source location of a TIMED_ZONE.
+ */
+struct ZoneSite {
+  const char *name;
+  const char *file;
+  unsigned line;
+};
+
+/**
+ * Merged statistics of one zone path.
+ */
+struct ZoneStats {
+  std::string name;
+  // zone names from the root to this zone, separated by '/'
+  std::string path;
+  uint64_t calls = 0;
+  Time inclusive;
+  Time exclusive;
+  Time min;
+  Time max;
+  std::vector<ZoneStats> children;
+
+  [[nodiscard]] Time mean() const;
+};
+
+std::ostream &operator<<(std::ostream &os, const ZoneStats &stats);
+
+namespace detail {
+
+/**
+ * Node of a per-thread call tree. Written by the owning thread only; statistics are relaxed atomics and new children
+ * are published with release semantics so that Profiler::merged() can read the tree while the thread keeps running.
+ */
+struct Node {
+  Node(const ZoneSite *s, Node *p) : site(s), parent(p) {}
+
+  const ZoneSite *site;
+  Node *parent;
+  std::atomic<Node *> firstChild{nullptr};
+  std::atomic<Node *> nextSibling{nullptr};
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> inclusiveNs{0};
+  std::atomic<uint64_t> childNs{0};
+  std::atomic<uint64_t> minNs{UINT64_MAX};
+  std::atomic<uint64_t> maxNs{0};
+};
+
+/**
+ * ThreadTree: call tree of a single thread.
+ */
+class ThreadTree {
+ public:
+  ThreadTree();
+
+  /**
+   * Enter zone site as child of the current zone.
+   */
+  void enter(const ZoneSite *site);
+
+  /**
+   * Leave the current zone after ns nanoseconds.
+   */
+  void exit(uint64_t ns);
+
+  [[nodiscard]] const Node &root() const;
+
+ private:
+  Node _root;
+  Node *_current;
+  // nodes are only released together with the tree
+  std::vector<std::unique_ptr<Node>> _nodes;
+};
+
+/**
+ * @return call tree of the calling thread, registered with Profiler::instance() on first use.
+ */
+ThreadTree &threadTree();
+
+}  // namespace detail
+
+/**
+ * ScopedTimer: RAII wall timer that records the lifetime of the object as zone site in the calling thread's call tree.
+ * Usually created through TIMED_ZONE.
+ */
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(const ZoneSite &site);
+
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+ private:
+  detail::ThreadTree &_tree;
+  BasicWallTimer<AccumulatorStorage<SteadyClockInterval>> _timer;
+};
+
+/**
+ * Profiler: process-wide registry of the per-thread call trees.
+ * Trees of finished threads are kept, so merged() covers every thread that ever entered a zone.
+ */
+class Profiler {
+ public:
+  static Profiler &instance();
+
+  /**
+   * Merge the call trees of all threads by zone path. Can be called while threads are recording.
+   * @return root (unnamed, no statistics) whose children are the top level zones
+   */
+  [[nodiscard]] ZoneStats merged() const;
+
+  /**
+   * @return number of threads that have recorded zones
+   */
+  [[nodiscard]] size_t threadCount() const;
+
+ private:
+  Profiler() = default;
+
+  std::shared_ptr<detail::ThreadTree> registerThread();
+
+  mutable std::mutex _mutex;
+  std::vector<std::shared_ptr<detail::ThreadTree>> _trees;
+
+  friend detail::ThreadTree &detail::threadTree();
+};
+
+}  // namespace profiler
+}  // namespace timed
+
+#endif  // TIMED_PROFILER_H_
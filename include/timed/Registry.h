@@ -0,0 +1,277 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_REGISTRY_H_
+#define TIMED_REGISTRY_H_
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "timed/Benchmark.h"
+#include "timed/Compare.h"
+#include "timed/Reporter.h"
+#include "timed/TimeUtils.h"
+
+#define TIMED_CONCAT_IMPL(a, b) a##b
+#define TIMED_CONCAT(a, b) TIMED_CONCAT_IMPL(a, b)
+
+/**
+ * Register the function `void func()` or `void func(const timed::benchmark::Arguments &)` as benchmark named func in
+ * the global registry. The registration can be configured by chaining:
+ *   TIMED_BENCHMARK(copyVector).iterations(1000).bytesPerIteration(4096);
+ *   TIMED_BENCHMARK(sortVector).argGeometricRange(1 << 10, 1 << 20, 4).complexity();
+ */
+#define TIMED_BENCHMARK(func)                                                                     \
+  [[maybe_unused]] static ::timed::benchmark::Registration &TIMED_CONCAT(timedRegistration_, __LINE__) = \
+    ::timed::benchmark::Registry::instance().add(#func, func)
+
+namespace timed {
+namespace benchmark {
+
+/**
+ * Parameters of one instance of a parameterized benchmark.
+ */
+using Arguments = std::vector<int64_t>;
+
+/**
+ * @return start, start + step, ... up to limit (included if reached)
+ * @throws std::runtime_error if step is not positive
+ */
+std::vector<int64_t> linearRange(int64_t start, int64_t limit, int64_t step = 1);
+
+/**
+ * @return start, start * multiplier, ... below limit, and limit
+ * @throws std::runtime_error if start is not positive, start > limit or multiplier < 2
+ */
+std::vector<int64_t> geometricRange(int64_t start, int64_t limit, int64_t multiplier = 2);
+
+/**
+ * One runnable benchmark: a registration without parameters or one argument set of a parameterized registration.
+ */
+struct Instance {
+  // registration name, followed by "/<argument>" for every argument
+  std::string name;
+  Arguments arguments;
+  Config config;
+  std::function<void()> op;
+  std::function<void()> precedentOp;
+};
+
+/**
+ * A named benchmark of a Registry: op, precedent op and the Config it is run with (title is the name).
+ * Parameterized registrations (op taking Arguments) are run once per argument set added by arg(), args(),
+ * argRange(), argGeometricRange() and argsProduct(), in the order they were added.
+ */
+class Registration {
+ public:
+  Registration(std::string name, std::function<void()> op);
+
+  Registration(std::string name, std::function<void(const Arguments &)> op);
+
+  /**
+   * Operation run before every sample (not measured), see BasicBenchmark.
+   */
+  Registration &setup(std::function<void()> precedentOp);
+
+  Registration &setup(std::function<void(const Arguments &)> precedentOp);
+
+  /**
+   * Add the single parameter argument set {argument}.
+   */
+  Registration &arg(int64_t argument);
+
+  Registration &args(Arguments arguments);
+
+  /**
+   * Add a single parameter argument set for every value of linearRange(start, limit, step).
+   */
+  Registration &argRange(int64_t start, int64_t limit, int64_t step = 1);
+
+  /**
+   * Add a single parameter argument set for every value of geometricRange(start, limit, multiplier).
+   */
+  Registration &argGeometricRange(int64_t start, int64_t limit, int64_t multiplier = 2);
+
+  /**
+   * Add the cartesian product of the values of every parameter (the last parameter varies fastest), e.g.
+   * argsProduct({geometricRange(1, 1024, 32), {1, 2}}) adds {1, 1}, {1, 2}, {32, 1}, {32, 2}, {1024, 1}, {1024, 2}.
+   */
+  Registration &argsProduct(const std::vector<std::vector<int64_t>> &values);
+
+  /**
+   * Fit the mean wall time against O(1), ..., O(n^2) with n the argument at index argument. Instances that share all
+   * other arguments are fitted together.
+   */
+  Registration &complexity(size_t argument = 0);
+
+  Registration &iterations(unsigned iterations);
+
+  Registration &bytesPerIteration(uint64_t bytes);
+
+  Registration &itemsPerIteration(uint64_t items);
+
+  /**
+   * Fail the run if op allocates more than allocations times per call (see Config::maxAllocationsPerOp).
+   */
+  Registration &maxAllocationsPerOp(double allocations);
+
+  /**
+   * Modify any other field of the Config.
+   */
+  Registration &configure(const std::function<void(Config &)> &configure);
+
+  /**
+   * Modify the Config per argument set (e.g. bytesPerIteration depending on the input size), applied after
+   * configure().
+   */
+  Registration &configure(const std::function<void(Config &, const Arguments &)> &configure);
+
+  [[nodiscard]] const std::string &name() const;
+
+  [[nodiscard]] const Config &config() const;
+
+  [[nodiscard]] bool parameterized() const;
+
+  [[nodiscard]] const std::vector<Arguments> &arguments() const;
+
+  /**
+   * @return index of the argument the complexity is fitted against, or -1 if complexity() was not called
+   */
+  [[nodiscard]] int complexityArgument() const;
+
+  /**
+   * @return one instance per argument set (a single instance if not parameterized)
+   * @throws std::runtime_error if parameterized and no argument set was added
+   */
+  [[nodiscard]] std::vector<Instance> instances() const;
+
+ private:
+  std::string _name;
+  std::function<void()> _op;
+  std::function<void()> _precedentOp;
+  std::function<void(const Arguments &)> _parameterizedOp;
+  std::function<void(const Arguments &)> _parameterizedPrecedentOp;
+  std::vector<Arguments> _arguments;
+  std::vector<std::function<void(Config &, const Arguments &)>> _argumentConfigurators;
+  int _complexityArgument = -1;
+  Config _config;
+};
+
+/**
+ * Registry: ordered collection of registrations with unique names. TIMED_BENCHMARK adds to the global instance().
+ */
+class Registry {
+ public:
+  static Registry &instance();
+
+  /**
+   * @return the new registration (references stay valid as long as the registry lives)
+   * @throws std::runtime_error if name is already registered
+   */
+  Registration &add(std::string name, std::function<void()> op);
+
+  Registration &add(std::string name, std::function<void(const Arguments &)> op);
+
+  /**
+   * @param filter: ECMAScript regular expression, searched in the names
+   * @return matching registrations in registration order
+   */
+  [[nodiscard]] std::vector<const Registration *> matching(const std::string &filter) const;
+
+  [[nodiscard]] const std::deque<Registration> &registrations() const;
+
+  [[nodiscard]] size_t size() const;
+
+  void clear();
+
+ private:
+  // deque: adding does not invalidate references to earlier registrations
+  std::deque<Registration> _registrations;
+};
+
+
+/**
+ * Process isolation of a suite run (see runIsolated()):
+ *  - NONE: all benchmarks run in the suite process
+ *  - BENCHMARK: every instance runs all its repetitions in a fresh child process
+ *  - REPETITION: every repetition runs in a fresh child process
+ * Scaling mode runs are not isolated.
+ */
+enum class Isolation { NONE, BENCHMARK, REPETITION };
+
+/**
+ * Options of a suite run, usually parsed from the command line (see parseArguments()).
+ */
+struct RunOptions {
+  // ECMAScript regular expression, instances whose name does not contain a match are skipped
+  std::string filter = ".*";
+  unsigned repetitions = 1;
+  // if non zero, benchmarks run in adaptive mode (Config::autoIterations) and sample for at least minTime
+  Time minTime;
+  // if not empty, benchmarks run in scaling mode with these thread counts
+  std::vector<unsigned> threadCounts;
+  std::string format = "console";
+  // count hardware events (Config::perfCounters)
+  bool perfCounters = false;
+  // noise control (Config::pinCpu, Config::realtimePriority, Config::lockMemory)
+  int pinCpu = -1;
+  int realtimePriority = 0;
+  bool lockMemory = false;
+  Isolation isolation = Isolation::NONE;
+  // isolated child processes that run longer are killed (zero: no limit, ignored without isolation)
+  Time timeout;
+  // if not empty, results are compared with the results of this file (written with the binary format)
+  std::string baseline;
+  CompareOptions compare;
+  // only print the names of the matching benchmarks
+  bool list = false;
+  bool help = false;
+};
+
+/**
+ * Parse --filter=REGEX, --repetitions=N, --min-time=TIME (e.g. 500ms, 2s, plain numbers are seconds),
+ * --threads=N[,N...], --format=FORMAT, --baseline=FILE, --threshold=X, --alpha=X, --perf-counters, --pin-cpu=N,
+ * --realtime-priority=N, --lock-memory, --isolate[=benchmark|repetition|none], --timeout=TIME, --list and --help.
+ * argv[0] is skipped.
+ * @throws std::runtime_error for unknown options, invalid values, --baseline together with --threads and --timeout
+ *         without --isolate
+ */
+RunOptions parseArguments(int argc, const char *const *argv);
+
+/**
+ * @return usage message for the options of parseArguments()
+ */
+std::string usage(const std::string &program);
+
+/**
+ * Run (or list) all instances of registry that match options.filter and write the results to os. Complexity is fitted
+ * (except in scaling mode) if at least two different input sizes of a group ran.
+ * With options.baseline, every result is compared with the baseline result of the same title afterwards. The
+ * comparisons are written to os for the console format and to stderr otherwise.
+ * Results that allocate more than Config::maxAllocationsPerOp (or whose limit cannot be checked because the
+ * AllocationTracker library is not linked) are reported on stderr, as are isolated runs that failed
+ * (crash, exception, timeout); the suite continues with the next benchmark.
+ * @return 0 on success, 1 if no benchmark matches, 2 if a result is significantly slower than its baseline, else 4 if
+ *         an isolated run failed, else 3 if a result exceeded (or could not check) its allocation limit
+ * @throws std::runtime_error for an unknown format or an unreadable baseline, and if options.isolation is set and a
+ *         selected benchmark keeps histograms only (Config::histogram, Config::sink), before anything runs
+ */
+int runRegistered(const RunOptions &options, std::ostream &os, const Registry &registry = Registry::instance());
+
+/**
+ * main() of the timed_main library: parse the arguments and run the global registry, errors are written to stderr.
+ * @return exit code
+ */
+int runMain(int argc, const char *const *argv);
+
+}  // namespace benchmark
+}  // namespace timed
+
+#endif  // TIMED_REGISTRY_H_
@@ -0,0 +1,131 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_REPORTER_H_
+#define TIMED_REPORTER_H_
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "timed/Benchmark.h"
+#include "timed/utils/Complexity.h"
+
+namespace timed {
+namespace benchmark {
+
+/**
+ * Reporter: writes the results of a suite run in one output format.
+ */
+class Reporter {
+ public:
+  virtual ~Reporter() = default;
+
+  virtual void begin() {}
+
+  virtual void report(const Result &result) = 0;
+
+  virtual void report(const std::string &name, const std::vector<ScalingResult> &results) = 0;
+
+  /**
+   * @param name: registration name, the fitted argument replaced by "n"
+   */
+  virtual void report(const std::string &name, const utils::ComplexityFit &fit) = 0;
+
+  virtual void end() {}
+};
+
+/**
+ * Human readable output: operator<< of Result and ScalingResult.
+ */
+class ConsoleReporter : public Reporter {
+ public:
+  explicit ConsoleReporter(std::ostream &os);
+
+  void report(const Result &result) override;
+
+  void report(const std::string &name, const std::vector<ScalingResult> &results) override;
+
+  void report(const std::string &name, const utils::ComplexityFit &fit) override;
+
+ private:
+  std::ostream &_os;
+};
+
+/**
+ * One JSON document: {"benchmarks": [...]} with one writeJson() object per result, scaling step and complexity fit.
+ */
+class JsonReporter : public Reporter {
+ public:
+  explicit JsonReporter(std::ostream &os);
+
+  void begin() override;
+
+  void report(const Result &result) override;
+
+  void report(const std::string &name, const std::vector<ScalingResult> &results) override;
+
+  void report(const std::string &name, const utils::ComplexityFit &fit) override;
+
+  void end() override;
+
+ private:
+  void _separate();
+
+  std::ostream &_os;
+  bool _first = true;
+};
+
+/**
+ * Raw samples as CSV (see writeCsv()), scaling runs write their latencies, complexity fits are not reported.
+ */
+class CsvReporter : public Reporter {
+ public:
+  explicit CsvReporter(std::ostream &os);
+
+  void begin() override;
+
+  void report(const Result &result) override;
+
+  void report(const std::string &name, const std::vector<ScalingResult> &results) override;
+
+  void report(const std::string &name, const utils::ComplexityFit &fit) override;
+
+ private:
+  std::ostream &_os;
+};
+
+/**
+ * Raw samples in the binary format of SampleWriter, one stream per result (scaling runs: per thread count) written one
+ * after the other. Complexity fits are not reported, histogram-only results are not reported either but logged as an
+ * error on stderr.
+ */
+class BinaryReporter : public Reporter {
+ public:
+  explicit BinaryReporter(std::ostream &os);
+
+  void report(const Result &result) override;
+
+  void report(const std::string &name, const std::vector<ScalingResult> &results) override;
+
+  void report(const std::string &name, const utils::ComplexityFit &fit) override;
+
+ private:
+  std::ostream &_os;
+};
+
+/**
+ * @param format: "console", "json", "csv" or "binary"
+ * @throws std::runtime_error for unknown formats
+ */
+std::unique_ptr<Reporter> makeReporter(const std::string &format, std::ostream &os);
+
+}  // namespace benchmark
+}  // namespace timed
+
+#endif  // TIMED_REPORTER_H_
@@ -0,0 +1,169 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#ifndef TIMED_SAMPLESINK_H_
+#define TIMED_SAMPLESINK_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "timed/TimeUtils.h"
+#include "timed/utils/Histogram.h"
+
+namespace timed {
+namespace benchmark {
+
+/**
+ * SampleSink: receives the raw (not baseline adjusted) samples of a run as they are taken (see Config::sink).
+ * add() is called between two samples, never while the timers are running.
+ */
+class SampleSink {
+ public:
+  enum Column : unsigned { WALL = 0, CPU = 1, THREAD_CPU = 2 };
+
+  virtual ~SampleSink() = default;
+
+  /**
+   * Called once per run before its first sample.
+   * @param columns: 2 (wall, CPU) or 3 (wall, CPU, thread CPU)
+   */
+  virtual void begin(unsigned columns) = 0;
+
+  virtual void add(Column column, Time time) = 0;
+
+  /**
+   * Persist the samples taken so far.
+   */
+  virtual void flush() {}
+
+  /**
+   * Called after the last sample of a run, begin() may be called again for the next run. Calls flush() by default.
+   */
+  virtual void end() { flush(); }
+};
+
+/**
+ * MmapSampleSink: appends samples to a memory-mapped file, memory use does not depend on the number of samples.
+ *
+ * Layout (native byte order):
+ *   header (64 bytes): "TIMEDMAP", uint32 version (1), uint32 column count, uint64 sample count per column (3)
+ *   rows: column count int64 values (ns) per row
+ * The file is mapped in regions of regionBytes. A region is pre-faulted (every page is written once) when it is mapped,
+ * so page faults happen when a region is full, not while timers are running. Regions that are written completely are
+ * unmapped (except the first one, it holds the header), so the mapped memory does not grow with the number of samples.
+ * The sample counts in the header are updated with every sample, the file is readable (MappedSampleFile) at any time
+ * and after a crash. end() (or the destructor) truncates the file to its used size. The next begin() (e.g. of the next
+ * repetition) appends to the samples of the previous runs, it needs the same column count.
+ */
+class MmapSampleSink : public SampleSink {
+ public:
+  static constexpr size_t HEADER_BYTES = 64;
+  static constexpr size_t DEFAULT_REGION_BYTES = 64 * 1024 * 1024;
+
+  /**
+   * @param path: created or truncated by the first begin(), later runs (begin() after end()) append to it
+   * @param regionBytes: rounded up to a multiple of the page size
+   * @param hugePages: advise the kernel to back the regions with transparent huge pages (Linux, if supported by the
+   *                   file system)
+   */
+  explicit MmapSampleSink(std::string path, size_t regionBytes = DEFAULT_REGION_BYTES, bool hugePages = false);
+
+  MmapSampleSink(const MmapSampleSink &) = delete;
+
+  MmapSampleSink &operator=(const MmapSampleSink &) = delete;
+
+  ~MmapSampleSink() override;
+
+  /**
+   * @throws std::runtime_error if the file cannot be created or mapped, if it is in use (begin() without end()), if
+   *         columns differs from the column count of the previous runs, or on platforms without mmap
+   */
+  void begin(unsigned columns) override;
+
+  /**
+   * @throws std::runtime_error if a new region cannot be mapped or column was not announced by begin()
+   */
+  void add(Column column, Time time) override;
+
+  /**
+   * Write the mapped pages back to the file (msync).
+   */
+  void flush() override;
+
+  /**
+   * Unmap the file and truncate it to its used size.
+   */
+  void end() override;
+
+  [[nodiscard]] size_t size(Column column) const;
+
+  [[nodiscard]] const std::string &path() const;
+
+ private:
+  // map region index (the regions before it may stay unmapped), the file grows if needed
+  void _mapRegion(size_t index);
+
+  void _close();
+
+  std::string _path;
+  size_t _regionBytes;
+  bool _hugePages;
+  int _fd = -1;
+  size_t _fileBytes = 0;
+  // the file was created by an earlier begin(), later runs append to it
+  bool _begun = false;
+  unsigned _columns = 0;
+  // unmapped regions are nullptr
+  std::vector<char *> _regions;
+  // points into the header in the first region
+  uint64_t *_counts = nullptr;
+};
+
+/**
+ * MappedSampleFile: read-only view of a file written by MmapSampleSink.
+ */
+class MappedSampleFile {
+ public:
+  /**
+   * @throws std::runtime_error if the file cannot be mapped or is no sample file
+   */
+  explicit MappedSampleFile(const std::string &path);
+
+  MappedSampleFile(const MappedSampleFile &) = delete;
+
+  MappedSampleFile &operator=(const MappedSampleFile &) = delete;
+
+  ~MappedSampleFile();
+
+  [[nodiscard]] unsigned columns() const;
+
+  /**
+   * @return number of samples of column (0 if the file has not this column)
+   */
+  [[nodiscard]] size_t size(SampleSink::Column column) const;
+
+  [[nodiscard]] Time at(SampleSink::Column column, size_t index) const;
+
+  /**
+   * Statistics of column in fixed memory: every sample minus baseline is recorded into a histogram.
+   */
+  [[nodiscard]] utils::Histogram histogram(SampleSink::Column column, Time baseline = Time(),
+                                           unsigned significantDigits = 3) const;
+
+ private:
+  const char *_data = nullptr;
+  size_t _bytes = 0;
+  unsigned _columns = 0;
+  uint64_t _counts[3] = {0, 0, 0};
+};
+
+}  // namespace benchmark
+}  // namespace timed
+
+#endif  // TIMED_SAMPLESINK_H_
@@ -3,10 +3,12 @@
 //
 // This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
 #include <ostream>
+#include <type_traits>
 
 #ifndef TIMED_UTILS_TIMECONVERTER_H_
 #define TIMED_UTILS_TIMECONVERTER_H_
@@ -21,16 +23,41 @@ struct TimeValueUnit {
 };
 
 
+/**
+ * Time: a duration stored as a single signed 64-bit nanosecond tick count.
+ * The days/hours/.../nanoseconds breakdown is only computed on demand (format(), getTime(), get*()), all arithmetic
+ * operates on the tick count directly and is constexpr.
+ */
 class Time {
  public:
-  explicit Time(uint64_t days = 0, uint64_t hours = 0, uint64_t minutes = 0, uint64_t seconds = 0,
-                uint64_t milliseconds = 0, uint64_t microseconds = 0, uint64_t nanoseconds = 0);
+  static constexpr int64_t NS_PER_US = 1000;
+  static constexpr int64_t NS_PER_MS = 1000 * NS_PER_US;
+  static constexpr int64_t NS_PER_S = 1000 * NS_PER_MS;
+  static constexpr int64_t NS_PER_M = 60 * NS_PER_S;
+  static constexpr int64_t NS_PER_H = 60 * NS_PER_M;
+  static constexpr int64_t NS_PER_D = 24 * NS_PER_H;
+
+  constexpr explicit Time(uint64_t days = 0, uint64_t hours = 0, uint64_t minutes = 0, uint64_t seconds = 0,
+                          uint64_t milliseconds = 0, uint64_t microseconds = 0, uint64_t nanoseconds = 0)
+      : _ns(static_cast<int64_t>(days) * NS_PER_D + static_cast<int64_t>(hours) * NS_PER_H +
+            static_cast<int64_t>(minutes) * NS_PER_M + static_cast<int64_t>(seconds) * NS_PER_S +
+            static_cast<int64_t>(milliseconds) * NS_PER_MS + static_cast<int64_t>(microseconds) * NS_PER_US +
+            static_cast<int64_t>(nanoseconds)) {}
 
   explicit Time(const TimeValueUnit& timeVU);
 
   Time(const std::string& time, const std::string& fmt);
 
-  void reset();
+  /**
+   * Construct a Time directly from a nanosecond tick count.
+   */
+  static constexpr Time fromNanoseconds(int64_t nanoseconds) {
+    Time t;
+    t._ns = nanoseconds;
+    return t;
+  }
+
+  constexpr void reset() { _ns = 0; }
 
   void parseTime(const std::string& time, const std::string& fmt);
 
@@ -40,55 +67,110 @@ class Time {
 
   TimeValueUnit getTime() const;
 
-  double getDays() const;
-  double getHours() const;
-  double getMinutes() const;
-  double getSeconds() const;
-  double getMilliseconds() const;
-  double getMicroseconds() const;
-  uint64_t getNanoseconds() const;
-
-  Time operator+(const Time& t) const;
-  Time operator-(const Time& t) const;
+  constexpr double getDays() const { return static_cast<double>(_ns) / NS_PER_D; }
+  constexpr double getHours() const { return static_cast<double>(_ns) / NS_PER_H; }
+  constexpr double getMinutes() const { return static_cast<double>(_ns) / NS_PER_M; }
+  constexpr double getSeconds() const { return static_cast<double>(_ns) / NS_PER_S; }
+  constexpr double getMilliseconds() const { return static_cast<double>(_ns) / NS_PER_MS; }
+  constexpr double getMicroseconds() const { return static_cast<double>(_ns) / NS_PER_US; }
+  constexpr uint64_t getNanoseconds() const { return static_cast<uint64_t>(_ns); }
 
-  template<typename Numeric>
-  Time operator*(Numeric value);
-  Time operator*(const Time& t) const;
+  /**
+   * Raw signed tick count in nanoseconds.
+   */
+  constexpr int64_t count() const { return _ns; }
 
-  template<typename Numeric>
-  Time operator/(Numeric value);
+  constexpr Time operator+(const Time& t) const { return fromNanoseconds(_ns + t._ns); }
 
-  Time& operator+=(const Time& t);
-  Time& operator+=(uint64_t nanoseconds);
-  Time& operator-=(const Time& t);
+  /**
+   * Subtraction is clamped at zero: a Time never becomes negative through operator-.
+   */
+  constexpr Time operator-(const Time& t) const { return fromNanoseconds(t._ns > _ns ? 0 : _ns - t._ns); }
 
   template<typename Numeric>
-  Time& operator*=(Numeric value);
+  constexpr Time operator*(Numeric value) const { return fromNanoseconds(_scaled(value)); }
+  constexpr Time operator*(const Time& t) const { return fromNanoseconds(_ns * t._ns); }
 
   template<typename Numeric>
-  Time& operator/=(Numeric value);
+  constexpr Time operator/(Numeric value) const { return fromNanoseconds(_divided(value)); }
+
+  constexpr Time& operator+=(const Time& t) {
+    _ns += t._ns;
+    return *this;
+  }
+  constexpr Time& operator+=(uint64_t nanoseconds) {
+    _ns += static_cast<int64_t>(nanoseconds);
+    return *this;
+  }
+  constexpr Time& operator-=(const Time& t) {
+    _ns = t._ns > _ns ? 0 : _ns - t._ns;
+    return *this;
+  }
 
-  bool operator==(const Time& t) const;
-  bool operator!=(const Time& t) const;
-  bool operator>(const Time& t) const;
-  bool operator>=(const Time& t) const;
-  bool operator<(const Time& t) const;
-  bool operator<=(const Time& t) const;
+  template<typename Numeric>
+  constexpr Time& operator*=(Numeric value) {
+    _ns = _scaled(value);
+    return *this;
+  }
 
-  explicit operator uint64_t() const;
-  explicit operator long() const;
-  explicit operator double() const;
+  template<typename Numeric>
+  constexpr Time& operator/=(Numeric value) {
+    _ns = _divided(value);
+    return *this;
+  }
+
+  constexpr bool operator==(const Time& t) const { return _ns == t._ns; }
+  constexpr bool operator!=(const Time& t) const { return _ns != t._ns; }
+  constexpr bool operator>(const Time& t) const { return _ns > t._ns; }
+  constexpr bool operator>=(const Time& t) const { return _ns >= t._ns; }
+  constexpr bool operator<(const Time& t) const { return _ns < t._ns; }
+  constexpr bool operator<=(const Time& t) const { return _ns <= t._ns; }
+
+  constexpr explicit operator uint64_t() const { return getNanoseconds(); }
+  constexpr explicit operator long() const { return static_cast<long>(_ns); }
+  constexpr explicit operator double() const { return static_cast<double>(_ns); }
 
  private:
-  void _normalize();
+  /**
+   * Calendar-like breakdown of the tick count. Only computed when a human-readable representation is needed.
+   */
+  struct Components {
+    uint64_t days = 0;
+    uint64_t hours = 0;
+    uint64_t minutes = 0;
+    uint64_t seconds = 0;
+    uint64_t milliseconds = 0;
+    uint64_t microseconds = 0;
+    uint64_t nanoseconds = 0;
+  };
+
+  Components _components() const;
 
-  uint64_t _days = 0;
-  uint64_t _hours = 0;
-  uint64_t _minutes = 0;
-  uint64_t _seconds = 0;
-  uint64_t _milliseconds = 0;
-  uint64_t _microseconds = 0;
-  uint64_t _nanoseconds = 0;
+  template<typename Numeric>
+  constexpr int64_t _scaled(Numeric value) const {
+    if constexpr (std::is_floating_point<Numeric>::value) {
+      return static_cast<int64_t>(static_cast<double>(_ns) * static_cast<double>(value));
+    } else {
+      return _ns * static_cast<int64_t>(value);
+    }
+  }
+
+  // rounds to the nearest nanosecond
+  template<typename Numeric>
+  constexpr int64_t _divided(Numeric value) const {
+    if constexpr (std::is_floating_point<Numeric>::value) {
+      double q = static_cast<double>(_ns) / static_cast<double>(value);
+      return static_cast<int64_t>(q < 0 ? q - 0.5 : q + 0.5);
+    } else {
+      auto v = static_cast<int64_t>(value);
+      int64_t q = _ns / v;
+      int64_t r = _ns % v;
+      if (2 * (r < 0 ? -r : r) >= (v < 0 ? -v : v)) { q += ((r < 0) != (v < 0)) ? -1 : 1; }
+      return q;
+    }
+  }
+
+  int64_t _ns = 0;
 
   friend std::ostream &operator<<(std::ostream &os, const Time &tf);
 };
@@ -97,4 +179,4 @@ std::ostream &operator<<(std::ostream &os, const Time &tf);
 
 }  // namespace timed
 
-#endif  // TIMED_UTILS_TIMECONVERTER_H_
\ No newline at end of file
+#endif  // TIMED_UTILS_TIMECONVERTER_H_
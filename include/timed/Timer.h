@@ -9,10 +9,24 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <ctime>
+#include <iostream>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TIMED_HAS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define TIMED_HAS_TSC 1
+#else
+#define TIMED_HAS_TSC 0
+#endif
+
+#include "timed/IntervalStorage.h"
 #include "timed/TimeUtils.h"
 #include "timed/utils/Statistics.h"
 
@@ -77,16 +91,95 @@ using SteadyClockInterval = std::pair<
     std::chrono::time_point<std::chrono::steady_clock>
     >;
 using ClockTInterval = std::pair<std::clock_t, std::clock_t>;
+using TscInterval = std::pair<uint64_t, uint64_t>;
+using CPUClockInterval = std::pair<uint64_t, uint64_t>;
 
 /**
- * Base class for WallTimer and CPUTimer.
- * Templates for either pair of std::chrono::steady_clock values (WallTimer) or pair of std::clock_t values (CPUTimer).
+ * CPU time clock used by CPUTimer:
+ *  - PROCESS: CPU time consumed by all threads of the process (CLOCK_PROCESS_CPUTIME_ID)
+ *  - THREAD: CPU time consumed by the calling thread only (CLOCK_THREAD_CPUTIME_ID)
+ */
+enum class CPUClock { PROCESS, THREAD };
+
+/**
+ * Clock read by a timer: steady_clock (WallTimer), time stamp counter (TscTimer) or process/thread CPU time (CPUTimer).
+ */
+enum class ClockSource { STEADY, TSC, CPU_PROCESS, CPU_THREAD };
+
+/**
+ * Estimated cost of one start()/stop() pair of a timer reading source: the 5th percentile of 1000 empty measurements
+ * taken after 100 warm-up measurements. A low percentile is used instead of the mean so that preemptions and cache
+ * misses during calibration do not inflate the estimate. Measured once per clock source and process, on first use.
+ * TSC falls back to STEADY if no invariant TSC is available.
+ */
+Time timerOverhead(ClockSource source);
+
+namespace detail {
+
+struct TscCalibration {
+  bool invariant = false;
+  double nsPerTick = 1.0;
+};
+
+/**
+ * TSC calibration against std::chrono::steady_clock, computed once per process on first use.
+ */
+const TscCalibration &tscCalibration();
+
+/**
+ * CPU time of the process or calling thread in nanoseconds.
+ */
+uint64_t cpuNanoseconds(CPUClock clock);
+
+// _____________________________________________________________________________________________________________________
+inline uint64_t steadyTicks() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// _____________________________________________________________________________________________________________________
+// lfence keeps rdtsc from being executed before preceding instructions have completed. Falls back to steadyTicks() if
+// useTsc is false.
+inline uint64_t startTicks(bool useTsc) {
+#if TIMED_HAS_TSC
+  if (useTsc) {
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+  }
+#endif
+  return steadyTicks();
+}
+
+// _____________________________________________________________________________________________________________________
+// rdtscp waits for preceding instructions, the trailing lfence keeps subsequent ones from starting early. Falls back to
+// steadyTicks() if useTsc is false.
+inline uint64_t stopTicks(bool useTsc) {
+#if TIMED_HAS_TSC
+  if (useTsc) {
+    unsigned aux;
+    uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+  }
+#endif
+  return steadyTicks();
+}
+
+}  // namespace detail
+
+/**
+ * Base class for WallTimer, TscTimer and CPUTimer.
+ * Templates for either pair of std::chrono::steady_clock values (WallTimer), pair of ticks (TscTimer) or pair of
+ * nanosecond CPU clock readings (CPUTimer).
  * implements:
  *  - reset();
  *  - getIntervals();
  * @tparam Interval
+ * @tparam Storage: interval storage policy (AccumulatorStorage, RingBufferStorage or VectorStorage)
  */
-template<typename Interval>
+template<typename Interval, typename Storage = VectorStorage<Interval>>
 class Timer {
  public:
   virtual ~Timer() = default;
@@ -106,6 +199,10 @@ class Timer {
    */
   virtual Time stop() = 0;
 
+  /**
+   * Set the baseline to timerOverhead() of the timer's clock source. Afterwards the baseline is subtracted (clamped at
+   * zero) from every measured interval.
+   */
   virtual void calibrate() = 0;
 
   /**
@@ -114,9 +211,17 @@ class Timer {
   void reset() {
     _stopped = false;
     _running = false;
-    _intervals.clear();
+    _closedIntervals = 0;
+    _storage.clear();
   };
 
+  /**
+   * @return overhead subtracted per measured interval (zero unless calibrate() was called)
+   */
+  [[nodiscard]] Time getBaseline() const {
+    return _baseLine;
+  }
+
   /**
    * Get elapsed nanoseconds (ns) of collected intervals
    * @return long int: in nanoseconds
@@ -124,26 +229,57 @@ class Timer {
   [[nodiscard]] virtual Time getTime() const = 0;
 
   /**
-   * Returns all collected intervals
+   * Returns the collected intervals kept by the storage policy, oldest first
    * @return Interval
    */
-  [[nodiscard]] std::vector<Interval> &getIntervals() const {
-    return _intervals;
+  [[nodiscard]] std::vector<Interval> getIntervals() const {
+    return _storage.intervals();
   }
 
  protected:
   bool _running = false;
   bool _stopped = false;
-  std::vector<Interval> _intervals;
+  Storage _storage;
   Time _baseLine;
+  // number of pause()/stop() calls since the last reset, the baseline is subtracted once per interval
+  uint64_t _closedIntervals = 0;
+
+  [[nodiscard]] Time _overhead() const {
+    return _baseLine * (_closedIntervals + (_running ? 1 : 0));
+  }
 };
 
 /**
  * WallTimer: simple timer to measure wall time from start() to stop()/pause() call.
  */
-class WallTimer : public Timer<SteadyClockInterval> {
+template<typename Storage = VectorStorage<SteadyClockInterval>>
+class BasicWallTimer : public Timer<SteadyClockInterval, Storage> {
+ public:
+  BasicWallTimer() = default;
+
+  void start() override;
+
+  Time pause() override;
+
+  Time stop() override;
+
+  void calibrate() override;
+
+  [[nodiscard]] Time getTime() const override;
+};
+
+using WallTimer = BasicWallTimer<>;
+
+
+/**
+ * TscTimer: wall time timer reading the CPU's time stamp counter (rdtsc/rdtscp) instead of std::chrono::steady_clock.
+ * The tick frequency is calibrated against std::chrono::steady_clock once per process. If the CPU does not provide an
+ * invariant TSC (or is not x86), the timer falls back to std::chrono::steady_clock.
+ */
+template<typename Storage = VectorStorage<TscInterval>>
+class BasicTscTimer : public Timer<TscInterval, Storage> {
  public:
-  WallTimer() = default;
+  BasicTscTimer();
 
   void start() override;
 
@@ -154,15 +290,35 @@ class WallTimer : public Timer<SteadyClockInterval> {
   void calibrate() override;
 
   [[nodiscard]] Time getTime() const override;
+
+  /**
+   * @return true if ticks are read from an invariant TSC, false if std::chrono::steady_clock is used as fallback.
+   */
+  static bool usesTsc() { return detail::tscCalibration().invariant; }
+
+  /**
+   * @return calibrated duration of one tick in nanoseconds (1.0 for the steady_clock fallback).
+   */
+  static double nanosecondsPerTick() { return detail::tscCalibration().nsPerTick; }
+
+ private:
+  [[nodiscard]] Time _toTime(uint64_t ticks) const;
+
+  bool _useTsc;
+  double _nsPerTick;
 };
 
+using TscTimer = BasicTscTimer<>;
+
 
 /**
  * CPUTimer: timer to measure CPU time from start() to stop()/pause() call.
+ * Reads clock_gettime() with nanosecond resolution. A THREAD timer must be started and stopped on the same thread.
  */
-class CPUTimer : public Timer<ClockTInterval> {
+template<typename Storage = VectorStorage<CPUClockInterval>>
+class BasicCPUTimer : public Timer<CPUClockInterval, Storage> {
  public:
-  CPUTimer();
+  explicit BasicCPUTimer(CPUClock clock = CPUClock::PROCESS);
 
   void start() override;
 
@@ -173,8 +329,187 @@ class CPUTimer : public Timer<ClockTInterval> {
   void calibrate() override;
 
   [[nodiscard]] Time getTime() const override;
+
+  [[nodiscard]] CPUClock getClock() const;
+
+ private:
+  CPUClock _clock;
 };
 
+using CPUTimer = BasicCPUTimer<>;
+
+
+// ===== WallTimer =====================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+void BasicWallTimer<Storage>::start() {
+  if (this->_running) { return; }
+  if (this->_stopped) this->reset();
+  this->_running = true;
+  this->_storage.open(std::chrono::steady_clock::now());
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicWallTimer<Storage>::pause() {
+  if (!this->_running) { return getTime(); }
+  auto d = this->_storage.close(std::chrono::steady_clock::now());
+  this->_running = false;
+  ++this->_closedIntervals;
+  return Time::fromNanoseconds(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) - this->_baseLine;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicWallTimer<Storage>::stop() {
+  if (!this->_running) { return getTime(); }
+  this->_storage.close(std::chrono::steady_clock::now());
+  ++this->_closedIntervals;
+  this->_stopped = true;
+  this->_running = false;
+  return getTime();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+void BasicWallTimer<Storage>::calibrate() {
+  this->_baseLine = timerOverhead(ClockSource::STEADY);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicWallTimer<Storage>::getTime() const {
+  auto total = this->_storage.total();
+  if (this->_running) {
+    total += std::chrono::steady_clock::now() - this->_storage.back().first;
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(total).count();
+  return Time::fromNanoseconds(ns) - this->_overhead();
+}
+
+// ===== TscTimer ======================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+BasicTscTimer<Storage>::BasicTscTimer()
+    : _useTsc(detail::tscCalibration().invariant), _nsPerTick(detail::tscCalibration().nsPerTick) {}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+void BasicTscTimer<Storage>::start() {
+  if (this->_running) { return; }
+  if (this->_stopped) this->reset();
+  this->_running = true;
+  this->_storage.open(detail::startTicks(_useTsc));
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicTscTimer<Storage>::pause() {
+  if (!this->_running) { return getTime(); }
+  auto ticks = this->_storage.close(detail::stopTicks(_useTsc));
+  this->_running = false;
+  ++this->_closedIntervals;
+  return _toTime(ticks) - this->_baseLine;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicTscTimer<Storage>::stop() {
+  if (!this->_running) { return getTime(); }
+  this->_storage.close(detail::stopTicks(_useTsc));
+  ++this->_closedIntervals;
+  this->_stopped = true;
+  this->_running = false;
+  return getTime();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+void BasicTscTimer<Storage>::calibrate() {
+  this->_baseLine = timerOverhead(_useTsc ? ClockSource::TSC : ClockSource::STEADY);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicTscTimer<Storage>::getTime() const {
+  uint64_t ticks = this->_storage.total();
+  if (this->_running) {
+    ticks += detail::stopTicks(_useTsc) - this->_storage.back().first;
+  }
+  return _toTime(ticks) - this->_overhead();
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicTscTimer<Storage>::_toTime(uint64_t ticks) const {
+  return Time::fromNanoseconds(static_cast<int64_t>(static_cast<double>(ticks) * _nsPerTick + 0.5));
+}
+
+// ===== CPUTimer ======================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+BasicCPUTimer<Storage>::BasicCPUTimer(CPUClock clock) : _clock(clock) {
+#ifdef _WIN32
+  std::cout << "WARNING: CPU Timer not supported on Windows OS. Consider using WallTimer instead." << std::endl;
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+void BasicCPUTimer<Storage>::start() {
+  if (this->_running) return;
+  if (this->_stopped) this->reset();
+  this->_running = true;
+  this->_storage.open(detail::cpuNanoseconds(_clock));
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicCPUTimer<Storage>::pause() {
+  if (!this->_running) { return getTime(); }
+  auto ns = this->_storage.close(detail::cpuNanoseconds(_clock));
+  this->_running = false;
+  ++this->_closedIntervals;
+  return Time::fromNanoseconds(static_cast<int64_t>(ns)) - this->_baseLine;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicCPUTimer<Storage>::stop() {
+  if (!this->_running) { return getTime(); }
+  this->_storage.close(detail::cpuNanoseconds(_clock));
+  ++this->_closedIntervals;
+  this->_stopped = true;
+  this->_running = false;
+  return getTime();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+void BasicCPUTimer<Storage>::calibrate() {
+  this->_baseLine = timerOverhead(_clock == CPUClock::THREAD ? ClockSource::CPU_THREAD : ClockSource::CPU_PROCESS);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+Time BasicCPUTimer<Storage>::getTime() const {
+  uint64_t ns = this->_storage.total();
+  if (this->_running) {
+    ns += detail::cpuNanoseconds(_clock) - this->_storage.back().first;
+  }
+  return Time::fromNanoseconds(static_cast<int64_t>(ns)) - this->_overhead();
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename Storage>
+CPUClock BasicCPUTimer<Storage>::getClock() const {
+  return _clock;
+}
+
 }  // namespace timed
 
-#endif  // TIMED_H_
\ No newline at end of file
+#endif  // TIMED_H_
@@ -0,0 +1,54 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <vector>
+
+#ifndef TIMED_UTILS_COMPLEXITY_H_
+#define TIMED_UTILS_COMPLEXITY_H_
+
+namespace timed {
+namespace utils {
+
+enum class Complexity { O_1, O_LOG_N, O_N, O_N_LOG_N, O_N_SQUARED };
+
+/**
+ * @return e.g. "O(n log n)"
+ */
+const char *toString(Complexity complexity);
+
+/**
+ * @return the model function f(n) of complexity (logarithms are base 2)
+ */
+double complexityFunction(Complexity complexity, double n);
+
+/**
+ * Least squares fit of times ~ coefficient * f(n).
+ */
+struct ComplexityFit {
+  Complexity complexity = Complexity::O_1;
+  // in the unit of the fitted times
+  double coefficient = 0;
+  // root mean square of the residuals, in the unit of the fitted times
+  double rms = 0;
+  // rms relative to the mean of the fitted times
+  double relativeRms = 0;
+};
+
+/**
+ * Fit times (measured at the input sizes n) against the given model.
+ * @throws std::runtime_error if n and times differ in size or are empty
+ */
+ComplexityFit fitComplexity(const std::vector<double> &n, const std::vector<double> &times, Complexity complexity);
+
+/**
+ * Fit times against all models.
+ * @return the fit with the smallest rms
+ */
+ComplexityFit fitComplexity(const std::vector<double> &n, const std::vector<double> &times);
+
+}  // namespace utils
+}  // namespace timed
+
+#endif  // TIMED_UTILS_COMPLEXITY_H_
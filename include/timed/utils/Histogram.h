@@ -0,0 +1,97 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cstdint>
+#include <vector>
+
+#include "timed/TimeUtils.h"
+
+#ifndef TIMED_UTILS_HISTOGRAM_H_
+#define TIMED_UTILS_HISTOGRAM_H_
+
+namespace timed {
+namespace utils {
+
+/**
+ * Histogram: fixed memory, log-bucketed (HDR-style) histogram of durations.
+ * Values from 1 ns up to highestTrackable are recorded with a relative error of at most 10^-significantDigits. Each
+ * power of two range is split into 2 * 10^significantDigits linear sub-buckets, so record() is O(1) (one leading zero
+ * count and a few shifts) and memory does not depend on the number of samples.
+ * Values above highestTrackable are recorded as highestTrackable, negative values as 0.
+ * The counts array is allocated on first record(), an unused Histogram does not allocate.
+ */
+class Histogram {
+ public:
+  /**
+   * @param significantDigits: decimal digits of precision, 1 to 5
+   * @param highestTrackable: largest value that is tracked exactly (default: one day)
+   */
+  explicit Histogram(unsigned significantDigits = 3, Time highestTrackable = Time(1));
+
+  void record(Time time);
+
+  void record(Time time, uint64_t count);
+
+  /**
+   * Add all counts of other. Both histograms must have the same configuration.
+   */
+  void merge(const Histogram &other);
+
+  void reset();
+
+  [[nodiscard]] uint64_t count() const;
+
+  [[nodiscard]] bool empty() const;
+
+  [[nodiscard]] Time min() const;
+
+  [[nodiscard]] Time max() const;
+
+  [[nodiscard]] Time mean() const;
+
+  [[nodiscard]] Time stddev() const;
+
+  /**
+   * @param percentile: in [0, 100]
+   * @return highest value equivalent to the value at the given percentile
+   */
+  [[nodiscard]] Time percentile(double percentile) const;
+
+  [[nodiscard]] Time median() const;
+
+  [[nodiscard]] unsigned significantDigits() const;
+
+  [[nodiscard]] Time highestTrackable() const;
+
+  /**
+   * @return number of counters (fixed by configuration)
+   */
+  [[nodiscard]] size_t bucketCount() const;
+
+ private:
+  [[nodiscard]] size_t _countsIndex(uint64_t value) const;
+
+  [[nodiscard]] uint64_t _valueFromIndex(size_t index) const;
+
+  [[nodiscard]] uint64_t _equivalentRange(uint64_t value) const;
+
+  [[nodiscard]] uint64_t _medianEquivalent(uint64_t value) const;
+
+  unsigned _significantDigits;
+  uint64_t _highestTrackable;
+  unsigned _subBucketHalfCountMagnitude;
+  uint64_t _subBucketHalfCount;
+  uint64_t _subBucketMask;
+  size_t _countsLength;
+  std::vector<uint64_t> _counts;
+  uint64_t _totalCount = 0;
+  uint64_t _min = UINT64_MAX;
+  uint64_t _max = 0;
+};
+
+}  // namespace utils
+}  // namespace timed
+
+#endif  // TIMED_UTILS_HISTOGRAM_H_
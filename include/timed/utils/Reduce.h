@@ -0,0 +1,87 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifndef TIMED_UTILS_REDUCE_H_
+#define TIMED_UTILS_REDUCE_H_
+
+namespace timed {
+namespace utils {
+namespace simd {
+
+/**
+ * Instruction sets the reduction kernels are compiled for. Ordered: a CPU supporting one of them supports all
+ * smaller ones.
+ * AVX512 requires the F and DQ extensions.
+ */
+enum class InstructionSet { SCALAR, AVX2, AVX512 };
+
+/**
+ * @return best instruction set supported by the executing CPU (detected once)
+ */
+InstructionSet bestInstructionSet();
+
+bool isSupported(InstructionSet instructionSet);
+
+const char *toString(InstructionSet instructionSet);
+
+/**
+ * Element types the kernels are available for.
+ */
+template<typename T>
+constexpr bool IS_VECTORIZABLE =
+  std::is_same<T, double>::value || std::is_same<T, int64_t>::value || std::is_same<T, uint64_t>::value;
+
+template<typename T>
+struct MinMax {
+  T min;
+  T max;
+};
+
+// All kernels read size contiguous elements starting at data and never allocate. An instruction set that is not
+// supported by the executing CPU falls back to the best supported one.
+
+/**
+ * Integers are summed exactly (modulo 2^64) and converted to double once, doubles are summed in an unspecified order.
+ */
+double sum(const double *data, size_t size, InstructionSet instructionSet = bestInstructionSet());
+double sum(const int64_t *data, size_t size, InstructionSet instructionSet = bestInstructionSet());
+double sum(const uint64_t *data, size_t size, InstructionSet instructionSet = bestInstructionSet());
+
+/**
+ * @return sum over (x - center)^2, computed in double
+ */
+double sumOfSquaredDeviations(const double *data, size_t size, double center,
+                              InstructionSet instructionSet = bestInstructionSet());
+double sumOfSquaredDeviations(const int64_t *data, size_t size, double center,
+                              InstructionSet instructionSet = bestInstructionSet());
+double sumOfSquaredDeviations(const uint64_t *data, size_t size, double center,
+                              InstructionSet instructionSet = bestInstructionSet());
+
+/**
+ * @return sum over |x - center|, computed in double
+ */
+double sumOfAbsoluteDeviations(const double *data, size_t size, double center,
+                               InstructionSet instructionSet = bestInstructionSet());
+double sumOfAbsoluteDeviations(const int64_t *data, size_t size, double center,
+                               InstructionSet instructionSet = bestInstructionSet());
+double sumOfAbsoluteDeviations(const uint64_t *data, size_t size, double center,
+                               InstructionSet instructionSet = bestInstructionSet());
+
+/**
+ * @return smallest and largest element, {0, 0} if size is 0
+ */
+MinMax<double> minMax(const double *data, size_t size, InstructionSet instructionSet = bestInstructionSet());
+MinMax<int64_t> minMax(const int64_t *data, size_t size, InstructionSet instructionSet = bestInstructionSet());
+MinMax<uint64_t> minMax(const uint64_t *data, size_t size, InstructionSet instructionSet = bestInstructionSet());
+
+}  // namespace simd
+}  // namespace utils
+}  // namespace timed
+
+#endif  // TIMED_UTILS_REDUCE_H_
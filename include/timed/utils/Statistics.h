@@ -7,8 +7,10 @@
 #include <cmath>
 #include <numeric>
 #include <algorithm>
+#include <type_traits>
 
 #include "timed/TimeUtils.h"
+#include "timed/utils/Reduce.h"
 
 
 #ifndef TIMED_UTILS_STATISTICS_H_
@@ -21,47 +23,79 @@ namespace utils {
 template<typename Numeric>
 #ifdef _WIN32
 Numeric (min)(const std::vector<Numeric> &vec) {
-  return *std::min_element(vec.begin(), vec.end());
-}
 #else
 Numeric min(const std::vector<Numeric> &vec) {
-  return *std::min_element(vec.begin(), vec.end());
-}
 #endif
+  if constexpr (simd::IS_VECTORIZABLE<Numeric>) {
+    return simd::minMax(vec.data(), vec.size()).min;
+  } else {
+    return *std::min_element(vec.begin(), vec.end());
+  }
+}
 
 template<typename Numeric>
 #ifdef _WIN32
 Numeric (max)(const std::vector<Numeric> &vec) {
-  return *std::max_element(vec.begin(), vec.end());
-}
 #else
 Numeric max(const std::vector<Numeric> &vec) {
-  return *std::max_element(vec.begin(), vec.end());
-}
 #endif
+  if constexpr (simd::IS_VECTORIZABLE<Numeric>) {
+    return simd::minMax(vec.data(), vec.size()).max;
+  } else {
+    return *std::max_element(vec.begin(), vec.end());
+  }
+}
+
+// double, int64_t and uint64_t vectors are reduced by the vector kernels in Reduce.h, other types by scalar loops.
+// Sums of generic integers are accumulated in double: the exact integer kernels wrap modulo 2^64, which only the
+// Time overloads (nanoseconds) can rule out.
 
 template<typename Numeric>
 double mean(const std::vector<Numeric> &vec) {
-  return std::accumulate(vec.begin(), vec.end(), 0.0) / vec.size();
+  if constexpr (std::is_same_v<Numeric, double>) {
+    return simd::sum(vec.data(), vec.size()) / static_cast<double>(vec.size());
+  } else {
+    return std::accumulate(vec.begin(), vec.end(), 0.0) / static_cast<double>(vec.size());
+  }
 }
 
 template<typename Numeric>
 double stddev(const std::vector<Numeric> &vec) {
   double m = mean(vec);
-  std::vector<double> diff(vec.size());
-  std::transform(vec.begin(), vec.end(), diff.begin(), [m](Numeric x) { return (x - m) * (x - m); });
-  return std::sqrt(std::accumulate(diff.begin(), diff.end(), 0.0) / static_cast<double>(diff.size()));
+  if constexpr (simd::IS_VECTORIZABLE<Numeric>) {
+    return std::sqrt(simd::sumOfSquaredDeviations(vec.data(), vec.size(), m) / static_cast<double>(vec.size()));
+  } else {
+    double sum = 0;
+    for (const auto &x: vec) { sum += (x - m) * (x - m); }
+    return std::sqrt(sum / static_cast<double>(vec.size()));
+  }
+}
+
+/**
+ * @return mean of |x - mean(vec)|
+ */
+template<typename Numeric>
+double meanAbsoluteDeviation(const std::vector<Numeric> &vec) {
+  double m = mean(vec);
+  if constexpr (simd::IS_VECTORIZABLE<Numeric>) {
+    return simd::sumOfAbsoluteDeviations(vec.data(), vec.size(), m) / static_cast<double>(vec.size());
+  } else {
+    double sum = 0;
+    for (const auto &x: vec) { sum += std::abs(x - m); }
+    return sum / static_cast<double>(vec.size());
+  }
 }
 
 template<typename Numeric>
 Numeric median(std::vector<Numeric> vec) {
   if (vec.empty()) return 0.0;
-  std::sort(vec.begin(), vec.end());
   auto mid = vec.size() / 2U;
+  std::nth_element(vec.begin(), vec.begin() + mid, vec.end());
   if (1U == (vec.size() & 1U)) {
     return vec[mid];
   }
-  return (vec[mid - 1U] + vec[mid]) / 2U;
+  // the lower middle value is the largest value left of mid
+  return (*std::max_element(vec.begin(), vec.begin() + mid) + vec[mid]) / 2U;
 }
 
 template<typename Numeric>
@@ -76,6 +110,134 @@ double medianAbsolutePercentError(std::vector<Numeric> vec) {
   return median(errVec);
 }
 
+/**
+ * Summary: statistics of a sample vector computed by Summarizer.
+ * variance is the population variance (as used by stddev()), percentiles use the nearest rank definition.
+ */
+struct Summary {
+  size_t count = 0;
+  double min = 0;
+  double max = 0;
+  double mean = 0;
+  double variance = 0;
+  double median = 0;
+  double p50 = 0;
+  double p90 = 0;
+  double p99 = 0;
+  double p999 = 0;
+  double medianAbsolutePercentError = 0;
+
+  [[nodiscard]] double stddev() const { return std::sqrt(variance); }
+};
+
+/**
+ * Summarizer: computes Summary objects in linear time.
+ * min, max, mean and variance (Welford) are computed in the same pass that copies the data into a scratch buffer,
+ * percentiles are selected with std::nth_element on that buffer. The buffer is kept between calls, so summarizing
+ * several vectors allocates at most once (for the largest one).
+ */
+class Summarizer {
+ public:
+  template<typename Numeric>
+  Summary summarize(const std::vector<Numeric> &vec) {
+    _load(vec.begin(), vec.end(), [](const Numeric &x) { return static_cast<double>(x); });
+    return _summarize();
+  }
+
+  /**
+   * Summarize vec - baseline (clamped at zero) without materializing the adjusted vector.
+   */
+  Summary summarize(const std::vector<Time> &vec, Time baseline) {
+    _load(vec.begin(), vec.end(), [baseline](const Time &x) { return static_cast<double>(x - baseline); });
+    return _summarize();
+  }
+
+  /**
+   * @param ranks: percentile ranks in [0, 100]
+   * @return nearest rank percentiles of vec in the order of ranks
+   */
+  template<typename Numeric>
+  std::vector<double> percentiles(const std::vector<Numeric> &vec, const std::vector<double> &ranks) {
+    _load(vec.begin(), vec.end(), [](const Numeric &x) { return static_cast<double>(x); });
+    std::vector<double> ret(ranks.size(), 0.0);
+    std::vector<size_t> order(ranks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&ranks](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+    auto lo = _scratch.begin();
+    for (size_t i: order) {
+      ret[i] = _select(lo, ranks[i]);
+    }
+    return ret;
+  }
+
+ private:
+  template<typename It, typename ToDouble>
+  void _load(It begin, It end, ToDouble toDouble) {
+    _scratch.resize(static_cast<size_t>(std::distance(begin, end)));
+    _moments = Summary();
+    double m2 = 0;
+    size_t n = 0;
+    for (It it = begin; it != end; ++it) {
+      double x = toDouble(*it);
+      _scratch[n++] = x;
+      if (n == 1 || x < _moments.min) _moments.min = x;
+      if (n == 1 || x > _moments.max) _moments.max = x;
+      double delta = x - _moments.mean;
+      _moments.mean += delta / static_cast<double>(n);
+      m2 += delta * (x - _moments.mean);
+    }
+    _moments.count = n;
+    _moments.variance = n == 0 ? 0 : m2 / static_cast<double>(n);
+  }
+
+  /**
+   * Select the nearest rank percentile. Ranks must be requested in ascending order with the same lo: every call only
+   * partitions the part of the scratch buffer right of the previously selected element.
+   */
+  double _select(std::vector<double>::iterator &lo, double rank) {
+    if (_scratch.empty()) return 0;
+    // the epsilon keeps ranks like 99.9 (not exactly representable) from rounding up to the next index
+    auto index = static_cast<size_t>(std::ceil(rank / 100.0 * static_cast<double>(_scratch.size()) - 1e-9));
+    if (index > 0) --index;
+    index = std::min(index, _scratch.size() - 1);
+    auto kth = _scratch.begin() + static_cast<std::ptrdiff_t>(index);
+    if (kth >= lo) {
+      std::nth_element(lo, kth, _scratch.end());
+      lo = kth;
+    }
+    return *kth;
+  }
+
+  // median of the scratch buffer (mean of both middle values for even sizes), reorders the buffer
+  double _median() {
+    auto mid = _scratch.begin() + static_cast<std::ptrdiff_t>(_scratch.size() / 2);
+    std::nth_element(_scratch.begin(), mid, _scratch.end());
+    if (_scratch.size() % 2 == 1) return *mid;
+    return (*std::max_element(_scratch.begin(), mid) + *mid) / 2;
+  }
+
+  Summary _summarize() {
+    Summary summary = _moments;
+    if (_scratch.empty()) { return summary; }
+    auto lo = _scratch.begin();
+    summary.p50 = _select(lo, 50);
+    summary.p90 = _select(lo, 90);
+    summary.p99 = _select(lo, 99);
+    summary.p999 = _select(lo, 99.9);
+    summary.median = _median();
+    // the percentiles are done, the scratch buffer is reused for the relative errors
+    double med = summary.median;
+    for (auto &x: _scratch) {
+      x = x == 0 ? 0 : std::abs((x - med) / x);
+    }
+    summary.medianAbsolutePercentError = _median();
+    return summary;
+  }
+
+  std::vector<double> _scratch;
+  Summary _moments;
+};
+
 #ifdef _WIN32
 Time (min)(const std::vector<Time>& vec);
 
@@ -90,10 +252,58 @@ Time mean(const std::vector<Time>& vec);
 
 Time stddev(const std::vector<Time>& vec);
 
+Time meanAbsoluteDeviation(const std::vector<Time>& vec);
+
 Time median(const std::vector<Time>& vec);
 
 double medianAbsolutePercentError(const std::vector<Time>& vec);
 
+/**
+ * Two-sided Mann-Whitney U test of two independent samples, p-value from the normal approximation with tie and
+ * continuity correction.
+ */
+struct MannWhitneyResult {
+  // U statistic of the first sample (number of pairs in which its value is larger, ties count 1/2)
+  double u = 0;
+  double z = 0;
+  double pValue = 1;
+};
+
+MannWhitneyResult mannWhitneyU(const std::vector<double> &a, const std::vector<double> &b);
+
+struct ConfidenceInterval {
+  double low = 0;
+  double high = 0;
+};
+
+/**
+ * Percentile bootstrap confidence interval of median(b) / median(a): both samples are resampled with replacement
+ * resamples times. Costs O(resamples * (a.size() + b.size())).
+ * @param confidence: e.g. 0.95
+ * @param seed: the interval is deterministic for a given seed
+ */
+ConfidenceInterval bootstrapMedianRatio(const std::vector<double> &a, const std::vector<double> &b, double confidence,
+                                        unsigned resamples, uint64_t seed = 0);
+
+/**
+ * Two-sided Wilcoxon signed-rank test of paired differences against a median of zero, p-value from the normal
+ * approximation with tie and continuity correction. Zero differences are dropped.
+ */
+struct WilcoxonResult {
+  // sum of the ranks of the positive differences
+  double w = 0;
+  double z = 0;
+  double pValue = 1;
+};
+
+WilcoxonResult wilcoxonSignedRank(const std::vector<double> &differences);
+
+/**
+ * Percentile bootstrap confidence interval of median(vec), e.g. of paired ratios. Costs O(resamples * vec.size()).
+ */
+ConfidenceInterval bootstrapMedian(const std::vector<double> &vec, double confidence, unsigned resamples,
+                                   uint64_t seed = 0);
+
 }  // namespace utils
 }  // namespace timed
 
@@ -0,0 +1,29 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <string>
+
+#ifndef TIMED_UTILS_UNITS_H_
+#define TIMED_UTILS_UNITS_H_
+
+namespace timed {
+namespace utils {
+
+/**
+ * Format value with a decimal (SI) prefix and unit, e.g. formatSI(1234567, "B/s") -> "1.23 MB/s".
+ * Prefixes: k, M, G, T, P, E (powers of 1000).
+ */
+std::string formatSI(double value, const std::string &unit);
+
+/**
+ * Format value with a binary (IEC) prefix and unit, e.g. formatIEC(1234567, "B/s") -> "1.18 MiB/s".
+ * Prefixes: Ki, Mi, Gi, Ti, Pi, Ei (powers of 1024).
+ */
+std::string formatIEC(double value, const std::string &unit);
+
+}  // namespace utils
+}  // namespace timed
+
+#endif  // TIMED_UTILS_UNITS_H_
@@ -0,0 +1,210 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+// Linked into a program (AllocationTracker object library), this file replaces malloc/free and operator new/delete to
+// maintain thread-local AllocationCounters. The malloc family forwards to glibc's __libc_* entry points, operator
+// new/delete forward to the replaced malloc/free, so every allocation is counted exactly once. Other C libraries are
+// not supported: nothing is replaced and allocationTrackingEnabled() stays false.
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "timed/Allocations.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void __libc_free(void *ptr);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+}
+
+namespace {
+
+// constant initialized and initial-exec: accessing the counters never allocates (no lazy TLS initialization)
+__attribute__((tls_model("initial-exec"))) thread_local timed::AllocationCounters counters;
+
+// _____________________________________________________________________________________________________________________
+inline void recordAllocation(void *ptr, size_t size) {
+  if (!ptr) { return; }
+  ++counters.allocations;
+  counters.bytesAllocated += size;
+  counters.liveBytes += static_cast<int64_t>(malloc_usable_size(ptr));
+  if (counters.liveBytes > counters.peakLiveBytes) { counters.peakLiveBytes = counters.liveBytes; }
+}
+
+// _____________________________________________________________________________________________________________________
+inline void recordDeallocation(void *ptr) {
+  if (!ptr) { return; }
+  ++counters.deallocations;
+  counters.liveBytes -= static_cast<int64_t>(malloc_usable_size(ptr));
+}
+
+// _____________________________________________________________________________________________________________________
+timed::AllocationCounters *threadCounters() {
+  return &counters;
+}
+
+// _____________________________________________________________________________________________________________________
+void *allocate(size_t size) {
+  if (size == 0) { size = 1; }
+  while (true) {
+    void *ptr = malloc(size);
+    if (ptr) { return ptr; }
+    std::new_handler handler = std::get_new_handler();
+    if (!handler) { throw std::bad_alloc(); }
+    handler();
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void *allocateAligned(size_t size, std::align_val_t alignment) {
+  if (size == 0) { size = 1; }
+  while (true) {
+    void *ptr = memalign(static_cast<size_t>(alignment), size);
+    if (ptr) { return ptr; }
+    std::new_handler handler = std::get_new_handler();
+    if (!handler) { throw std::bad_alloc(); }
+    handler();
+  }
+}
+
+struct InstallHook {
+  InstallHook() { timed::detail::threadAllocationCountersHook = &threadCounters; }
+} installHook;
+
+}  // namespace
+
+// ===== malloc ========================================================================================================
+extern "C" {
+
+// _____________________________________________________________________________________________________________________
+void *malloc(size_t size) {
+  void *ptr = __libc_malloc(size);
+  recordAllocation(ptr, size);
+  return ptr;
+}
+
+// _____________________________________________________________________________________________________________________
+void free(void *ptr) {
+  recordDeallocation(ptr);
+  __libc_free(ptr);
+}
+
+// _____________________________________________________________________________________________________________________
+void *calloc(size_t count, size_t size) {
+  void *ptr = __libc_calloc(count, size);
+  recordAllocation(ptr, count * size);
+  return ptr;
+}
+
+// _____________________________________________________________________________________________________________________
+void *realloc(void *ptr, size_t size) {
+  if (!ptr) { return malloc(size); }
+  if (size == 0) {
+    free(ptr);
+    return nullptr;
+  }
+  auto oldSize = static_cast<int64_t>(malloc_usable_size(ptr));
+  void *moved = __libc_realloc(ptr, size);
+  // on failure the old block stays allocated
+  if (!moved) { return nullptr; }
+  ++counters.deallocations;
+  counters.liveBytes -= oldSize;
+  recordAllocation(moved, size);
+  return moved;
+}
+
+// _____________________________________________________________________________________________________________________
+void *memalign(size_t alignment, size_t size) {
+  void *ptr = __libc_memalign(alignment, size);
+  recordAllocation(ptr, size);
+  return ptr;
+}
+
+// _____________________________________________________________________________________________________________________
+void *aligned_alloc(size_t alignment, size_t size) {
+  return memalign(alignment, size);
+}
+
+// _____________________________________________________________________________________________________________________
+int posix_memalign(void **result, size_t alignment, size_t size) {
+  if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) { return EINVAL; }
+  void *ptr = memalign(alignment, size);
+  if (!ptr) { return ENOMEM; }
+  *result = ptr;
+  return 0;
+}
+
+// _____________________________________________________________________________________________________________________
+void *valloc(size_t size) {
+  void *ptr = __libc_valloc(size);
+  recordAllocation(ptr, size);
+  return ptr;
+}
+
+// _____________________________________________________________________________________________________________________
+void *pvalloc(size_t size) {
+  void *ptr = __libc_pvalloc(size);
+  recordAllocation(ptr, size);
+  return ptr;
+}
+
+}  // extern "C"
+
+
+// ===== operator new/delete ===========================================================================================
+void *operator new(size_t size) { return allocate(size); }
+
+void *operator new[](size_t size) { return allocate(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return malloc(size ? size : 1); }
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return malloc(size ? size : 1); }
+
+void *operator new(size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void *operator new[](size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return memalign(static_cast<size_t>(alignment), size ? size : 1);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return memalign(static_cast<size_t>(alignment), size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+
+void operator delete[](void *ptr) noexcept { free(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { free(ptr); }
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { free(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t) noexcept { free(ptr); }
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { free(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { free(ptr); }
+
+#endif  // __GLIBC__
@@ -0,0 +1,34 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include "timed/Allocations.h"
+
+namespace timed {
+
+namespace detail {
+
+AllocationCounters *(*threadAllocationCountersHook)() = nullptr;
+
+}  // namespace detail
+
+// _____________________________________________________________________________________________________________________
+bool allocationTrackingEnabled() {
+  return detail::threadAllocationCountersHook != nullptr;
+}
+
+// _____________________________________________________________________________________________________________________
+AllocationCounters threadAllocationCounters() {
+  if (!detail::threadAllocationCountersHook) { return {}; }
+  return *detail::threadAllocationCountersHook();
+}
+
+// _____________________________________________________________________________________________________________________
+void resetPeakLiveBytes() {
+  if (!detail::threadAllocationCountersHook) { return; }
+  AllocationCounters *counters = detail::threadAllocationCountersHook();
+  counters->peakLiveBytes = counters->liveBytes;
+}
+
+}  // namespace timed
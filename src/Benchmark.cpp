@@ -3,10 +3,22 @@
 //
 // This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
 
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
 
 #include "timed/Benchmark.h"
 #include "timed/utils/Statistics.h"
+#include "timed/utils/Units.h"
 
 namespace timed {
 namespace benchmark {
@@ -21,16 +33,55 @@ std::ostream &operator<<(std::ostream &os, const Config &config) {
 
 
 // ===== Results =======================================================================================================
+// _____________________________________________________________________________________________________________________
+void Result::useHistograms(unsigned significantDigits) {
+  histogramOnly = true;
+  wallHistogram = utils::Histogram(significantDigits);
+  cpuHistogram = utils::Histogram(significantDigits);
+  threadCpuHistogram = utils::Histogram(significantDigits);
+}
+
+// _____________________________________________________________________________________________________________________
+void Result::useSink(std::shared_ptr<SampleSink> sampleSink, unsigned significantDigits) {
+  useHistograms(significantDigits);
+  sink = std::move(sampleSink);
+}
+
+// _____________________________________________________________________________________________________________________
+size_t Result::size() const {
+  return histogramOnly ? wallHistogram.count() : wallTimes.size();
+}
+
 // _____________________________________________________________________________________________________________________
 void Result::addCpuTime(Time time) {
+  if (histogramOnly) {
+    cpuHistogram.record(time - cpuTimeBaseline);
+    if (sink) sink->add(SampleSink::CPU, time);
+    return;
+  }
   cpuTimes.push_back(time);
 }
 
 // _____________________________________________________________________________________________________________________
 void Result::addWallTime(Time time) {
+  if (histogramOnly) {
+    wallHistogram.record(time - wallTimeBaseline);
+    if (sink) sink->add(SampleSink::WALL, time);
+    return;
+  }
   wallTimes.push_back(time);
 }
 
+// _____________________________________________________________________________________________________________________
+void Result::addThreadCpuTime(Time time) {
+  if (histogramOnly) {
+    threadCpuHistogram.record(time - threadCpuTimeBaseline);
+    if (sink) sink->add(SampleSink::THREAD_CPU, time);
+    return;
+  }
+  threadCpuTimes.push_back(time);
+}
+
 // _____________________________________________________________________________________________________________________
 std::vector<Time> Result::adjustedCPUTimes() const {
   std::vector<Time> adjustedTimes(cpuTimes.size());
@@ -53,130 +104,393 @@ std::vector<Time> Result::adjustedWallTimes() const {
   return adjustedTimes;
 }
 
+// _____________________________________________________________________________________________________________________
+std::vector<Time> Result::adjustedThreadCPUTimes() const {
+  std::vector<Time> adjustedTimes(threadCpuTimes.size());
+  Time baseline = threadCpuTimeBaseline;
+  std::transform(threadCpuTimes.begin(),
+                 threadCpuTimes.end(),
+                 adjustedTimes.begin(),
+                 [baseline](Time x) { return x - baseline; });
+  return adjustedTimes;
+}
+
+// _____________________________________________________________________________________________________________________
+Time Result::meanAdjustedWallTime() const {
+  if (histogramOnly) { return wallHistogram.mean(); }
+  if (wallTimes.empty()) { return Time(); }
+  return utils::mean(wallTimes) - wallTimeBaseline;
+}
+
+// _____________________________________________________________________________________________________________________
+double Result::bytesPerSecond() const {
+  Time mean = meanAdjustedWallTime();
+  if (bytesPerIteration == 0 || mean.count() <= 0) { return 0; }
+  return static_cast<double>(bytesPerIteration) * 1e9 / static_cast<double>(mean.count());
+}
+
+// _____________________________________________________________________________________________________________________
+double Result::itemsPerSecond() const {
+  Time mean = meanAdjustedWallTime();
+  if (itemsPerIteration == 0 || mean.count() <= 0) { return 0; }
+  return static_cast<double>(itemsPerIteration) * 1e9 / static_cast<double>(mean.count());
+}
+
+// _____________________________________________________________________________________________________________________
+double Result::perfCounter(PerfEvent event) const {
+  for (const auto &counter: perfCounters) {
+    if (counter.event == event) { return counter.perOp; }
+  }
+  return 0;
+}
+
+// _____________________________________________________________________________________________________________________
+double Result::instructionsPerCycle() const {
+  double cycles = perfCounter(PerfEvent::CYCLES);
+  return cycles > 0 ? perfCounter(PerfEvent::INSTRUCTIONS) / cycles : 0;
+}
+
+// _____________________________________________________________________________________________________________________
+double Result::allocationsPerOp() const {
+  uint64_t operations = size() * batchSize;
+  return operations == 0 ? 0 : static_cast<double>(allocations) / static_cast<double>(operations);
+}
+
+// _____________________________________________________________________________________________________________________
+double Result::allocatedBytesPerOp() const {
+  uint64_t operations = size() * batchSize;
+  return operations == 0 ? 0 : static_cast<double>(allocatedBytes) / static_cast<double>(operations);
+}
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+void printOverhead(std::ostream &os, const Result &result, bool threadCpu) {
+  os << " Overhead: " << result.wallTimeBaseline << " wall, " << result.cpuTimeBaseline << " CPU";
+  if (threadCpu) { os << ", " << result.threadCpuTimeBaseline << " thread CPU"; }
+  os << "\n";
+}
+
+// _____________________________________________________________________________________________________________________
+void printWarnings(std::ostream &os, const Result &result) {
+  for (const auto &warning: result.warnings) {
+    os << " Warning: " << warning << "\n";
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void printAllocations(std::ostream &os, const Result &result) {
+  if (!result.allocationsTracked) { return; }
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::fixed << std::setprecision(2);
+  os << " Allocations:\n";
+  os << "  per op:    " << result.allocationsPerOp() << "\n";
+  os << "  bytes:     " << utils::formatIEC(result.allocatedBytesPerOp(), "B") << " per op\n";
+  os << "  peak live: " << utils::formatIEC(static_cast<double>(result.peakLiveBytes), "B") << "\n";
+  os.flags(flags);
+  os.precision(precision);
+}
+
+// _____________________________________________________________________________________________________________________
+void printPerfCounters(std::ostream &os, const Result &result) {
+  if (!result.perfCountersError.empty()) {
+    os << " Counters: unavailable (" << result.perfCountersError << ")\n";
+  }
+  if (result.perfCounters.empty()) { return; }
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::fixed << std::setprecision(2);
+  os << " Counters (per op):\n";
+  for (const auto &counter: result.perfCounters) {
+    std::string name = std::string(toString(counter.event)) + ":";
+    os << "  " << std::left << std::setw(18) << name << std::right << counter.perOp << "\n";
+  }
+  if (result.instructionsPerCycle() > 0) {
+    os << "  " << std::left << std::setw(18) << "IPC:" << std::right << result.instructionsPerCycle() << "\n";
+  }
+  os.flags(flags);
+  os.precision(precision);
+}
+
+// _____________________________________________________________________________________________________________________
+void printThroughput(std::ostream &os, double bytesPerSecond, double itemsPerSecond) {
+  if (bytesPerSecond <= 0 && itemsPerSecond <= 0) { return; }
+  os << " Throughput:\n";
+  if (itemsPerSecond > 0) {
+    os << "  items:     " << utils::formatSI(itemsPerSecond, "/s") << "\n";
+  }
+  if (bytesPerSecond > 0) {
+    os << "  bytes:     " << utils::formatIEC(bytesPerSecond, "B/s") << " (" << utils::formatSI(bytesPerSecond, "B/s")
+       << ")\n";
+  }
+}
+
+}  // namespace
+
 // _____________________________________________________________________________________________________________________
 std::ostream &operator<<(std::ostream &os, const Result &result) {
-  auto adjustedWallTimes = result.adjustedWallTimes();
-  auto adjustedCPUTimes = result.adjustedCPUTimes();
+  if (result.histogramOnly) {
+    auto printHistogram = [&os](const char *name, const utils::Histogram &histogram) {
+      os << " " << name << ":\n";
+      os << "  min:       " << histogram.min() << "\n";
+      os << "  max:       " << histogram.max() << "\n";
+      os << "  mean:      " << histogram.mean() << "\n";
+      os << "  SD:        " << histogram.stddev() << "\n";
+      os << "  median:    " << histogram.median() << "\n";
+      os << "  p99:       " << histogram.percentile(99) << "\n";
+    };
+    os << "Benchmark: '" << result.title << "'\n";
+    if (!result.info.empty()) {
+      os << "Info: " << result.info << "\n";
+    }
+    printWarnings(os, result);
+    os << " Iterations: " << result.size() << "\n";
+    printOverhead(os, result, !result.threadCpuHistogram.empty());
+    if (!result.warmupWallTimes.empty()) {
+      os << " Warmup: " << result.warmupWallTimes.size() << " discarded, median "
+         << utils::median(result.warmupWallTimes) << "\n";
+    }
+    if (result.batchSize > 1) {
+      os << " Batch size: " << result.batchSize << "\n";
+    }
+    printThroughput(os, result.bytesPerSecond(), result.itemsPerSecond());
+    printPerfCounters(os, result);
+    printAllocations(os, result);
+    printHistogram("WallTime", result.wallHistogram);
+    printHistogram("CPUTime", result.cpuHistogram);
+    if (!result.threadCpuHistogram.empty()) {
+      printHistogram("ThreadCPUTime", result.threadCpuHistogram);
+    }
+    return os;
+  }
+  // one scratch buffer for all columns, baselines are subtracted while loading it
+  utils::Summarizer summarizer;
+  auto toTime = [](double ns) { return Time::fromNanoseconds(std::llround(ns)); };
+  auto printSummary = [&os, &toTime](const char *name, const utils::Summary &summary) {
+    os << " " << name << ":\n";
+    os << "  min:       " << toTime(summary.min) << "\n";
+    os << "  max:       " << toTime(summary.max) << "\n";
+    os << "  mean:      " << toTime(summary.mean) << "\n";
+    os << "  SD:        " << toTime(summary.stddev()) << "\n";
+    os << "  median:    " << toTime(summary.median) << "\n";
+    os << "  p90:       " << toTime(summary.p90) << "\n";
+    os << "  p99:       " << toTime(summary.p99) << "\n";
+    os << "  p99.9:     " << toTime(summary.p999) << "\n";
+    os << "  %err:      " << summary.medianAbsolutePercentError << "\n";
+  };
   os << "Benchmark: '" << result.title << "'\n";
   if (!result.info.empty()) {
     os << "Info: " << result.info << "\n";
   }
+  printWarnings(os, result);
   os << " Iterations: " << result.wallTimes.size() << "\n";
-  os << " WallTime:\n";
-  os << "  min:       " << utils::min(adjustedWallTimes) << "\n";
-  os << "  max:       " << utils::max(adjustedWallTimes) << "\n";
-  os << "  mean:      " << utils::mean(adjustedWallTimes) << "\n";
-  os << "  SD:        " << utils::stddev(adjustedWallTimes) << "\n";
-  os << "  median:    " << utils::median(adjustedWallTimes) << "\n";
-  os << "  %err:      " << utils::medianAbsolutePercentError(adjustedWallTimes) << "\n";
-  os << " CPUTime:\n";
-  os << "  min:       " << utils::min(adjustedCPUTimes) << "\n";
-  os << "  max:       " << utils::max(adjustedCPUTimes) << "\n";
-  os << "  mean:      " << utils::mean(adjustedCPUTimes) << "\n";
-  os << "  SD:        " << utils::stddev(adjustedCPUTimes) << "\n";
-  os << "  median:    " << utils::median(adjustedCPUTimes) << "\n";
-  os << "  %err:      " << utils::medianAbsolutePercentError(adjustedCPUTimes) << "\n";
+  printOverhead(os, result, !result.threadCpuTimes.empty());
+  if (!result.warmupWallTimes.empty()) {
+    os << " Warmup: " << result.warmupWallTimes.size() << " discarded, median "
+       << utils::median(result.warmupWallTimes) << "\n";
+  }
+  if (result.batchSize > 1) {
+    os << " Batch size: " << result.batchSize << "\n";
+  }
+  printThroughput(os, result.bytesPerSecond(), result.itemsPerSecond());
+  printPerfCounters(os, result);
+  printAllocations(os, result);
+  printSummary("WallTime", summarizer.summarize(result.wallTimes, result.wallTimeBaseline));
+  printSummary("CPUTime", summarizer.summarize(result.cpuTimes, result.cpuTimeBaseline));
+  if (!result.threadCpuTimes.empty()) {
+    printSummary("ThreadCPUTime", summarizer.summarize(result.threadCpuTimes, result.threadCpuTimeBaseline));
+  }
+  return os;
+}
+
+
+// ===== ScalingResult =================================================================================================
+// _____________________________________________________________________________________________________________________
+std::ostream &operator<<(std::ostream &os, const ScalingResult &result) {
+  utils::Summarizer summarizer;
+  auto latency = summarizer.summarize(result.latencies.wallTimes, result.latencies.wallTimeBaseline);
+  auto toTime = [](double ns) { return Time::fromNanoseconds(std::llround(ns)); };
+  os << " Threads: " << result.threads << (result.pinned ? " (pinned)" : "") << "\n";
+  os << "  throughput: " << utils::formatSI(result.throughput, "ops/s") << "\n";
+  if (result.latencies.itemsPerIteration > 0) {
+    os << "  items:      "
+       << utils::formatSI(result.throughput * static_cast<double>(result.latencies.itemsPerIteration), "/s")
+       << "\n";
+  }
+  if (result.latencies.bytesPerIteration > 0) {
+    os << "  bytes:      "
+       << utils::formatIEC(result.throughput * static_cast<double>(result.latencies.bytesPerIteration), "B/s") << "\n";
+  }
+  os << "  efficiency: " << result.efficiency << "\n";
+  os << "  latency:    median " << toTime(latency.median) << ", p90 " << toTime(latency.p90) << ", p99 "
+     << toTime(latency.p99) << ", max " << toTime(latency.max) << "\n";
   return os;
 }
 
 
 // ===== Benchmark =====================================================================================================
-// ----- public --------------------------------------------------------------------------------------------------------
+template class BasicBenchmark<std::function<void()>, std::function<void()>>;
+
+namespace detail {
+
+#if !defined(__GNUC__) && !defined(__clang__)
+// _____________________________________________________________________________________________________________________
+void useCharPointer(const volatile char *) {}
+#endif
+
 // _____________________________________________________________________________________________________________________
-Benchmark::Benchmark(std::function<void()> op) {
-  _op = std::move(op);
-  _precedentOp = []() -> void {};
+bool pinCurrentThread(unsigned cpu) {
+#ifdef __linux__
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) { return false; }
+  auto count = static_cast<unsigned>(CPU_COUNT(&allowed));
+  if (count == 0) { return false; }
+  // core ids of a restricted cpuset need not start at 0 or be contiguous, so pick the (cpu % count)-th allowed one
+  unsigned index = cpu % count;
+  for (int id = 0; id < CPU_SETSIZE; ++id) {
+    if (!CPU_ISSET(id, &allowed)) { continue; }
+    if (index-- == 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(id, &set);
+      return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+  }
+  return false;
+#else
+  (void) cpu;
+  return false;
+#endif
 }
 
 // _____________________________________________________________________________________________________________________
-Benchmark::Benchmark(std::function<void()> op, std::function<void()> precedentOp) {
-  _op = std::move(op);
-  _precedentOp = std::move(precedentOp);
+std::vector<unsigned> defaultThreadCounts() {
+  unsigned cores = std::max(std::thread::hardware_concurrency(), 1U);
+  std::vector<unsigned> counts;
+  for (unsigned threads = 1; threads < cores; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(cores);
+  return counts;
 }
 
 // _____________________________________________________________________________________________________________________
-Benchmark::Benchmark(Config &config, std::function<void()> op) {
-  _op = std::move(op);
-  _config = config;
-  _result.title = _config.title;
-  _result.info = _config.info;
+std::unique_ptr<PerfCounterTimer> openPerfCounters(const Config &config, Result &result) {
+  result.perfCountersError.clear();
+  if (!config.perfCounters) { return nullptr; }
+  auto perfCounters = std::make_unique<PerfCounterTimer>(config.perfEvents);
+  if (!perfCounters->available()) {
+    result.perfCountersError = perfCounters->error();
+    return nullptr;
+  }
+  return perfCounters;
 }
 
 // _____________________________________________________________________________________________________________________
-Benchmark::Benchmark(Config &config, std::function<void()> op, std::function<void()> precedentOp) {
-  _op = std::move(op);
-  _precedentOp = std::move(precedentOp);
-  _config = config;
-  _result.title = _config.title;
-  _result.info = _config.info;
+void setPerfCounters(const PerfCounterTimer &perfCounters, uint64_t operations, Result &result) {
+  result.perfCounters.clear();
+  if (operations == 0) { return; }
+  const auto &counts = perfCounters.getCounts();
+  for (size_t i = 0; i < counts.size(); ++i) {
+    result.perfCounters.push_back({perfCounters.events()[i], counts[i] / static_cast<double>(operations)});
+  }
 }
 
+// ===== ScopedEnvironment =============================================================================================
 // _____________________________________________________________________________________________________________________
-Result &Benchmark::run(bool verbose) {
-  setTimerBaselines();
-  WallTimer wallTimer;
-  CPUTimer cpuTimer;
-  for (unsigned i = 0; i < _config.iterations; ++i) {
-    _precedentOp();
-    if (verbose) std::cout << '\r' << i << "/" << _config.iterations << std::flush;
-    wallTimer.start();
-    cpuTimer.start();
-    _op();
-    cpuTimer.stop();
-    wallTimer.stop();
-    _result.addWallTime(wallTimer.getTime());
-    _result.addCpuTime(cpuTimer.getTime());
+ScopedEnvironment::ScopedEnvironment(const Config &config, Result &result) {
+  result.machine = machineContext();
+  result.warnings = environmentWarnings(result.machine);
+#ifdef __linux__
+  if (config.pinCpu >= 0) {
+    cpu_set_t previous;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) == 0 &&
+        pinCurrentThread(static_cast<unsigned>(config.pinCpu))) {
+      _affinity.resize(sizeof(previous));
+      std::memcpy(_affinity.data(), &previous, sizeof(previous));
+    } else {
+      result.warnings.push_back("cannot pin to CPU " + std::to_string(config.pinCpu));
+    }
+  }
+  if (config.realtimePriority > 0) {
+    sched_param param{};
+    if (pthread_getschedparam(pthread_self(), &_policy, &param) == 0) {
+      _priority = param.sched_priority;
+      sched_param realtime{};
+      realtime.sched_priority = config.realtimePriority;
+      int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &realtime);
+      if (error == 0) {
+        _realtime = true;
+      } else {
+        result.warnings.push_back("cannot use SCHED_FIFO priority " + std::to_string(config.realtimePriority) + ": " +
+                                  std::strerror(error));
+      }
+    }
   }
-  if (verbose) std::cout << '\r' << "✅              " << std::endl;
-  _run = true;
-  return _result;
+  if (config.lockMemory) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+      _lockedMemory = true;
+    } else {
+      result.warnings.push_back(std::string("cannot lock memory: ") + std::strerror(errno));
+    }
+  }
+#else
+  if (config.pinCpu >= 0 || config.realtimePriority > 0 || config.lockMemory) {
+    result.warnings.emplace_back("CPU pinning, real-time priority and memory locking are only supported on Linux");
+  }
+#endif
 }
 
 // _____________________________________________________________________________________________________________________
-Result &Benchmark::getResult() {
-  return _result;
+ScopedEnvironment::~ScopedEnvironment() {
+#ifdef __linux__
+  if (_lockedMemory) { munlockall(); }
+  if (_realtime) {
+    sched_param param{};
+    param.sched_priority = _priority;
+    pthread_setschedparam(pthread_self(), _policy, &param);
+  }
+  if (!_affinity.empty()) {
+    cpu_set_t previous;
+    std::memcpy(&previous, _affinity.data(), sizeof(previous));
+    pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+  }
+#endif
 }
 
+
+// ===== AllocationProbe ===============================================================================================
 // _____________________________________________________________________________________________________________________
-const Result &Benchmark::getResult() const {
-  return _result;
+bool AllocationProbe::enabled() const {
+  return _enabled;
 }
 
 // _____________________________________________________________________________________________________________________
-const Config &Benchmark::getConfig() const {
-  return _config;
+void AllocationProbe::start() {
+  resetPeakLiveBytes();
+  _start = threadAllocationCounters();
 }
 
-// ----- private -------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-void Benchmark::setTimerBaselines() {
-  WallTimer wallTimer;
-  CPUTimer cpuTimer;
-  Result baselineResults;
-  auto dummyOperation = [&]() -> void { return; };
-  for (int i = 0; i < 500; ++i) {
-    wallTimer.start();
-    cpuTimer.start();
-    dummyOperation();
-    cpuTimer.stop();
-    wallTimer.stop();
-    baselineResults.addWallTime(wallTimer.getTime());
-    baselineResults.addCpuTime(cpuTimer.getTime());
-  }
-  _result.wallTimeBaseline = utils::mean(baselineResults.wallTimes);
-  _result.cpuTimeBaseline = utils::mean(baselineResults.cpuTimes);
+void AllocationProbe::stop() {
+  AllocationCounters now = threadAllocationCounters();
+  _allocations += now.allocations - _start.allocations;
+  _bytes += now.bytesAllocated - _start.bytesAllocated;
+  _peakLiveBytes = std::max(_peakLiveBytes, now.peakLiveBytes - _start.liveBytes);
 }
 
 // _____________________________________________________________________________________________________________________
-std::ostream &operator<<(std::ostream &os, const Benchmark &benchmark) {
-  if (benchmark._run) {
-    os << benchmark._result;
-  } else {
-    os << benchmark._config;
-  }
-  return os;
+void AllocationProbe::store(Result &result) const {
+  // samples accumulate over several run() calls, so do the allocations (allocationsPerOp() divides by all samples)
+  result.allocationsTracked = _enabled;
+  result.allocations += _allocations;
+  result.allocatedBytes += _bytes;
+  result.peakLiveBytes = std::max(result.peakLiveBytes, _peakLiveBytes);
 }
 
+}  // namespace detail
+
 
 // ===== timed =========================================================================================================
 // _____________________________________________________________________________________________________________________
@@ -0,0 +1,11 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include "timed/Registry.h"
+
+// main() of the timed_main library: link it and register benchmarks with TIMED_BENCHMARK
+int main(int argc, char **argv) {
+  return timed::benchmark::runMain(argc, argv);
+}
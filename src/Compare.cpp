@@ -0,0 +1,180 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "timed/Compare.h"
+#include "timed/Export.h"
+#include "timed/utils/Statistics.h"
+
+namespace timed {
+namespace benchmark {
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+bool hasSamples(const Result &result) {
+  return !result.histogramOnly && !result.wallTimes.empty();
+}
+
+// _____________________________________________________________________________________________________________________
+// baseline adjusted wall times in nanoseconds, clamped at zero like the printed statistics
+std::vector<double> adjustedNanoseconds(const Result &result) {
+  if (!hasSamples(result)) {
+    throw std::runtime_error("compare: '" + result.title + "' has no raw samples");
+  }
+  std::vector<double> ret(result.wallTimes.size());
+  int64_t baseline = result.wallTimeBaseline.count();
+  std::transform(result.wallTimes.begin(), result.wallTimes.end(), ret.begin(), [baseline](Time x) {
+    return static_cast<double>(std::max<int64_t>(x.count() - baseline, 0));
+  });
+  return ret;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+const char *toString(Verdict verdict) {
+  switch (verdict) {
+    case Verdict::FASTER: return "faster";
+    case Verdict::SLOWER: return "slower";
+    case Verdict::UNCHANGED: return "unchanged";
+  }
+  return "unknown";
+}
+
+// _____________________________________________________________________________________________________________________
+std::ostream &operator<<(std::ostream &os, const Comparison &comparison) {
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+  os << "Comparison: '" << comparison.title << "': " << toString(comparison.verdict) << "\n";
+  os << "  median:    " << comparison.baselineMedian << " -> " << comparison.contenderMedian << "\n";
+  os << "  ratio:     " << comparison.ratio << " [" << comparison.ratioLow << ", " << comparison.ratioHigh << "]\n";
+  os << std::defaultfloat << std::setprecision(3);
+  os << "  p-value:   " << comparison.pValue << " (" << comparison.baselineSamples << " vs. "
+     << comparison.contenderSamples << " samples)\n";
+  os.flags(flags);
+  os.precision(precision);
+  return os;
+}
+
+// _____________________________________________________________________________________________________________________
+Comparison compare(const Result &baseline, const Result &contender, const CompareOptions &options) {
+  auto a = adjustedNanoseconds(baseline);
+  auto b = adjustedNanoseconds(contender);
+  Comparison comparison;
+  comparison.title = contender.title;
+  comparison.baselineSamples = a.size();
+  comparison.contenderSamples = b.size();
+  double medianA = utils::median(a);
+  double medianB = utils::median(b);
+  comparison.baselineMedian = Time::fromNanoseconds(std::llround(medianA));
+  comparison.contenderMedian = Time::fromNanoseconds(std::llround(medianB));
+  if (medianA > 0) {
+    comparison.ratio = medianB / medianA;
+  } else {
+    comparison.ratio = medianB > 0 ? INFINITY : 1;
+  }
+  auto interval = utils::bootstrapMedianRatio(a, b, options.confidence, options.bootstrapResamples, options.seed);
+  if (interval.high > 0) {
+    comparison.ratioLow = interval.low;
+    comparison.ratioHigh = interval.high;
+  } else {
+    comparison.ratioLow = comparison.ratioHigh = comparison.ratio;
+  }
+  comparison.pValue = utils::mannWhitneyU(a, b).pValue;
+  if (comparison.pValue < options.alpha) {
+    if (comparison.ratio > 1 + options.threshold) {
+      comparison.verdict = Verdict::SLOWER;
+    } else if (comparison.ratio < 1 - options.threshold) {
+      comparison.verdict = Verdict::FASTER;
+    }
+  }
+  return comparison;
+}
+
+// _____________________________________________________________________________________________________________________
+Comparison comparePaired(const Result &baseline, const Result &contender, const CompareOptions &options) {
+  auto a = adjustedNanoseconds(baseline);
+  auto b = adjustedNanoseconds(contender);
+  if (a.size() != b.size()) {
+    throw std::runtime_error("comparePaired: '" + baseline.title + "' and '" + contender.title +
+                             "' have different sample counts");
+  }
+  Comparison comparison;
+  comparison.title = contender.title;
+  comparison.baselineSamples = a.size();
+  comparison.contenderSamples = b.size();
+  comparison.baselineMedian = Time::fromNanoseconds(std::llround(utils::median(a)));
+  comparison.contenderMedian = Time::fromNanoseconds(std::llround(utils::median(b)));
+  std::vector<double> ratios;
+  std::vector<double> differences(a.size());
+  ratios.reserve(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    // rounds in which the baseline was below the timer overhead have no ratio
+    if (a[i] > 0) { ratios.push_back(b[i] / a[i]); }
+    differences[i] = b[i] - a[i];
+  }
+  if (!ratios.empty()) {
+    comparison.ratio = utils::median(ratios);
+    auto interval = utils::bootstrapMedian(ratios, options.confidence, options.bootstrapResamples, options.seed);
+    comparison.ratioLow = interval.low;
+    comparison.ratioHigh = interval.high;
+  }
+  comparison.pValue = utils::wilcoxonSignedRank(differences).pValue;
+  if (comparison.pValue < options.alpha) {
+    if (comparison.ratio > 1 + options.threshold) {
+      comparison.verdict = Verdict::SLOWER;
+    } else if (comparison.ratio < 1 - options.threshold) {
+      comparison.verdict = Verdict::FASTER;
+    }
+  }
+  return comparison;
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<Comparison> compare(const std::vector<Result> &baseline, const std::vector<Result> &contender,
+                                const CompareOptions &options) {
+  std::unordered_map<std::string, const Result *> byTitle;
+  for (const auto &result: baseline) {
+    byTitle.emplace(result.title, &result);
+  }
+  std::vector<Comparison> comparisons;
+  for (const auto &result: contender) {
+    auto it = byTitle.find(result.title);
+    if (it == byTitle.end()) { continue; }
+    if (!hasSamples(*it->second) || !hasSamples(result)) { continue; }
+    comparisons.push_back(compare(*it->second, result, options));
+  }
+  return comparisons;
+}
+
+// _____________________________________________________________________________________________________________________
+bool hasRegression(const std::vector<Comparison> &comparisons) {
+  return std::any_of(comparisons.begin(), comparisons.end(),
+                     [](const Comparison &comparison) { return comparison.verdict == Verdict::SLOWER; });
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<Result> loadBaseline(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("cannot open baseline '" + path + "'");
+  }
+  std::vector<Result> results;
+  while (file.peek() != std::char_traits<char>::eof()) {
+    results.push_back(readSamples(file));
+  }
+  return results;
+}
+
+}  // namespace benchmark
+}  // namespace timed
@@ -0,0 +1,124 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <stdexcept>
+
+#include "timed/ConcurrentRecorder.h"
+
+namespace timed {
+
+namespace {
+
+// recorder ids are never reused, so stale thread local cache entries of destroyed recorders never match
+std::atomic<uint64_t> nextRecorderId{1};
+
+}  // namespace
+
+namespace detail {
+
+// ===== SampleBuffer ==================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+SampleBuffer::SampleBuffer() {
+  _tail = new SampleBlock;
+  _head = _tail;
+}
+
+// _____________________________________________________________________________________________________________________
+SampleBuffer::~SampleBuffer() {
+  SampleBlock *block = _head;
+  while (block != nullptr) {
+    SampleBlock *next = block->next.load(std::memory_order_relaxed);
+    delete block;
+    block = next;
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+size_t SampleBuffer::drain(benchmark::Result &result) {
+  size_t drained = 0;
+  while (true) {
+    size_t count = _head->count.load(std::memory_order_acquire);
+    for (; _headIndex < count; ++_headIndex) {
+      const Sample &sample = _head->samples[_headIndex];
+      result.addWallTime(sample.wall);
+      if (sample.cpu.count() >= 0) {
+        result.addCpuTime(sample.cpu);
+      }
+      ++drained;
+    }
+    if (_headIndex < SampleBlock::CAPACITY) { break; }
+    // the producer links the next block only after it filled this one and never touches this block again
+    SampleBlock *next = _head->next.load(std::memory_order_acquire);
+    if (next == nullptr) { break; }
+    delete _head;
+    _head = next;
+    _headIndex = 0;
+  }
+  return drained;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void SampleBuffer::grow() {
+  auto *block = new SampleBlock;
+  _tail->next.store(block, std::memory_order_release);
+  _tail = block;
+  _tailCount = 0;
+}
+
+}  // namespace detail
+
+// ===== ConcurrentRecorder ============================================================================================
+thread_local detail::ThreadBufferCache ConcurrentRecorder::_cache;
+
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+ConcurrentRecorder::ConcurrentRecorder() : _id(nextRecorderId.fetch_add(1, std::memory_order_relaxed)) {}
+
+// _____________________________________________________________________________________________________________________
+ConcurrentRecorder::~ConcurrentRecorder() = default;
+
+// _____________________________________________________________________________________________________________________
+size_t ConcurrentRecorder::collect(benchmark::Result &result) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  size_t collected = 0;
+  for (auto &buffer: _buffers) {
+    collected += buffer->drain(result);
+  }
+  return collected;
+}
+
+// _____________________________________________________________________________________________________________________
+size_t ConcurrentRecorder::threadCount() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _buffers.size();
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void ConcurrentRecorder::setMode(Mode mode) {
+  int expected = UNSET;
+  if (_mode.compare_exchange_strong(expected, mode, std::memory_order_relaxed) || expected == mode) { return; }
+  throw std::runtime_error("ConcurrentRecorder: record(Time) and record(Time, Time) cannot be mixed, the CPU times "
+                           "would no longer belong to the wall times");
+}
+
+// _____________________________________________________________________________________________________________________
+detail::SampleBuffer &ConcurrentRecorder::registerThread() {
+  // the only per thread state is the one entry cache, the thread to buffer map belongs to (and dies with) the recorder.
+  // A thread recording into several recorders alternately pays for this lookup on every switch, not for a new buffer.
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto &buffer = _threadBuffers[std::this_thread::get_id()];
+  if (buffer == nullptr) {
+    _buffers.push_back(std::make_unique<detail::SampleBuffer>());
+    buffer = _buffers.back().get();
+  }
+  _cache.recorderId = _id;
+  _cache.buffer = buffer;
+  return *buffer;
+}
+
+}  // namespace timed
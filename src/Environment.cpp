@@ -0,0 +1,124 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/utsname.h>
+#endif
+
+#include "timed/Environment.h"
+
+namespace timed {
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+// first line of path without trailing whitespace, empty if it cannot be read
+std::string readLine(const char *path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) { line.pop_back(); }
+  return line;
+}
+
+// _____________________________________________________________________________________________________________________
+std::string readCpuModel() {
+  std::ifstream file("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(file, line)) {
+    // x86: "model name", ARM: "Processor" or "CPU part" only, so fall back to "Hardware"
+    if (line.rfind("model name", 0) == 0 || line.rfind("Hardware", 0) == 0) {
+      size_t colon = line.find(':');
+      if (colon == std::string::npos) { continue; }
+      size_t begin = line.find_first_not_of(" \t", colon + 1);
+      return begin == std::string::npos ? "" : line.substr(begin);
+    }
+  }
+  return "";
+}
+
+// _____________________________________________________________________________________________________________________
+std::string readKernel() {
+#if defined(__unix__) || defined(__APPLE__)
+  utsname name{};
+  if (uname(&name) == 0) {
+    return std::string(name.sysname) + " " + name.release;
+  }
+#endif
+  return "";
+}
+
+// _____________________________________________________________________________________________________________________
+int readTurbo() {
+  // intel_pstate: no_turbo, acpi-cpufreq and amd-pstate: boost
+  std::string noTurbo = readLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+  if (!noTurbo.empty()) { return noTurbo == "0" ? 1 : 0; }
+  std::string boost = readLine("/sys/devices/system/cpu/cpufreq/boost");
+  if (!boost.empty()) { return boost == "1" ? 1 : 0; }
+  return -1;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+std::ostream &operator<<(std::ostream &os, const MachineContext &context) {
+  os << (context.cpuModel.empty() ? "unknown CPU" : context.cpuModel) << ", " << context.cores << " cores";
+  if (!context.governor.empty()) { os << ", governor " << context.governor; }
+  if (context.turbo >= 0) { os << ", turbo " << (context.turbo ? "on" : "off"); }
+  if (!context.kernel.empty()) { os << ", " << context.kernel; }
+  if (context.loadAverage[0] >= 0) {
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::fixed << std::setprecision(2) << ", load " << context.loadAverage[0] << " " << context.loadAverage[1]
+       << " " << context.loadAverage[2];
+    os.flags(flags);
+    os.precision(precision);
+  }
+  return os;
+}
+
+// _____________________________________________________________________________________________________________________
+MachineContext machineContext() {
+  static const std::string cpuModel = readCpuModel();
+  static const std::string kernel = readKernel();
+  MachineContext context;
+  context.cpuModel = cpuModel;
+  context.cores = std::thread::hardware_concurrency();
+  context.kernel = kernel;
+  context.governor = readLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+  context.turbo = readTurbo();
+  std::istringstream load(readLine("/proc/loadavg"));
+  std::array<double, 3> loadAverage{};
+  if (load >> loadAverage[0] >> loadAverage[1] >> loadAverage[2]) {
+    context.loadAverage = loadAverage;
+  }
+  return context;
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<std::string> environmentWarnings(const MachineContext &context) {
+  std::vector<std::string> warnings;
+  if (!context.governor.empty() && context.governor != "performance") {
+    warnings.push_back("CPU scaling governor is '" + context.governor + "', use 'performance' for stable timings");
+  }
+  if (context.turbo == 1) {
+    warnings.push_back("turbo boost is enabled, clock frequency depends on temperature and load");
+  }
+  if (context.cores > 0 && context.loadAverage[0] > context.cores) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2) << "load average " << context.loadAverage[0] << " exceeds "
+       << context.cores << " cores";
+    warnings.push_back(ss.str());
+  }
+  return warnings;
+}
+
+}  // namespace timed
@@ -0,0 +1,625 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "timed/Export.h"
+#include "timed/utils/Statistics.h"
+
+namespace timed {
+namespace benchmark {
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'I', 'M', 'E', 'D', 'S', 'M', 'P'};
+constexpr uint64_t VERSION = 1;
+constexpr char RESULT_MAGIC[8] = {'T', 'I', 'M', 'E', 'D', 'R', 'E', 'S'};
+constexpr uint64_t RESULT_VERSION = 1;
+
+// _____________________________________________________________________________________________________________________
+std::string jsonNumber(double value) {
+  if (!std::isfinite(value)) { return "null"; }
+  std::ostringstream ss;
+  ss.precision(std::numeric_limits<double>::max_digits10);
+  ss << value;
+  return ss.str();
+}
+
+// _____________________________________________________________________________________________________________________
+int64_t ns(double value) {
+  return std::llround(value);
+}
+
+// _____________________________________________________________________________________________________________________
+void writeJsonSummary(std::ostream &os, const utils::Summary &summary) {
+  os << "{\"min\": " << ns(summary.min) << ", \"max\": " << ns(summary.max) << ", \"mean\": " << ns(summary.mean)
+     << ", \"stddev\": " << ns(summary.stddev()) << ", \"median\": " << ns(summary.median)
+     << ", \"p90\": " << ns(summary.p90) << ", \"p99\": " << ns(summary.p99) << ", \"p999\": " << ns(summary.p999)
+     << ", \"median_abs_percent_error\": " << jsonNumber(summary.medianAbsolutePercentError) << "}";
+}
+
+// _____________________________________________________________________________________________________________________
+void writeJsonSummary(std::ostream &os, const utils::Histogram &histogram) {
+  os << "{\"min\": " << histogram.min().count() << ", \"max\": " << histogram.max().count()
+     << ", \"mean\": " << histogram.mean().count() << ", \"stddev\": " << histogram.stddev().count()
+     << ", \"median\": " << histogram.median().count() << ", \"p90\": " << histogram.percentile(90).count()
+     << ", \"p99\": " << histogram.percentile(99).count() << ", \"p999\": " << histogram.percentile(99.9).count()
+     << "}";
+}
+
+// _____________________________________________________________________________________________________________________
+void putVarint(std::string &buffer, uint64_t value) {
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<char>(value));
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+// _____________________________________________________________________________________________________________________
+int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// _____________________________________________________________________________________________________________________
+void readVarint(std::istream &is, uint64_t &value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    int c = is.get();
+    if (c == std::char_traits<char>::eof()) {
+      throw std::runtime_error("SampleReader: unexpected end of stream");
+    }
+    value |= static_cast<uint64_t>(c & 0x7F) << shift;
+    if ((c & 0x80) == 0) { return; }
+  }
+  throw std::runtime_error("SampleReader: invalid varint");
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t decodeVarint(const std::string &buffer, size_t &position) {
+  uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64 && position < buffer.size(); shift += 7) {
+    auto c = static_cast<unsigned char>(buffer[position++]);
+    value |= static_cast<uint64_t>(c & 0x7F) << shift;
+    if ((c & 0x80) == 0) { return value; }
+  }
+  throw std::runtime_error("SampleReader: corrupt block");
+}
+
+// _____________________________________________________________________________________________________________________
+void putString(std::string &buffer, const std::string &s) {
+  putVarint(buffer, s.size());
+  buffer += s;
+}
+
+// _____________________________________________________________________________________________________________________
+// bit pattern of value
+void putDouble(std::string &buffer, double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  putVarint(buffer, bits);
+}
+
+// _____________________________________________________________________________________________________________________
+double readDouble(std::istream &is) {
+  uint64_t bits;
+  readVarint(is, bits);
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// _____________________________________________________________________________________________________________________
+int64_t readZigzag(std::istream &is) {
+  uint64_t value;
+  readVarint(is, value);
+  return unzigzag(value);
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t readCount(std::istream &is) {
+  uint64_t count;
+  readVarint(is, count);
+  if (count > (1 << 28)) { throw std::runtime_error("readResult: invalid count"); }
+  return count;
+}
+
+// _____________________________________________________________________________________________________________________
+std::string readString(std::istream &is) {
+  uint64_t length;
+  readVarint(is, length);
+  if (length > (1 << 20)) { throw std::runtime_error("SampleReader: invalid header"); }
+  std::string ret(length, '\0');
+  if (!is.read(&ret[0], static_cast<std::streamsize>(length))) {
+    throw std::runtime_error("SampleReader: unexpected end of stream");
+  }
+  return ret;
+}
+
+}  // namespace
+
+// ===== JSON ==========================================================================================================
+// _____________________________________________________________________________________________________________________
+std::string jsonString(const std::string &s) {
+  std::string ret = "\"";
+  for (char c: s) {
+    switch (c) {
+      case '"': ret += "\\\""; break;
+      case '\\': ret += "\\\\"; break;
+      case '\n': ret += "\\n"; break;
+      case '\r': ret += "\\r"; break;
+      case '\t': ret += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+          ret += escaped;
+        } else {
+          ret += c;
+        }
+    }
+  }
+  ret += "\"";
+  return ret;
+}
+
+// _____________________________________________________________________________________________________________________
+void writeJson(std::ostream &os, const Result &result) {
+  os << "{\"type\": \"result\", \"name\": " << jsonString(result.title) << ", \"info\": " << jsonString(result.info)
+     << ", \"samples\": " << result.size() << ", \"batch_size\": " << result.batchSize
+     << ", \"warmup_samples\": " << result.warmupWallTimes.size()
+     << ", \"histogram\": " << (result.histogramOnly ? "true" : "false")
+     << ", \"overhead_ns\": {\"wall\": " << result.wallTimeBaseline.count()
+     << ", \"cpu\": " << result.cpuTimeBaseline.count()
+     << ", \"thread_cpu\": " << result.threadCpuTimeBaseline.count() << "}"
+     << ", \"bytes_per_iteration\": " << result.bytesPerIteration
+     << ", \"items_per_iteration\": " << result.itemsPerIteration
+     << ", \"bytes_per_second\": " << jsonNumber(result.bytesPerSecond())
+     << ", \"items_per_second\": " << jsonNumber(result.itemsPerSecond());
+  if (!result.perfCounters.empty()) {
+    os << ", \"counters_per_op\": {";
+    for (size_t i = 0; i < result.perfCounters.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << jsonString(toString(result.perfCounters[i].event)) << ": "
+         << jsonNumber(result.perfCounters[i].perOp);
+    }
+    os << "}";
+  }
+  if (!result.perfCountersError.empty()) {
+    os << ", \"counters_error\": " << jsonString(result.perfCountersError);
+  }
+  if (result.allocationsTracked) {
+    os << ", \"allocations\": {\"per_op\": " << jsonNumber(result.allocationsPerOp())
+       << ", \"bytes_per_op\": " << jsonNumber(result.allocatedBytesPerOp())
+       << ", \"peak_live_bytes\": " << result.peakLiveBytes << "}";
+  }
+  if (result.machine.cores > 0) {
+    const auto &machine = result.machine;
+    os << ", \"machine\": {\"cpu_model\": " << jsonString(machine.cpuModel) << ", \"cores\": " << machine.cores
+       << ", \"governor\": " << jsonString(machine.governor)
+       << ", \"turbo\": " << (machine.turbo < 0 ? "null" : (machine.turbo ? "true" : "false"))
+       << ", \"kernel\": " << jsonString(machine.kernel) << ", \"load_average\": ";
+    if (machine.loadAverage[0] < 0) {
+      os << "null";
+    } else {
+      os << "[" << jsonNumber(machine.loadAverage[0]) << ", " << jsonNumber(machine.loadAverage[1]) << ", "
+         << jsonNumber(machine.loadAverage[2]) << "]";
+    }
+    os << "}";
+  }
+  if (!result.warnings.empty()) {
+    os << ", \"warnings\": [";
+    for (size_t i = 0; i < result.warnings.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << jsonString(result.warnings[i]);
+    }
+    os << "]";
+  }
+  if (result.histogramOnly) {
+    os << ", \"wall_time_ns\": ";
+    writeJsonSummary(os, result.wallHistogram);
+    os << ", \"cpu_time_ns\": ";
+    writeJsonSummary(os, result.cpuHistogram);
+    if (!result.threadCpuHistogram.empty()) {
+      os << ", \"thread_cpu_time_ns\": ";
+      writeJsonSummary(os, result.threadCpuHistogram);
+    }
+  } else {
+    utils::Summarizer summarizer;
+    os << ", \"wall_time_ns\": ";
+    writeJsonSummary(os, summarizer.summarize(result.wallTimes, result.wallTimeBaseline));
+    os << ", \"cpu_time_ns\": ";
+    writeJsonSummary(os, summarizer.summarize(result.cpuTimes, result.cpuTimeBaseline));
+    if (!result.threadCpuTimes.empty()) {
+      os << ", \"thread_cpu_time_ns\": ";
+      writeJsonSummary(os, summarizer.summarize(result.threadCpuTimes, result.threadCpuTimeBaseline));
+    }
+  }
+  os << "}";
+}
+
+// _____________________________________________________________________________________________________________________
+void writeJson(std::ostream &os, const ScalingResult &result) {
+  utils::Summarizer summarizer;
+  os << "{\"type\": \"scaling\", \"name\": " << jsonString(result.latencies.title) << ", \"threads\": " << result.threads
+     << ", \"operations\": " << result.operations << ", \"wall_time_ns\": " << result.wallTime.count()
+     << ", \"throughput\": " << jsonNumber(result.throughput) << ", \"efficiency\": " << jsonNumber(result.efficiency)
+     << ", \"pinned\": " << (result.pinned ? "true" : "false") << ", \"latency_ns\": ";
+  writeJsonSummary(os, summarizer.summarize(result.latencies.wallTimes, result.latencies.wallTimeBaseline));
+  os << "}";
+}
+
+// _____________________________________________________________________________________________________________________
+void writeJson(std::ostream &os, const std::string &name, const utils::ComplexityFit &fit) {
+  os << "{\"type\": \"complexity\", \"name\": " << jsonString(name)
+     << ", \"complexity\": " << jsonString(utils::toString(fit.complexity))
+     << ", \"coefficient_ns\": " << jsonNumber(fit.coefficient) << ", \"rms_ns\": " << jsonNumber(fit.rms)
+     << ", \"relative_rms\": " << jsonNumber(fit.relativeRms) << "}";
+}
+
+
+// ===== CSV ===========================================================================================================
+// _____________________________________________________________________________________________________________________
+void writeCsvHeader(std::ostream &os) {
+  os << "benchmark,sample,wall_ns,cpu_ns,thread_cpu_ns\n";
+}
+
+// _____________________________________________________________________________________________________________________
+void writeCsv(std::ostream &os, const Result &result) {
+  // quote the name, double quotes are escaped by doubling them
+  std::string name = "\"";
+  for (char c: result.title) {
+    name += c;
+    if (c == '"') { name += '"'; }
+  }
+  name += "\"";
+  for (size_t i = 0; i < result.wallTimes.size(); ++i) {
+    os << name << ',' << i << ',' << result.wallTimes[i].count() << ',';
+    if (i < result.cpuTimes.size()) { os << result.cpuTimes[i].count(); }
+    os << ',';
+    if (i < result.threadCpuTimes.size()) { os << result.threadCpuTimes[i].count(); }
+    os << '\n';
+  }
+}
+
+
+// ===== SampleWriter ==================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+SampleWriter::SampleWriter(std::ostream &os, const std::string &title, const std::vector<std::string> &columns,
+                           const std::vector<Time> &baselines, uint64_t batchSize, size_t blockSize)
+    : _os(os), _blockSize(std::min(std::max<size_t>(blockSize, 1), MAX_BLOCK_SIZE)), _columns(columns.size()) {
+  if (columns.empty() || columns.size() != baselines.size()) {
+    throw std::runtime_error("SampleWriter: need one baseline per column and at least one column");
+  }
+  std::string header(MAGIC, sizeof(MAGIC));
+  putVarint(header, VERSION);
+  putVarint(header, title.size());
+  header += title;
+  putVarint(header, batchSize);
+  putVarint(header, columns.size());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    putVarint(header, columns[i].size());
+    header += columns[i];
+    putVarint(header, zigzag(baselines[i].count()));
+  }
+  _os.write(header.data(), static_cast<std::streamsize>(header.size()));
+  for (auto &column: _columns) { column.reserve(_blockSize); }
+}
+
+// _____________________________________________________________________________________________________________________
+SampleWriter::~SampleWriter() {
+  try {
+    finish();
+  } catch (...) {}
+}
+
+// _____________________________________________________________________________________________________________________
+void SampleWriter::add(const Time *row) {
+  if (_finished) { throw std::runtime_error("SampleWriter: add() after finish()"); }
+  for (size_t i = 0; i < _columns.size(); ++i) {
+    _columns[i].push_back(row[i]);
+  }
+  if (_columns[0].size() == _blockSize) { _flush(); }
+}
+
+// _____________________________________________________________________________________________________________________
+void SampleWriter::add(const std::vector<Time> &row) {
+  if (row.size() != _columns.size()) {
+    throw std::runtime_error("SampleWriter: expected " + std::to_string(_columns.size()) + " values, got " +
+                             std::to_string(row.size()));
+  }
+  add(row.data());
+}
+
+// _____________________________________________________________________________________________________________________
+void SampleWriter::finish() {
+  if (_finished) { return; }
+  _finished = true;
+  _flush();
+  _os.put(0);
+  _os.flush();
+  if (!_os) { throw std::runtime_error("SampleWriter: writing failed"); }
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void SampleWriter::_flush() {
+  size_t rows = _columns[0].size();
+  if (rows == 0) { return; }
+  _buffer.clear();
+  for (auto &column: _columns) {
+    int64_t previous = 0;
+    for (Time value: column) {
+      putVarint(_buffer, zigzag(value.count() - previous));
+      previous = value.count();
+    }
+    column.clear();
+  }
+  std::string prefix;
+  putVarint(prefix, rows);
+  putVarint(prefix, _buffer.size());
+  _os.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+  _os.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+}
+
+
+// ===== SampleReader ==================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+SampleReader::SampleReader(std::istream &is) : _is(is) {
+  char magic[sizeof(MAGIC)];
+  if (!_is.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+    throw std::runtime_error("SampleReader: not a timed sample stream");
+  }
+  uint64_t version;
+  readVarint(_is, version);
+  if (version != VERSION) {
+    throw std::runtime_error("SampleReader: unsupported version " + std::to_string(version));
+  }
+  _title = readString(_is);
+  readVarint(_is, _batchSize);
+  uint64_t columns;
+  readVarint(_is, columns);
+  if (columns == 0 || columns > 1024) { throw std::runtime_error("SampleReader: invalid header"); }
+  for (uint64_t i = 0; i < columns; ++i) {
+    _columnNames.push_back(readString(_is));
+    uint64_t baseline;
+    readVarint(_is, baseline);
+    _baselines.push_back(Time::fromNanoseconds(unzigzag(baseline)));
+  }
+  _block.resize(columns);
+}
+
+// _____________________________________________________________________________________________________________________
+const std::string &SampleReader::title() const {
+  return _title;
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t SampleReader::batchSize() const {
+  return _batchSize;
+}
+
+// _____________________________________________________________________________________________________________________
+const std::vector<std::string> &SampleReader::columns() const {
+  return _columnNames;
+}
+
+// _____________________________________________________________________________________________________________________
+const std::vector<Time> &SampleReader::baselines() const {
+  return _baselines;
+}
+
+// _____________________________________________________________________________________________________________________
+bool SampleReader::next(std::vector<Time> &row) {
+  if (_position == _rows && !_readBlock()) { return false; }
+  row.resize(_block.size());
+  for (size_t i = 0; i < _block.size(); ++i) {
+    row[i] = _block[i][_position];
+  }
+  ++_position;
+  return true;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+bool SampleReader::_readBlock() {
+  if (_end) { return false; }
+  uint64_t rows;
+  readVarint(_is, rows);
+  if (rows == 0) {
+    _end = true;
+    return false;
+  }
+  uint64_t bytes;
+  readVarint(_is, bytes);
+  // every value takes one to ten bytes
+  if (rows > SampleWriter::MAX_BLOCK_SIZE || bytes < rows * _block.size() || bytes > 10 * rows * _block.size()) {
+    throw std::runtime_error("SampleReader: corrupt block");
+  }
+  _buffer.resize(bytes);
+  if (!_is.read(&_buffer[0], static_cast<std::streamsize>(bytes))) {
+    throw std::runtime_error("SampleReader: unexpected end of stream");
+  }
+  size_t position = 0;
+  for (auto &column: _block) {
+    column.resize(rows);
+    int64_t value = 0;
+    for (auto &time: column) {
+      value += unzigzag(decodeVarint(_buffer, position));
+      time = Time::fromNanoseconds(value);
+    }
+  }
+  if (position != _buffer.size()) { throw std::runtime_error("SampleReader: corrupt block"); }
+  _rows = rows;
+  _position = 0;
+  return true;
+}
+
+
+// ===== samples =======================================================================================================
+// _____________________________________________________________________________________________________________________
+void writeSamples(std::ostream &os, const Result &result) {
+  if (result.histogramOnly) {
+    throw std::runtime_error("writeSamples: histogram-only results have no raw samples");
+  }
+  bool threadCpu = !result.threadCpuTimes.empty();
+  std::vector<std::string> columns = {"wall", "cpu"};
+  std::vector<Time> baselines = {result.wallTimeBaseline, result.cpuTimeBaseline};
+  if (threadCpu) {
+    columns.emplace_back("thread_cpu");
+    baselines.push_back(result.threadCpuTimeBaseline);
+  }
+  SampleWriter writer(os, result.title, columns, baselines, result.batchSize);
+  Time row[3];
+  for (size_t i = 0; i < result.wallTimes.size(); ++i) {
+    row[0] = result.wallTimes[i];
+    row[1] = i < result.cpuTimes.size() ? result.cpuTimes[i] : Time();
+    if (threadCpu) row[2] = i < result.threadCpuTimes.size() ? result.threadCpuTimes[i] : Time();
+    writer.add(row);
+  }
+  writer.finish();
+}
+
+// _____________________________________________________________________________________________________________________
+Result readSamples(std::istream &is) {
+  SampleReader reader(is);
+  Result result;
+  result.title = reader.title();
+  result.batchSize = reader.batchSize();
+  // column index per Result field, -1 if absent
+  int wall = -1;
+  int cpu = -1;
+  int threadCpu = -1;
+  for (size_t i = 0; i < reader.columns().size(); ++i) {
+    const auto &name = reader.columns()[i];
+    if (name == "wall") { wall = static_cast<int>(i); }
+    if (name == "cpu") { cpu = static_cast<int>(i); }
+    if (name == "thread_cpu") { threadCpu = static_cast<int>(i); }
+  }
+  if (wall >= 0) { result.wallTimeBaseline = reader.baselines()[wall]; }
+  if (cpu >= 0) { result.cpuTimeBaseline = reader.baselines()[cpu]; }
+  if (threadCpu >= 0) { result.threadCpuTimeBaseline = reader.baselines()[threadCpu]; }
+  std::vector<Time> row;
+  while (reader.next(row)) {
+    if (wall >= 0) { result.wallTimes.push_back(row[wall]); }
+    if (cpu >= 0) { result.cpuTimes.push_back(row[cpu]); }
+    if (threadCpu >= 0) { result.threadCpuTimes.push_back(row[threadCpu]); }
+  }
+  return result;
+}
+
+// _____________________________________________________________________________________________________________________
+void writeResult(std::ostream &os, const Result &result) {
+  if (result.histogramOnly) {
+    throw std::runtime_error("writeResult: histogram-only results have no raw samples");
+  }
+  std::string header(RESULT_MAGIC, sizeof(RESULT_MAGIC));
+  putVarint(header, RESULT_VERSION);
+  putString(header, result.info);
+  putVarint(header, result.bytesPerIteration);
+  putVarint(header, result.itemsPerIteration);
+  putVarint(header, result.warmupWallTimes.size());
+  for (Time time: result.warmupWallTimes) { putVarint(header, zigzag(time.count())); }
+  putVarint(header, result.perfCounters.size());
+  for (const auto &counter: result.perfCounters) {
+    putVarint(header, static_cast<uint64_t>(counter.event));
+    putDouble(header, counter.perOp);
+  }
+  putString(header, result.perfCountersError);
+  putVarint(header, result.allocationsTracked ? 1 : 0);
+  putVarint(header, result.allocations);
+  putVarint(header, result.allocatedBytes);
+  putVarint(header, zigzag(result.peakLiveBytes));
+  const auto &machine = result.machine;
+  putString(header, machine.cpuModel);
+  putVarint(header, machine.cores);
+  putString(header, machine.governor);
+  putVarint(header, zigzag(machine.turbo));
+  putString(header, machine.kernel);
+  for (double load: machine.loadAverage) { putDouble(header, load); }
+  putVarint(header, result.warnings.size());
+  for (const auto &warning: result.warnings) { putString(header, warning); }
+  os.write(header.data(), static_cast<std::streamsize>(header.size()));
+  writeSamples(os, result);
+}
+
+// _____________________________________________________________________________________________________________________
+Result readResult(std::istream &is) {
+  char magic[sizeof(RESULT_MAGIC)];
+  uint64_t version = 0;
+  if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, RESULT_MAGIC, sizeof(magic)) != 0) {
+    throw std::runtime_error("readResult: invalid header");
+  }
+  readVarint(is, version);
+  if (version != RESULT_VERSION) {
+    throw std::runtime_error("readResult: unsupported version " + std::to_string(version));
+  }
+  // the samples come last, the metadata is moved into their result
+  std::string info = readString(is);
+  uint64_t bytesPerIteration;
+  uint64_t itemsPerIteration;
+  readVarint(is, bytesPerIteration);
+  readVarint(is, itemsPerIteration);
+  std::vector<Time> warmupWallTimes(readCount(is));
+  for (auto &time: warmupWallTimes) { time = Time::fromNanoseconds(readZigzag(is)); }
+  std::vector<PerfCounterValue> perfCounters(readCount(is));
+  for (auto &counter: perfCounters) {
+    uint64_t event;
+    readVarint(is, event);
+    if (event > static_cast<uint64_t>(PerfEvent::BRANCH_MISSES)) {
+      throw std::runtime_error("readResult: invalid counter " + std::to_string(event));
+    }
+    counter.event = static_cast<PerfEvent>(event);
+    counter.perOp = readDouble(is);
+  }
+  std::string perfCountersError = readString(is);
+  uint64_t allocationsTracked;
+  uint64_t allocations;
+  uint64_t allocatedBytes;
+  readVarint(is, allocationsTracked);
+  readVarint(is, allocations);
+  readVarint(is, allocatedBytes);
+  int64_t peakLiveBytes = readZigzag(is);
+  MachineContext machine;
+  machine.cpuModel = readString(is);
+  uint64_t cores;
+  readVarint(is, cores);
+  machine.cores = static_cast<unsigned>(cores);
+  machine.governor = readString(is);
+  machine.turbo = static_cast<int>(readZigzag(is));
+  machine.kernel = readString(is);
+  for (auto &load: machine.loadAverage) { load = readDouble(is); }
+  std::vector<std::string> warnings(readCount(is));
+  for (auto &warning: warnings) { warning = readString(is); }
+
+  Result result = readSamples(is);
+  result.info = std::move(info);
+  result.bytesPerIteration = bytesPerIteration;
+  result.itemsPerIteration = itemsPerIteration;
+  result.warmupWallTimes = std::move(warmupWallTimes);
+  result.perfCounters = std::move(perfCounters);
+  result.perfCountersError = std::move(perfCountersError);
+  result.allocationsTracked = allocationsTracked != 0;
+  result.allocations = allocations;
+  result.allocatedBytes = allocatedBytes;
+  result.peakLiveBytes = peakLiveBytes;
+  result.machine = std::move(machine);
+  result.warnings = std::move(warnings);
+  return result;
+}
+
+}  // namespace benchmark
+}  // namespace timed
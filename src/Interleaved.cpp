@@ -0,0 +1,185 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "timed/Interleaved.h"
+
+namespace timed {
+namespace benchmark {
+
+// _____________________________________________________________________________________________________________________
+std::ostream &operator<<(std::ostream &os, const InterleavedResult &result) {
+  for (const auto &benchmark: result.results) {
+    os << benchmark << "\n";
+  }
+  if (result.comparisons.empty()) { return os; }
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << "Relative speed (" << result.results.front().size() << " interleaved rounds, baseline '"
+     << result.results.front().title << "'):\n";
+  for (const auto &comparison: result.comparisons) {
+    os << std::fixed << std::setprecision(3);
+    os << "  '" << comparison.title << "': ratio " << comparison.ratio << " [" << comparison.ratioLow << ", "
+       << comparison.ratioHigh << "], ";
+    if (comparison.verdict == Verdict::FASTER) {
+      os << 1 / comparison.ratio << "x faster";
+    } else if (comparison.verdict == Verdict::SLOWER) {
+      os << comparison.ratio << "x slower";
+    } else {
+      os << toString(comparison.verdict);
+    }
+    os << std::defaultfloat << std::setprecision(3) << " (p-value " << comparison.pValue << ")\n";
+  }
+  os.flags(flags);
+  os.precision(precision);
+  return os;
+}
+
+
+// ===== InterleavedBenchmark ==========================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+InterleavedBenchmark::InterleavedBenchmark(Config config, CompareOptions options)
+    : _config(std::move(config)), _options(options) {}
+
+// _____________________________________________________________________________________________________________________
+InterleavedBenchmark &InterleavedBenchmark::add(std::string title, std::function<void()> op,
+                                                std::function<void()> precedentOp) {
+  _entries.push_back({std::move(title), std::move(op), std::move(precedentOp)});
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+size_t InterleavedBenchmark::size() const {
+  return _entries.size();
+}
+
+// _____________________________________________________________________________________________________________________
+const InterleavedResult &InterleavedBenchmark::run(bool verbose) {
+  if (_entries.empty()) { throw std::runtime_error("InterleavedBenchmark: no ops added"); }
+  _result = InterleavedResult();
+  _result.results.resize(_entries.size());
+  for (size_t i = 0; i < _entries.size(); ++i) {
+    auto &result = _result.results[i];
+    result.title = _entries[i].title;
+    result.info = _config.info;
+    result.bytesPerIteration = _config.bytesPerIteration;
+    result.itemsPerIteration = _config.itemsPerIteration;
+  }
+  {
+    // one environment for all ops, recorded in the first result and copied to the others
+    detail::ScopedEnvironment environment(_config, _result.results.front());
+    if (_config.wallClock == WallClock::TSC) {
+      runWith<detail::LoopTscTimer>(verbose);
+    } else {
+      runWith<detail::LoopWallTimer>(verbose);
+    }
+  }
+  const auto &baseline = _result.results.front();
+  for (size_t i = 1; i < _result.results.size(); ++i) {
+    _result.results[i].machine = baseline.machine;
+    _result.results[i].warnings = baseline.warnings;
+    if (_config.iterations > 0) {
+      _result.comparisons.push_back(comparePaired(baseline, _result.results[i], _options));
+    }
+  }
+  return _result;
+}
+
+// _____________________________________________________________________________________________________________________
+const InterleavedResult &InterleavedBenchmark::getResult() const {
+  return _result;
+}
+
+// _____________________________________________________________________________________________________________________
+const Config &InterleavedBenchmark::getConfig() const {
+  return _config;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+template<typename WallTimerT>
+void InterleavedBenchmark::runWith(bool verbose) {
+  const auto &overhead = detail::loopOverhead<WallTimerT>(_config.threadCpuTime);
+  WallTimerT wallTimer;
+  detail::LoopCPUTimer cpuTimer;
+  detail::LoopCPUTimer threadCpuTimer(CPUClock::THREAD);
+  // timers nested like in BasicBenchmark::runBatch(), so that the loop overhead applies
+  auto measure = [&](const Entry &entry, uint64_t batchSize) {
+    entry.precedentOp();
+    wallTimer.start();
+    cpuTimer.start();
+    if (_config.threadCpuTime) threadCpuTimer.start();
+    for (uint64_t i = 0; i < batchSize; ++i) {
+      entry.op();
+    }
+    if (_config.threadCpuTime) threadCpuTimer.stop();
+    cpuTimer.stop();
+    wallTimer.stop();
+  };
+  auto &results = _result.results;
+  std::vector<uint64_t> batchSizes(_entries.size(), 1);
+  if (_config.autoIterations) {
+    // grow the batch of every op until a single batch reaches minSampleTime, like BasicBenchmark::runAuto()
+    for (size_t i = 0; i < _entries.size(); ++i) {
+      detail::LoopWallTimer budgetTimer;
+      budgetTimer.start();
+      uint64_t batchSize = 1;
+      while (true) {
+        measure(_entries[i], batchSize);
+        Time batchTime = wallTimer.getTime() - overhead.wall;
+        if (batchTime >= _config.minSampleTime || budgetTimer.getTime() >= _config.maxTime) break;
+        double factor = batchTime.count() == 0
+                        ? 10.0
+                        : std::min(10.0, 1.4 * static_cast<double>(_config.minSampleTime.count()) /
+                                         static_cast<double>(batchTime.count()));
+        batchSize = static_cast<uint64_t>(std::ceil(static_cast<double>(batchSize) * factor));
+      }
+      batchSizes[i] = batchSize;
+    }
+  }
+  for (size_t i = 0; i < results.size(); ++i) {
+    results[i].batchSize = batchSizes[i];
+    results[i].wallTimeBaseline = overhead.wall / batchSizes[i];
+    results[i].cpuTimeBaseline = overhead.cpu / batchSizes[i];
+    results[i].threadCpuTimeBaseline = _config.threadCpuTime ? overhead.threadCpu / batchSizes[i] : Time();
+    results[i].wallTimes.reserve(_config.iterations);
+    results[i].cpuTimes.reserve(_config.iterations);
+    if (_config.threadCpuTime) results[i].threadCpuTimes.reserve(_config.iterations);
+  }
+  std::vector<size_t> order(_entries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::mt19937_64 gen(_options.seed);
+  detail::LoopWallTimer warmupTimer;
+  warmupTimer.start();
+  for (unsigned round = 0; round < _config.warmupIterations || warmupTimer.getTime() < _config.warmupTime; ++round) {
+    std::shuffle(order.begin(), order.end(), gen);
+    for (size_t i: order) {
+      measure(_entries[i], batchSizes[i]);
+      results[i].warmupWallTimes.push_back(wallTimer.getTime() / batchSizes[i]);
+    }
+  }
+  for (unsigned round = 0; round < _config.iterations; ++round) {
+    if (verbose) std::cout << '\r' << round << "/" << _config.iterations << std::flush;
+    std::shuffle(order.begin(), order.end(), gen);
+    for (size_t i: order) {
+      measure(_entries[i], batchSizes[i]);
+      results[i].addWallTime(wallTimer.getTime() / batchSizes[i]);
+      results[i].addCpuTime(cpuTimer.getTime() / batchSizes[i]);
+      if (_config.threadCpuTime) results[i].addThreadCpuTime(threadCpuTimer.getTime() / batchSizes[i]);
+    }
+  }
+  if (verbose) std::cout << '\r' << "✅              " << std::endl;
+}
+
+}  // namespace benchmark
+}  // namespace timed
@@ -0,0 +1,175 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define TIMED_HAS_FORK
+#endif
+
+#include "timed/Export.h"
+#include "timed/Isolation.h"
+
+namespace timed {
+namespace benchmark {
+
+#ifdef TIMED_HAS_FORK
+namespace {
+
+// Child to parent protocol: 'R', per result 'r' and writeResult(), 'e' (end) or 'E' and an error message.
+constexpr char RESULTS = 'R';
+constexpr char RESULT = 'r';
+constexpr char END = 'e';
+constexpr char ERROR = 'E';
+
+// _____________________________________________________________________________________________________________________
+bool writeAll(int fd, const std::string &data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0) { return false; }
+    written += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// _____________________________________________________________________________________________________________________
+[[noreturn]] void runChild(const std::function<std::vector<Result>()> &run, int fd) {
+  std::string message;
+  int status = 0;
+  try {
+    auto results = run();
+    std::ostringstream ss;
+    ss.put(RESULTS);
+    for (const auto &result: results) {
+      ss.put(RESULT);
+      writeResult(ss, result);
+    }
+    ss.put(END);
+    message = ss.str();
+  } catch (const std::exception &e) {
+    message = std::string(1, ERROR) + e.what();
+    status = 1;
+  } catch (...) {
+    message = std::string(1, ERROR) + "unknown exception";
+    status = 1;
+  }
+  std::cout.flush();
+  std::cerr.flush();
+  if (!writeAll(fd, message)) { status = 1; }
+  close(fd);
+  // no atexit handlers and static destructors: they belong to the parent
+  _exit(status);
+}
+
+// _____________________________________________________________________________________________________________________
+void parseMessage(const std::string &message, IsolatedRun &run) {
+  if (message[0] == ERROR) {
+    run.error = message.size() > 1 ? message.substr(1) : "unknown error";
+    return;
+  }
+  if (message[0] != RESULTS) {
+    run.error = "invalid result stream";
+    return;
+  }
+  std::istringstream is(message.substr(1));
+  try {
+    while (true) {
+      int tag = is.get();
+      if (tag == END) { return; }
+      if (tag != RESULT) { throw std::runtime_error("truncated result stream"); }
+      run.results.push_back(readResult(is));
+    }
+  } catch (const std::exception &e) {
+    run.results.clear();
+    run.error = std::string("invalid result stream: ") + e.what();
+  }
+}
+
+}  // namespace
+#endif
+
+// _____________________________________________________________________________________________________________________
+IsolatedRun runIsolated(const std::function<std::vector<Result>()> &run, Time timeout) {
+  IsolatedRun ret;
+#ifdef TIMED_HAS_FORK
+  using Clock = std::chrono::steady_clock;
+  int fds[2];
+  if (pipe(fds) != 0) {
+    ret.error = std::string("pipe() failed: ") + std::strerror(errno);
+    return ret;
+  }
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+  pid_t pid = fork();
+  if (pid < 0) {
+    ret.error = std::string("fork() failed: ") + std::strerror(errno);
+    close(fds[0]);
+    close(fds[1]);
+    return ret;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    runChild(run, fds[1]);
+  }
+  close(fds[1]);
+  auto deadline = Clock::now() + std::chrono::nanoseconds(timeout.count());
+  std::string message;
+  char buffer[1 << 16];
+  bool timedOut = false;
+  while (true) {
+    int wait = -1;
+    if (timeout.count() > 0) {
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+      if (left <= 0) {
+        timedOut = true;
+        break;
+      }
+      wait = static_cast<int>(std::min<int64_t>(left + 1, 1 << 30));
+    }
+    pollfd readable{fds[0], POLLIN, 0};
+    int ready = poll(&readable, 1, wait);
+    if (ready < 0 && errno == EINTR) { continue; }
+    if (ready == 0) { continue; }
+    ssize_t n = read(fds[0], buffer, sizeof(buffer));
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0) { break; }
+    message.append(buffer, static_cast<size_t>(n));
+  }
+  close(fds[0]);
+  if (timedOut) { kill(pid, SIGKILL); }
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+  if (timedOut) {
+    ret.error = "timed out after " + std::to_string(timeout.count() / Time::NS_PER_MS) + "ms";
+  } else if (WIFSIGNALED(status)) {
+    ret.error = "killed by signal " + std::to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) + ")";
+  } else if (message.empty()) {
+    ret.error = "exited with status " + std::to_string(WEXITSTATUS(status)) + " without results";
+  } else {
+    parseMessage(message, ret);
+  }
+#else
+  (void) run;
+  (void) timeout;
+  ret.error = "process isolation needs fork(), which is not available on this platform";
+#endif
+  return ret;
+}
+
+}  // namespace benchmark
+}  // namespace timed
@@ -0,0 +1,196 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "timed/PerfCounters.h"
+
+namespace timed {
+
+namespace {
+
+#ifdef __linux__
+// _____________________________________________________________________________________________________________________
+uint64_t hardwareConfig(PerfEvent event) {
+  switch (event) {
+    case PerfEvent::CYCLES: return PERF_COUNT_HW_CPU_CYCLES;
+    case PerfEvent::INSTRUCTIONS: return PERF_COUNT_HW_INSTRUCTIONS;
+    case PerfEvent::CACHE_REFERENCES: return PERF_COUNT_HW_CACHE_REFERENCES;
+    case PerfEvent::CACHE_MISSES: return PERF_COUNT_HW_CACHE_MISSES;
+    case PerfEvent::BRANCHES: return PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+    case PerfEvent::BRANCH_MISSES: return PERF_COUNT_HW_BRANCH_MISSES;
+  }
+  return PERF_COUNT_HW_CPU_CYCLES;
+}
+
+// _____________________________________________________________________________________________________________________
+int openEvent(PerfEvent event, int groupFd) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = hardwareConfig(event);
+  // the group leader starts disabled, the whole group is enabled at once after all members are opened
+  attr.disabled = groupFd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+}
+
+// _____________________________________________________________________________________________________________________
+std::string openError(int error) {
+  if (error == EACCES || error == EPERM) {
+    std::string paranoid = "?";
+    std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+    file >> paranoid;
+    return "perf_event_open: permission denied (perf_event_paranoid is " + paranoid +
+           ", user space counting needs <= 2 or CAP_PERFMON)";
+  }
+  if (error == ENOENT || error == EOPNOTSUPP) {
+    return "perf_event_open: hardware events not supported (no PMU, e.g. in a virtual machine)";
+  }
+  return std::string("perf_event_open: ") + std::strerror(error);
+}
+#endif
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+const char *toString(PerfEvent event) {
+  switch (event) {
+    case PerfEvent::CYCLES: return "cycles";
+    case PerfEvent::INSTRUCTIONS: return "instructions";
+    case PerfEvent::CACHE_REFERENCES: return "cache-references";
+    case PerfEvent::CACHE_MISSES: return "cache-misses";
+    case PerfEvent::BRANCHES: return "branches";
+    case PerfEvent::BRANCH_MISSES: return "branch-misses";
+  }
+  return "unknown";
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<PerfEvent> defaultPerfEvents() {
+  return {PerfEvent::CYCLES, PerfEvent::INSTRUCTIONS, PerfEvent::CACHE_MISSES, PerfEvent::BRANCH_MISSES};
+}
+
+// ===== PerfCounterTimer ==============================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+PerfCounterTimer::PerfCounterTimer(const std::vector<PerfEvent> &events) {
+#ifdef __linux__
+  int leaderError = 0;
+  for (PerfEvent event: events) {
+    int fd = openEvent(event, _fds.empty() ? -1 : _fds.front());
+    if (fd < 0) {
+      // unsupported events are skipped, permission problems affect every event
+      if (_fds.empty()) { leaderError = errno; }
+      if (errno == EACCES || errno == EPERM || errno == ENOSYS) { break; }
+      continue;
+    }
+    _fds.push_back(fd);
+    _events.push_back(event);
+  }
+  if (_fds.empty()) {
+    _error = events.empty() ? "no perf events requested" : openError(leaderError);
+    _events.clear();
+    return;
+  }
+  ioctl(_fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(_fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  _buffer.resize(_events.size() + 3);
+  _startValues.resize(_events.size() + 2);
+  _stopValues.resize(_events.size() + 2);
+  _counts.resize(_events.size());
+#else
+  (void) events;
+  _error = "hardware performance counters are only supported on Linux";
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+PerfCounterTimer::~PerfCounterTimer() {
+#ifdef __linux__
+  for (int fd: _fds) {
+    close(fd);
+  }
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+bool PerfCounterTimer::available() const {
+  return !_fds.empty();
+}
+
+// _____________________________________________________________________________________________________________________
+const std::string &PerfCounterTimer::error() const {
+  return _error;
+}
+
+// _____________________________________________________________________________________________________________________
+void PerfCounterTimer::start() {
+  if (_fds.empty()) { return; }
+  _started = _read(_startValues);
+}
+
+// _____________________________________________________________________________________________________________________
+void PerfCounterTimer::stop() {
+  if (!_started || !_read(_stopValues)) { return; }
+  _started = false;
+  // the group may have been multiplexed with other groups: extrapolate to the time it was enabled
+  uint64_t enabled = _stopValues[0] - _startValues[0];
+  uint64_t running = _stopValues[1] - _startValues[1];
+  double scale = running > 0 ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+  for (size_t i = 0; i < _counts.size(); ++i) {
+    _counts[i] += static_cast<double>(_stopValues[i + 2] - _startValues[i + 2]) * scale;
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void PerfCounterTimer::reset() {
+  std::fill(_counts.begin(), _counts.end(), 0.0);
+}
+
+// _____________________________________________________________________________________________________________________
+const std::vector<PerfEvent> &PerfCounterTimer::events() const {
+  return _events;
+}
+
+// _____________________________________________________________________________________________________________________
+const std::vector<double> &PerfCounterTimer::getCounts() const {
+  return _counts;
+}
+
+// _____________________________________________________________________________________________________________________
+double PerfCounterTimer::getCount(PerfEvent event) const {
+  auto it = std::find(_events.begin(), _events.end(), event);
+  return it == _events.end() ? 0.0 : _counts[static_cast<size_t>(it - _events.begin())];
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+bool PerfCounterTimer::_read(std::vector<uint64_t> &values) {
+#ifdef __linux__
+  // PERF_FORMAT_GROUP layout: nr, time enabled, time running, nr values
+  size_t bytes = _buffer.size() * sizeof(uint64_t);
+  if (read(_fds.front(), _buffer.data(), bytes) != static_cast<ssize_t>(bytes)) { return false; }
+  std::copy(_buffer.begin() + 1, _buffer.end(), values.begin());
+  return true;
+#else
+  (void) values;
+  return false;
+#endif
+}
+
+}  // namespace timed
@@ -0,0 +1,181 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cstring>
+
+#include "timed/Profiler.h"
+
+namespace timed {
+namespace profiler {
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+// single writer: plain load/store instead of a locked read-modify-write
+inline void add(std::atomic<uint64_t> &value, uint64_t x) {
+  value.store(value.load(std::memory_order_relaxed) + x, std::memory_order_relaxed);
+}
+
+// _____________________________________________________________________________________________________________________
+void mergeNode(const detail::Node &node, ZoneStats &stats) {
+  for (const detail::Node *child = node.firstChild.load(std::memory_order_acquire); child != nullptr;
+       child = child->nextSibling.load(std::memory_order_acquire)) {
+    uint64_t calls = child->calls.load(std::memory_order_relaxed);
+    if (calls == 0) { continue; }
+    auto it = std::find_if(stats.children.begin(), stats.children.end(), [child](const ZoneStats &s) {
+      return std::strcmp(s.name.c_str(), child->site->name) == 0;
+    });
+    if (it == stats.children.end()) {
+      ZoneStats s;
+      s.name = child->site->name;
+      s.path = stats.path.empty() ? s.name : stats.path + "/" + s.name;
+      s.min = Time::fromNanoseconds(INT64_MAX);
+      stats.children.push_back(std::move(s));
+      it = stats.children.end() - 1;
+    }
+    uint64_t inclusive = child->inclusiveNs.load(std::memory_order_relaxed);
+    uint64_t children = std::min(child->childNs.load(std::memory_order_relaxed), inclusive);
+    it->calls += calls;
+    it->inclusive += inclusive;
+    it->exclusive += inclusive - children;
+    auto min = static_cast<int64_t>(child->minNs.load(std::memory_order_relaxed));
+    auto max = static_cast<int64_t>(child->maxNs.load(std::memory_order_relaxed));
+    it->min = std::min(it->min, Time::fromNanoseconds(min));
+    it->max = std::max(it->max, Time::fromNanoseconds(max));
+    mergeNode(*child, *it);
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void print(std::ostream &os, const ZoneStats &stats, unsigned depth) {
+  std::string indent(2 * depth, ' ');
+  os << indent << stats.name << ": calls: " << stats.calls
+     << ", inclusive: " << stats.inclusive
+     << ", exclusive: " << stats.exclusive
+     << ", mean: " << stats.mean()
+     << ", min: " << stats.min
+     << ", max: " << stats.max << "\n";
+  for (const auto &child: stats.children) {
+    print(os, child, depth + 1);
+  }
+}
+
+}  // namespace
+
+// ===== ZoneStats =====================================================================================================
+// _____________________________________________________________________________________________________________________
+Time ZoneStats::mean() const {
+  if (calls == 0) { return Time(); }
+  return inclusive / calls;
+}
+
+// _____________________________________________________________________________________________________________________
+std::ostream &operator<<(std::ostream &os, const ZoneStats &stats) {
+  if (stats.name.empty()) {
+    for (const auto &child: stats.children) {
+      print(os, child, 0);
+    }
+    return os;
+  }
+  print(os, stats, 0);
+  return os;
+}
+
+namespace detail {
+
+// ===== ThreadTree ====================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+ThreadTree::ThreadTree() : _root(nullptr, nullptr), _current(&_root) {}
+
+// _____________________________________________________________________________________________________________________
+void ThreadTree::enter(const ZoneSite *site) {
+  for (Node *child = _current->firstChild.load(std::memory_order_relaxed); child != nullptr;
+       child = child->nextSibling.load(std::memory_order_relaxed)) {
+    if (child->site == site) {
+      _current = child;
+      return;
+    }
+  }
+  // first visit of this path: the only allocation on the recording path
+  _nodes.push_back(std::make_unique<Node>(site, _current));
+  Node *node = _nodes.back().get();
+  node->nextSibling.store(_current->firstChild.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  _current->firstChild.store(node, std::memory_order_release);
+  _current = node;
+}
+
+// _____________________________________________________________________________________________________________________
+void ThreadTree::exit(uint64_t ns) {
+  Node *node = _current;
+  add(node->calls, 1);
+  add(node->inclusiveNs, ns);
+  if (ns < node->minNs.load(std::memory_order_relaxed)) { node->minNs.store(ns, std::memory_order_relaxed); }
+  if (ns > node->maxNs.load(std::memory_order_relaxed)) { node->maxNs.store(ns, std::memory_order_relaxed); }
+  _current = node->parent;
+  add(_current->childNs, ns);
+}
+
+// _____________________________________________________________________________________________________________________
+const Node &ThreadTree::root() const {
+  return _root;
+}
+
+// _____________________________________________________________________________________________________________________
+ThreadTree &threadTree() {
+  thread_local std::shared_ptr<ThreadTree> tree = Profiler::instance().registerThread();
+  return *tree;
+}
+
+}  // namespace detail
+
+// ===== ScopedTimer ===================================================================================================
+// _____________________________________________________________________________________________________________________
+ScopedTimer::ScopedTimer(const ZoneSite &site) : _tree(detail::threadTree()) {
+  _tree.enter(&site);
+  _timer.start();
+}
+
+// _____________________________________________________________________________________________________________________
+ScopedTimer::~ScopedTimer() {
+  _tree.exit(_timer.stop().getNanoseconds());
+}
+
+// ===== Profiler ======================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Profiler &Profiler::instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+// _____________________________________________________________________________________________________________________
+ZoneStats Profiler::merged() const {
+  ZoneStats root;
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (const auto &tree: _trees) {
+    mergeNode(tree->root(), root);
+  }
+  return root;
+}
+
+// _____________________________________________________________________________________________________________________
+size_t Profiler::threadCount() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _trees.size();
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+std::shared_ptr<detail::ThreadTree> Profiler::registerThread() {
+  auto tree = std::make_shared<detail::ThreadTree>();
+  std::lock_guard<std::mutex> lock(_mutex);
+  _trees.push_back(tree);
+  return tree;
+}
+
+}  // namespace profiler
+}  // namespace timed
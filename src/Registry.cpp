@@ -0,0 +1,685 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include "timed/Isolation.h"
+#include "timed/Registry.h"
+#include "timed/utils/Complexity.h"
+
+namespace timed {
+namespace benchmark {
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+// values above max are rejected instead of wrapping around (e.g. INT_MAX for options stored in an int)
+unsigned parseUnsigned(const std::string &option, const std::string &value,
+                       unsigned max = std::numeric_limits<unsigned>::max()) {
+  size_t end = 0;
+  unsigned long parsed = 0;
+  try {
+    parsed = std::stoul(value, &end);
+  } catch (const std::exception &) {
+    end = 0;
+  }
+  if (end == 0 || end != value.size() || value[0] == '-' || parsed > max) {
+    throw std::runtime_error("invalid value for " + option + ": '" + value + "'");
+  }
+  return static_cast<unsigned>(parsed);
+}
+
+// _____________________________________________________________________________________________________________________
+double parseDouble(const std::string &option, const std::string &value) {
+  size_t end = 0;
+  double parsed = 0;
+  try {
+    parsed = std::stod(value, &end);
+  } catch (const std::exception &) {
+    end = 0;
+  }
+  if (end == 0 || end != value.size() || !std::isfinite(parsed) || parsed < 0) {
+    throw std::runtime_error("invalid value for " + option + ": '" + value + "'");
+  }
+  return parsed;
+}
+
+// _____________________________________________________________________________________________________________________
+Time parseDuration(const std::string &option, const std::string &value) {
+  size_t end = 0;
+  double number = 0;
+  try {
+    number = std::stod(value, &end);
+  } catch (const std::exception &) {
+    end = 0;
+  }
+  std::string unit = value.substr(end);
+  double nsPerUnit = 1;
+  if (unit.empty() || unit == "s") {
+    nsPerUnit = Time::NS_PER_S;
+  } else if (unit == "ms") {
+    nsPerUnit = Time::NS_PER_MS;
+  } else if (unit == "us") {
+    nsPerUnit = Time::NS_PER_US;
+  } else if (unit == "ns") {
+    nsPerUnit = 1;
+  } else {
+    end = 0;
+  }
+  // std::llround is undefined for inf, nan and values out of the int64_t range
+  if (end == 0 || !std::isfinite(number) || number < 0 ||
+      number * nsPerUnit >= static_cast<double>(std::numeric_limits<int64_t>::max())) {
+    throw std::runtime_error("invalid value for " + option + ": '" + value + "'");
+  }
+  return Time::fromNanoseconds(std::llround(number * nsPerUnit));
+}
+
+// _____________________________________________________________________________________________________________________
+// run() op with every config, one after the other
+std::vector<Result> runConfigs(const Instance &instance, const std::vector<Config> &configs) {
+  std::vector<Result> results;
+  for (const auto &config: configs) {
+    Benchmark benchmark(config, instance.op, instance.precedentOp);
+    results.push_back(benchmark.run());
+  }
+  return results;
+}
+
+// _____________________________________________________________________________________________________________________
+// false if result allocated more than config allows or allocations were not counted (a limit that cannot be checked
+// must not pass silently), the violation is reported on stderr
+bool checkAllocations(const Config &config, const Result &result) {
+  if (config.maxAllocationsPerOp < 0) { return true; }
+  if (!result.allocationsTracked) {
+    std::cerr << "Allocation limit of '" << result.title
+              << "' not checked: link the AllocationTracker library to count allocations" << std::endl;
+    return false;
+  }
+  if (result.allocationsPerOp() <= config.maxAllocationsPerOp) { return true; }
+  std::cerr << "Allocation limit exceeded: '" << result.title << "': " << result.allocationsPerOp()
+            << " allocations per op (limit " << config.maxAllocationsPerOp << ")" << std::endl;
+  return false;
+}
+
+// _____________________________________________________________________________________________________________________
+void applyOptions(Config &config, const RunOptions &options) {
+  if (options.minTime.count() > 0) {
+    config.autoIterations = true;
+    config.minTime = options.minTime;
+    config.maxTime = std::max(config.maxTime, options.minTime);
+  }
+  if (!options.threadCounts.empty()) {
+    config.threadCounts = options.threadCounts;
+  }
+  if (options.perfCounters) {
+    config.perfCounters = true;
+  }
+  if (options.pinCpu >= 0) {
+    config.pinCpu = options.pinCpu;
+  }
+  if (options.realtimePriority > 0) {
+    config.realtimePriority = options.realtimePriority;
+  }
+  if (options.lockMemory) {
+    config.lockMemory = true;
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+// fit every group of results that share all arguments but the one at index argument
+void reportComplexity(Reporter &reporter, const std::string &name, size_t argument,
+                      const std::vector<std::pair<Arguments, Time>> &meanTimes) {
+  struct Group {
+    std::vector<double> n;
+    std::vector<double> times;
+  };
+  std::map<Arguments, Group> groups;
+  std::vector<Arguments> order;
+  for (const auto &[arguments, time]: meanTimes) {
+    if (argument >= arguments.size()) { continue; }
+    Arguments key = arguments;
+    key[argument] = 0;
+    auto it = groups.find(key);
+    if (it == groups.end()) {
+      it = groups.emplace(key, Group()).first;
+      order.push_back(arguments);
+    }
+    it->second.n.push_back(static_cast<double>(arguments[argument]));
+    it->second.times.push_back(static_cast<double>(time.count()));
+  }
+  for (const auto &arguments: order) {
+    Arguments key = arguments;
+    key[argument] = 0;
+    const auto &group = groups[key];
+    if (std::count(group.n.begin(), group.n.end(), group.n.front()) == static_cast<std::ptrdiff_t>(group.n.size())) {
+      continue;
+    }
+    std::string groupName = name;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+      groupName += "/" + (i == argument ? std::string("n") : std::to_string(arguments[i]));
+    }
+    reporter.report(groupName, utils::fitComplexity(group.n, group.times));
+  }
+}
+
+}  // namespace
+
+// ===== ranges ========================================================================================================
+// _____________________________________________________________________________________________________________________
+std::vector<int64_t> linearRange(int64_t start, int64_t limit, int64_t step) {
+  if (step <= 0) {
+    throw std::runtime_error("linearRange: step must be positive, got " + std::to_string(step));
+  }
+  std::vector<int64_t> ret;
+  for (int64_t value = start; value <= limit; value += step) {
+    ret.push_back(value);
+    if (limit - value < step) { break; }
+  }
+  return ret;
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<int64_t> geometricRange(int64_t start, int64_t limit, int64_t multiplier) {
+  if (start <= 0 || start > limit || multiplier < 2) {
+    throw std::runtime_error("geometricRange: invalid range [" + std::to_string(start) + ", " + std::to_string(limit) +
+                             "] with multiplier " + std::to_string(multiplier));
+  }
+  std::vector<int64_t> ret;
+  int64_t value = start;
+  while (value < limit) {
+    ret.push_back(value);
+    if (value > limit / multiplier) { break; }
+    value *= multiplier;
+  }
+  ret.push_back(limit);
+  return ret;
+}
+
+
+// ===== Registration ==================================================================================================
+// _____________________________________________________________________________________________________________________
+Registration::Registration(std::string name, std::function<void()> op)
+    : _name(std::move(name)), _op(std::move(op)), _precedentOp([]() {}) {
+  _config.title = _name;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration::Registration(std::string name, std::function<void(const Arguments &)> op)
+    : _name(std::move(name)), _parameterizedOp(std::move(op)) {
+  _config.title = _name;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::setup(std::function<void()> precedentOp) {
+  _precedentOp = precedentOp ? std::move(precedentOp) : []() {};
+  _parameterizedPrecedentOp = nullptr;
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::setup(std::function<void(const Arguments &)> precedentOp) {
+  _parameterizedPrecedentOp = std::move(precedentOp);
+  _precedentOp = []() {};
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::arg(int64_t argument) {
+  _arguments.push_back({argument});
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::args(Arguments arguments) {
+  _arguments.push_back(std::move(arguments));
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::argRange(int64_t start, int64_t limit, int64_t step) {
+  for (int64_t value: linearRange(start, limit, step)) {
+    arg(value);
+  }
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::argGeometricRange(int64_t start, int64_t limit, int64_t multiplier) {
+  for (int64_t value: geometricRange(start, limit, multiplier)) {
+    arg(value);
+  }
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::argsProduct(const std::vector<std::vector<int64_t>> &values) {
+  for (const auto &parameter: values) {
+    if (parameter.empty()) { return *this; }
+  }
+  if (values.empty()) { return *this; }
+  // odometer over the value indices, the last parameter varies fastest
+  std::vector<size_t> indices(values.size(), 0);
+  while (true) {
+    Arguments arguments(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      arguments[i] = values[i][indices[i]];
+    }
+    _arguments.push_back(std::move(arguments));
+    size_t i = values.size();
+    while (i > 0 && ++indices[i - 1] == values[i - 1].size()) {
+      indices[i - 1] = 0;
+      --i;
+    }
+    if (i == 0) { break; }
+  }
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::complexity(size_t argument) {
+  _complexityArgument = static_cast<int>(argument);
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::iterations(unsigned iterations) {
+  _config.iterations = iterations;
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::bytesPerIteration(uint64_t bytes) {
+  _config.bytesPerIteration = bytes;
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::itemsPerIteration(uint64_t items) {
+  _config.itemsPerIteration = items;
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::maxAllocationsPerOp(double allocations) {
+  _config.maxAllocationsPerOp = allocations;
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::configure(const std::function<void(Config &)> &configure) {
+  configure(_config);
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registration::configure(const std::function<void(Config &, const Arguments &)> &configure) {
+  _argumentConfigurators.push_back(configure);
+  return *this;
+}
+
+// _____________________________________________________________________________________________________________________
+const std::string &Registration::name() const {
+  return _name;
+}
+
+// _____________________________________________________________________________________________________________________
+const Config &Registration::config() const {
+  return _config;
+}
+
+// _____________________________________________________________________________________________________________________
+bool Registration::parameterized() const {
+  return static_cast<bool>(_parameterizedOp);
+}
+
+// _____________________________________________________________________________________________________________________
+const std::vector<Arguments> &Registration::arguments() const {
+  return _arguments;
+}
+
+// _____________________________________________________________________________________________________________________
+int Registration::complexityArgument() const {
+  return _complexityArgument;
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<Instance> Registration::instances() const {
+  if (!parameterized()) {
+    return {Instance{_name, {}, _config, _op, _precedentOp}};
+  }
+  if (_arguments.empty()) {
+    throw std::runtime_error("Registration '" + _name + "': parameterized benchmark without arguments");
+  }
+  std::vector<Instance> ret;
+  ret.reserve(_arguments.size());
+  for (const auto &arguments: _arguments) {
+    Instance instance;
+    instance.name = _name;
+    for (int64_t argument: arguments) {
+      instance.name += "/" + std::to_string(argument);
+    }
+    instance.arguments = arguments;
+    instance.config = _config;
+    instance.config.title = instance.name;
+    for (const auto &configure: _argumentConfigurators) {
+      configure(instance.config, arguments);
+    }
+    // the closures own a copy of the arguments, instances can outlive the registration
+    auto op = _parameterizedOp;
+    instance.op = [op, arguments]() { op(arguments); };
+    if (_parameterizedPrecedentOp) {
+      auto precedentOp = _parameterizedPrecedentOp;
+      instance.precedentOp = [precedentOp, arguments]() { precedentOp(arguments); };
+    } else {
+      instance.precedentOp = _precedentOp ? _precedentOp : []() {};
+    }
+    ret.push_back(std::move(instance));
+  }
+  return ret;
+}
+
+
+// ===== Registry ======================================================================================================
+// _____________________________________________________________________________________________________________________
+Registry &Registry::instance() {
+  static Registry registry;
+  return registry;
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registry::add(std::string name, std::function<void()> op) {
+  for (const auto &registration: _registrations) {
+    if (registration.name() == name) {
+      throw std::runtime_error("Registry: benchmark '" + name + "' is already registered");
+    }
+  }
+  _registrations.emplace_back(std::move(name), std::move(op));
+  return _registrations.back();
+}
+
+// _____________________________________________________________________________________________________________________
+Registration &Registry::add(std::string name, std::function<void(const Arguments &)> op) {
+  for (const auto &registration: _registrations) {
+    if (registration.name() == name) {
+      throw std::runtime_error("Registry: benchmark '" + name + "' is already registered");
+    }
+  }
+  _registrations.emplace_back(std::move(name), std::move(op));
+  return _registrations.back();
+}
+
+// _____________________________________________________________________________________________________________________
+std::vector<const Registration *> Registry::matching(const std::string &filter) const {
+  std::regex regex(filter);
+  std::vector<const Registration *> ret;
+  for (const auto &registration: _registrations) {
+    if (std::regex_search(registration.name(), regex)) {
+      ret.push_back(&registration);
+    }
+  }
+  return ret;
+}
+
+// _____________________________________________________________________________________________________________________
+const std::deque<Registration> &Registry::registrations() const {
+  return _registrations;
+}
+
+// _____________________________________________________________________________________________________________________
+size_t Registry::size() const {
+  return _registrations.size();
+}
+
+// _____________________________________________________________________________________________________________________
+void Registry::clear() {
+  _registrations.clear();
+}
+
+
+// ===== command line ==================================================================================================
+// _____________________________________________________________________________________________________________________
+RunOptions parseArguments(int argc, const char *const *argv) {
+  RunOptions options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    size_t eq = arg.find('=');
+    std::string option = arg.substr(0, eq);
+    bool hasValue = eq != std::string::npos;
+    std::string value = hasValue ? arg.substr(eq + 1) : "";
+    if (option == "--list" && !hasValue) {
+      options.list = true;
+    } else if (option == "--perf-counters" && !hasValue) {
+      options.perfCounters = true;
+    } else if (option == "--lock-memory" && !hasValue) {
+      options.lockMemory = true;
+    } else if (option == "--isolate" && !hasValue) {
+      options.isolation = Isolation::BENCHMARK;
+    } else if ((option == "--help" || option == "-h") && !hasValue) {
+      options.help = true;
+    } else if (!hasValue) {
+      throw std::runtime_error("unknown option '" + arg + "'");
+    } else if (option == "--filter") {
+      try {
+        std::regex check(value);
+      } catch (const std::regex_error &e) {
+        throw std::runtime_error("invalid value for --filter: '" + value + "' (" + e.what() + ")");
+      }
+      options.filter = value;
+    } else if (option == "--repetitions") {
+      options.repetitions = parseUnsigned(option, value);
+      if (options.repetitions == 0) { throw std::runtime_error("--repetitions must be at least 1"); }
+    } else if (option == "--min-time") {
+      options.minTime = parseDuration(option, value);
+    } else if (option == "--threads") {
+      options.threadCounts.clear();
+      std::stringstream ss(value);
+      std::string count;
+      while (std::getline(ss, count, ',')) {
+        options.threadCounts.push_back(parseUnsigned(option, count));
+        if (options.threadCounts.back() == 0) { throw std::runtime_error("--threads: thread counts must be positive"); }
+      }
+      if (options.threadCounts.empty()) { throw std::runtime_error("invalid value for --threads: '" + value + "'"); }
+    } else if (option == "--format") {
+      options.format = value;
+    } else if (option == "--baseline") {
+      options.baseline = value;
+    } else if (option == "--threshold") {
+      options.compare.threshold = parseDouble(option, value);
+    } else if (option == "--alpha") {
+      options.compare.alpha = parseDouble(option, value);
+      if (options.compare.alpha >= 1) { throw std::runtime_error("--alpha must be below 1"); }
+    } else if (option == "--isolate") {
+      if (value == "benchmark") {
+        options.isolation = Isolation::BENCHMARK;
+      } else if (value == "repetition") {
+        options.isolation = Isolation::REPETITION;
+      } else if (value == "none") {
+        options.isolation = Isolation::NONE;
+      } else {
+        throw std::runtime_error("invalid value for --isolate: '" + value + "'");
+      }
+    } else if (option == "--timeout") {
+      options.timeout = parseDuration(option, value);
+    } else if (option == "--pin-cpu") {
+      options.pinCpu = static_cast<int>(parseUnsigned(option, value, std::numeric_limits<int>::max()));
+    } else if (option == "--realtime-priority") {
+      options.realtimePriority = static_cast<int>(parseUnsigned(option, value, std::numeric_limits<int>::max()));
+      if (options.realtimePriority < 1 || options.realtimePriority > 99) {
+        throw std::runtime_error("--realtime-priority must be between 1 and 99");
+      }
+    } else {
+      throw std::runtime_error("unknown option '" + arg + "'");
+    }
+  }
+  // runRegistered() compares plain results only, in scaling mode it would silently compare nothing
+  if (!options.baseline.empty() && !options.threadCounts.empty()) {
+    throw std::runtime_error("--baseline cannot be combined with --threads");
+  }
+  // only child processes can be killed
+  if (options.timeout.count() > 0 && options.isolation == Isolation::NONE) {
+    throw std::runtime_error("--timeout needs --isolate");
+  }
+  return options;
+}
+
+// _____________________________________________________________________________________________________________________
+std::string usage(const std::string &program) {
+  std::stringstream ss;
+  ss << "Usage: " << program << " [options]\n"
+     << "  --filter=REGEX       run benchmarks whose name matches REGEX only (default: .*)\n"
+     << "  --repetitions=N      run every benchmark N times (default: 1)\n"
+     << "  --min-time=TIME      adaptive iterations, sample for at least TIME (e.g. 500ms, 2s)\n"
+     << "  --threads=N[,N...]   run every benchmark concurrently with N threads (scaling mode)\n"
+     << "  --format=FORMAT      output format: console (default), json, csv (raw samples) or binary (raw samples)\n"
+     << "  --baseline=FILE      compare with a baseline written with --format=binary, exit with 2 on regressions\n"
+     << "  --threshold=X        relative median change that counts as regression or improvement (default: 0.05)\n"
+     << "  --alpha=X            significance level of the Mann-Whitney U test (default: 0.05)\n"
+     << "  --perf-counters      count cycles, instructions, cache and branch misses per op (Linux perf_event_open)\n"
+     << "  --pin-cpu=N          pin the benchmark thread to core N (Linux)\n"
+     << "  --realtime-priority=N run the benchmark thread with SCHED_FIFO priority N (1-99, Linux, needs privileges)\n"
+     << "  --lock-memory        lock all memory of the process with mlockall (Linux, needs privileges)\n"
+     << "  --isolate[=MODE]     run every benchmark (MODE benchmark, default) or repetition (MODE repetition) in a\n"
+     << "                       fresh child process (POSIX)\n"
+     << "  --timeout=TIME       kill isolated benchmarks that run longer than TIME (e.g. 30s, needs --isolate)\n"
+     << "  --list               list matching benchmarks without running them\n"
+     << "  --help               print this message\n";
+  return ss.str();
+}
+
+// _____________________________________________________________________________________________________________________
+int runRegistered(const RunOptions &options, std::ostream &os, const Registry &registry) {
+  std::regex regex(options.filter);
+  // matching instances grouped by registration
+  std::vector<std::pair<const Registration *, std::vector<Instance>>> selected;
+  for (const auto &registration: registry.registrations()) {
+    std::vector<Instance> instances;
+    for (auto &instance: registration.instances()) {
+      if (std::regex_search(instance.name, regex)) { instances.push_back(std::move(instance)); }
+    }
+    if (!instances.empty()) { selected.emplace_back(&registration, std::move(instances)); }
+  }
+  if (selected.empty()) {
+    std::cerr << "No benchmark matches '" << options.filter << "'" << std::endl;
+    return 1;
+  }
+  if (options.list) {
+    for (const auto &[registration, instances]: selected) {
+      for (const auto &instance: instances) {
+        os << instance.name << "\n";
+      }
+    }
+    return 0;
+  }
+  // child processes send raw samples only, a histogram-only benchmark would fail every isolated run
+  if (options.isolation != Isolation::NONE && options.threadCounts.empty()) {
+    for (const auto &[registration, instances]: selected) {
+      for (const auto &instance: instances) {
+        if (instance.config.histogram || instance.config.sink) {
+          throw std::runtime_error("'" + instance.name + "' keeps histograms only (Config::histogram or Config::sink), "
+                                   "it cannot run with --isolate");
+        }
+      }
+    }
+  }
+  // load the baseline first, a missing file should not waste a whole run
+  std::vector<Result> baseline;
+  if (!options.baseline.empty()) { baseline = loadBaseline(options.baseline); }
+  std::vector<Result> results;
+  bool allocationLimitExceeded = false;
+  bool isolatedRunFailed = false;
+  auto reporter = makeReporter(options.format, os);
+  reporter->begin();
+  for (auto &[registration, instances]: selected) {
+    std::vector<std::pair<Arguments, Time>> meanTimes;
+    for (auto &instance: instances) {
+      applyOptions(instance.config, options);
+      std::vector<Config> configs(options.repetitions, instance.config);
+      for (unsigned repetition = 0; options.repetitions > 1 && repetition < options.repetitions; ++repetition) {
+        configs[repetition].title = instance.name + " [" + std::to_string(repetition + 1) + "/" +
+                                    std::to_string(options.repetitions) + "]";
+      }
+      if (!options.threadCounts.empty()) {
+        for (const auto &config: configs) {
+          Benchmark benchmark(config, instance.op, instance.precedentOp);
+          reporter->report(config.title, benchmark.runScaling());
+        }
+        continue;
+      }
+      auto report = [&](const Config &config, const Result &result) {
+        reporter->report(result);
+        meanTimes.emplace_back(instance.arguments, result.meanAdjustedWallTime());
+        if (!options.baseline.empty()) { results.push_back(result); }
+        if (!checkAllocations(config, result)) { allocationLimitExceeded = true; }
+      };
+      if (options.isolation == Isolation::NONE) {
+        // every repetition is reported as soon as it finished
+        for (const auto &config: configs) {
+          Benchmark benchmark(config, instance.op, instance.precedentOp);
+          report(config, benchmark.run());
+        }
+        continue;
+      }
+      // repetitions that run together: all of them in one child process, else one by one
+      std::vector<std::vector<Config>> groups;
+      if (options.isolation == Isolation::BENCHMARK) {
+        groups.push_back(configs);
+      } else {
+        for (const auto &config: configs) { groups.push_back({config}); }
+      }
+      for (const auto &group: groups) {
+        auto run = runIsolated([&instance, &group]() { return runConfigs(instance, group); }, options.timeout);
+        if (!run.ok()) {
+          std::cerr << "Benchmark '" << group.front().title << "' failed: " << run.error << std::endl;
+          isolatedRunFailed = true;
+          continue;
+        }
+        for (size_t i = 0; i < run.results.size() && i < group.size(); ++i) {
+          report(group[i], run.results[i]);
+        }
+      }
+    }
+    if (registration->complexityArgument() >= 0 && !meanTimes.empty()) {
+      reportComplexity(*reporter, registration->name(), static_cast<size_t>(registration->complexityArgument()),
+                       meanTimes);
+    }
+  }
+  reporter->end();
+  os << std::flush;
+  int status = isolatedRunFailed ? 4 : allocationLimitExceeded ? 3 : 0;
+  if (options.baseline.empty()) { return status; }
+  auto comparisons = compare(baseline, results, options.compare);
+  std::ostream &out = options.format == "console" ? os : std::cerr;
+  for (const auto &comparison: comparisons) {
+    out << comparison;
+  }
+  out << std::flush;
+  return hasRegression(comparisons) ? 2 : status;
+}
+
+// _____________________________________________________________________________________________________________________
+int runMain(int argc, const char *const *argv) {
+  std::string program = argc > 0 ? argv[0] : "benchmark";
+  try {
+    RunOptions options = parseArguments(argc, argv);
+    if (options.help) {
+      std::cout << usage(program);
+      return 0;
+    }
+    return runRegistered(options, std::cout);
+  } catch (const std::exception &e) {
+    std::cerr << program << ": " << e.what() << "\n" << usage(program);
+    return 1;
+  }
+}
+
+}  // namespace benchmark
+}  // namespace timed
@@ -0,0 +1,155 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <iostream>
+#include <stdexcept>
+
+#include "timed/Export.h"
+#include "timed/Reporter.h"
+
+namespace timed {
+namespace benchmark {
+
+// ===== ConsoleReporter ===============================================================================================
+// _____________________________________________________________________________________________________________________
+ConsoleReporter::ConsoleReporter(std::ostream &os) : _os(os) {}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::report(const Result &result) {
+  _os << result << "\n";
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::report(const std::string &name, const std::vector<ScalingResult> &results) {
+  _os << "Benchmark: '" << name << "' (scaling)\n";
+  for (const auto &result: results) {
+    _os << result;
+  }
+  _os << "\n";
+}
+
+// _____________________________________________________________________________________________________________________
+void ConsoleReporter::report(const std::string &name, const utils::ComplexityFit &fit) {
+  _os << "Complexity: '" << name << "'\n";
+  _os << "  best fit:  " << utils::toString(fit.complexity) << "\n";
+  _os << "  coef:      " << fit.coefficient << "ns\n";
+  _os << "  RMS:       " << fit.rms << "ns (" << 100 * fit.relativeRms << "%)\n\n";
+}
+
+
+// ===== JsonReporter ==================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+JsonReporter::JsonReporter(std::ostream &os) : _os(os) {}
+
+// _____________________________________________________________________________________________________________________
+void JsonReporter::begin() {
+  _os << "{\"benchmarks\": [";
+  _first = true;
+}
+
+// _____________________________________________________________________________________________________________________
+void JsonReporter::report(const Result &result) {
+  _separate();
+  writeJson(_os, result);
+}
+
+// _____________________________________________________________________________________________________________________
+void JsonReporter::report(const std::string &, const std::vector<ScalingResult> &results) {
+  for (const auto &result: results) {
+    _separate();
+    writeJson(_os, result);
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void JsonReporter::report(const std::string &name, const utils::ComplexityFit &fit) {
+  _separate();
+  writeJson(_os, name, fit);
+}
+
+// _____________________________________________________________________________________________________________________
+void JsonReporter::end() {
+  _os << (_first ? "" : "\n") << "]}\n";
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void JsonReporter::_separate() {
+  _os << (_first ? "\n  " : ",\n  ");
+  _first = false;
+}
+
+
+// ===== CsvReporter ===================================================================================================
+// _____________________________________________________________________________________________________________________
+CsvReporter::CsvReporter(std::ostream &os) : _os(os) {}
+
+// _____________________________________________________________________________________________________________________
+void CsvReporter::begin() {
+  writeCsvHeader(_os);
+}
+
+// _____________________________________________________________________________________________________________________
+void CsvReporter::report(const Result &result) {
+  writeCsv(_os, result);
+}
+
+// _____________________________________________________________________________________________________________________
+void CsvReporter::report(const std::string &, const std::vector<ScalingResult> &results) {
+  for (const auto &result: results) {
+    writeCsv(_os, result.latencies);
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void CsvReporter::report(const std::string &, const utils::ComplexityFit &) {}
+
+
+// ===== BinaryReporter ================================================================================================
+// _____________________________________________________________________________________________________________________
+BinaryReporter::BinaryReporter(std::ostream &os) : _os(os) {}
+
+// _____________________________________________________________________________________________________________________
+void BinaryReporter::report(const Result &result) {
+  if (result.histogramOnly) {
+    std::cerr << "BinaryReporter: '" << result.title << "' is histogram-only and has no raw samples to report"
+              << std::endl;
+    return;
+  }
+  writeSamples(_os, result);
+}
+
+// _____________________________________________________________________________________________________________________
+void BinaryReporter::report(const std::string &, const std::vector<ScalingResult> &results) {
+  for (const auto &result: results) {
+    writeSamples(_os, result.latencies);
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+void BinaryReporter::report(const std::string &, const utils::ComplexityFit &) {}
+
+
+// ===== makeReporter ==================================================================================================
+// _____________________________________________________________________________________________________________________
+std::unique_ptr<Reporter> makeReporter(const std::string &format, std::ostream &os) {
+  if (format == "console") {
+    return std::make_unique<ConsoleReporter>(os);
+  }
+  if (format == "json") {
+    return std::make_unique<JsonReporter>(os);
+  }
+  if (format == "csv") {
+    return std::make_unique<CsvReporter>(os);
+  }
+  if (format == "binary") {
+    return std::make_unique<BinaryReporter>(os);
+  }
+  throw std::runtime_error("unknown output format '" + format + "'");
+}
+
+}  // namespace benchmark
+}  // namespace timed
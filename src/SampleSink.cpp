@@ -0,0 +1,303 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TIMED_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "timed/SampleSink.h"
+
+namespace timed {
+namespace benchmark {
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'I', 'M', 'E', 'D', 'M', 'A', 'P'};
+constexpr uint32_t VERSION = 1;
+// header: magic, uint32 version, uint32 columns, uint64 counts[3]
+constexpr size_t VERSION_OFFSET = 8;
+constexpr size_t COLUMNS_OFFSET = 12;
+constexpr size_t COUNTS_OFFSET = 16;
+
+// _____________________________________________________________________________________________________________________
+size_t pageSize() {
+#ifdef TIMED_HAS_MMAP
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 4096;
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+size_t valueOffset(uint64_t index, unsigned columns, unsigned column) {
+  return MmapSampleSink::HEADER_BYTES + (index * columns + column) * sizeof(int64_t);
+}
+
+}  // namespace
+
+// ===== MmapSampleSink ================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+MmapSampleSink::MmapSampleSink(std::string path, size_t regionBytes, bool hugePages)
+    : _path(std::move(path)), _hugePages(hugePages) {
+  size_t page = pageSize();
+  _regionBytes = std::max((regionBytes + page - 1) / page * page, page);
+}
+
+// _____________________________________________________________________________________________________________________
+MmapSampleSink::~MmapSampleSink() {
+  _close();
+}
+
+// _____________________________________________________________________________________________________________________
+void MmapSampleSink::begin(unsigned columns) {
+#ifdef TIMED_HAS_MMAP
+  if (columns < 2 || columns > 3) {
+    throw std::runtime_error("MmapSampleSink: invalid column count " + std::to_string(columns));
+  }
+  if (_fd >= 0) {
+    throw std::runtime_error("MmapSampleSink: '" + _path + "' is already in use");
+  }
+  _fd = ::open(_path.c_str(), O_RDWR | O_CREAT | (_begun ? 0 : O_TRUNC), 0644);
+  if (_fd < 0) {
+    throw std::runtime_error("MmapSampleSink: cannot create '" + _path + "': " + std::strerror(errno));
+  }
+  struct stat st{};
+  _fileBytes = fstat(_fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+  _columns = columns;
+  _mapRegion(0);
+  char *header = _regions.front();
+  _counts = reinterpret_cast<uint64_t *>(header + COUNTS_OFFSET);
+  if (!_begun) {
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + VERSION_OFFSET, &VERSION, sizeof(VERSION));
+    std::memcpy(header + COLUMNS_OFFSET, &_columns, sizeof(_columns));
+    std::fill(_counts, _counts + 3, 0);
+    _begun = true;
+    return;
+  }
+  // a later run: continue after the last row of the previous one
+  uint32_t fileColumns = 0;
+  std::memcpy(&fileColumns, header + COLUMNS_OFFSET, sizeof(fileColumns));
+  uint64_t first = *std::min_element(_counts, _counts + columns);
+  uint64_t last = *std::max_element(_counts, _counts + columns);
+  if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || fileColumns != columns ||
+      valueOffset(last, columns, 0) > _fileBytes) {
+    munmap(header, _regionBytes);
+    _regions.clear();
+    _counts = nullptr;
+    _columns = 0;
+    ::close(_fd);
+    _fd = -1;
+    throw std::runtime_error("MmapSampleSink: cannot append " + std::to_string(columns) + " columns to '" + _path +
+                             "' (changed by someone else or written with another column count)");
+  }
+  // the regions the columns write to next, those before stay unmapped
+  size_t from = std::max<size_t>(valueOffset(first, columns, 0) / _regionBytes, 1);
+  size_t to = valueOffset(last, columns, columns - 1) / _regionBytes;
+  for (size_t region = from; region <= to; ++region) {
+    _mapRegion(region);
+  }
+#else
+  (void) columns;
+  throw std::runtime_error("MmapSampleSink: memory-mapped files are not supported on this platform");
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void MmapSampleSink::add(Column column, Time time) {
+  if (column >= _columns) {
+    throw std::runtime_error("MmapSampleSink: column " + std::to_string(column) + " was not announced by begin()");
+  }
+  size_t offset = valueOffset(_counts[column], _columns, column);
+  size_t region = offset / _regionBytes;
+  while (region >= _regions.size()) {
+    _mapRegion(_regions.size());
+  }
+  int64_t value = time.count();
+  std::memcpy(_regions[region] + offset % _regionBytes, &value, sizeof(value));
+  ++_counts[column];
+}
+
+// _____________________________________________________________________________________________________________________
+void MmapSampleSink::flush() {
+#ifdef TIMED_HAS_MMAP
+  for (char *region: _regions) {
+    if (region) { msync(region, _regionBytes, MS_SYNC); }
+  }
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void MmapSampleSink::end() {
+  _close();
+}
+
+// _____________________________________________________________________________________________________________________
+size_t MmapSampleSink::size(Column column) const {
+  return column < _columns ? _counts[column] : 0;
+}
+
+// _____________________________________________________________________________________________________________________
+const std::string &MmapSampleSink::path() const {
+  return _path;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+void MmapSampleSink::_mapRegion(size_t index) {
+#ifdef TIMED_HAS_MMAP
+  auto offset = static_cast<off_t>(index * _regionBytes);
+  size_t end = (index + 1) * _regionBytes;
+  // never shrink: the file may hold the samples of earlier runs behind this region
+  if (end > _fileBytes) {
+    if (ftruncate(_fd, static_cast<off_t>(end)) != 0) {
+      throw std::runtime_error("MmapSampleSink: cannot grow '" + _path + "': " + std::strerror(errno));
+    }
+    _fileBytes = end;
+  }
+  void *mapped = mmap(nullptr, _regionBytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, offset);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("MmapSampleSink: cannot map '" + _path + "': " + std::strerror(errno));
+  }
+#ifdef MADV_HUGEPAGE
+  // before the pages are touched, the kernel can only use huge pages for pages that are not faulted yet
+  if (_hugePages) { madvise(mapped, _regionBytes, MADV_HUGEPAGE); }
+#endif
+  // pre-fault: write every page once now instead of on the first sample that lands in it (writing back the value read
+  // keeps the samples of earlier runs)
+  auto *bytes = static_cast<volatile char *>(mapped);
+  size_t page = pageSize();
+  for (size_t i = 0; i < _regionBytes; i += page) {
+    bytes[i] = bytes[i];
+  }
+  if (index >= _regions.size()) { _regions.resize(index + 1, nullptr); }
+  _regions[index] = static_cast<char *>(mapped);
+  // a row is smaller than a page, so a column lags behind the others by at most one region: all columns have passed
+  // the region before the previous one, it is not written again. The first region holds the header counts.
+  if (index >= 3 && _regions[index - 2]) {
+    munmap(_regions[index - 2], _regionBytes);
+    _regions[index - 2] = nullptr;
+  }
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+void MmapSampleSink::_close() {
+#ifdef TIMED_HAS_MMAP
+  if (_fd < 0) { return; }
+  uint64_t rows = _counts ? *std::max_element(_counts, _counts + 3) : 0;
+  auto used = static_cast<off_t>(valueOffset(rows, _columns, 0));
+  for (char *region: _regions) {
+    if (region) { munmap(region, _regionBytes); }
+  }
+  _regions.clear();
+  _counts = nullptr;
+  _columns = 0;
+  // best effort: the file is still readable with trailing unused space
+  (void) ftruncate(_fd, used);
+  ::close(_fd);
+  _fd = -1;
+#endif
+}
+
+
+// ===== MappedSampleFile ==============================================================================================
+// _____________________________________________________________________________________________________________________
+MappedSampleFile::MappedSampleFile(const std::string &path) {
+#ifdef TIMED_HAS_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("MappedSampleFile: cannot open '" + path + "': " + std::strerror(errno));
+  }
+  struct stat st{};
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < MmapSampleSink::HEADER_BYTES) {
+    ::close(fd);
+    throw std::runtime_error("MappedSampleFile: '" + path + "' is no sample file");
+  }
+  _bytes = static_cast<size_t>(st.st_size);
+  void *mapped = mmap(nullptr, _bytes, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("MappedSampleFile: cannot map '" + path + "': " + std::strerror(errno));
+  }
+  _data = static_cast<const char *>(mapped);
+#ifdef MADV_SEQUENTIAL
+  madvise(mapped, _bytes, MADV_SEQUENTIAL);
+#endif
+  uint32_t version = 0;
+  std::memcpy(&version, _data + VERSION_OFFSET, sizeof(version));
+  std::memcpy(&_columns, _data + COLUMNS_OFFSET, sizeof(_columns));
+  std::memcpy(_counts, _data + COUNTS_OFFSET, sizeof(_counts));
+  bool valid = std::memcmp(_data, MAGIC, sizeof(MAGIC)) == 0 && version == VERSION && _columns >= 2 && _columns <= 3;
+  for (unsigned column = 0; valid && column < 3; ++column) {
+    uint64_t count = _counts[column];
+    // the last value of a column must lie completely inside the file
+    valid = column < _columns ? count == 0 || valueOffset(count - 1, _columns, column) + sizeof(int64_t) <= _bytes
+                              : count == 0;
+  }
+  if (!valid) {
+    munmap(const_cast<char *>(_data), _bytes);
+    _data = nullptr;
+    throw std::runtime_error("MappedSampleFile: '" + path + "' is no sample file or corrupt");
+  }
+#else
+  throw std::runtime_error("MappedSampleFile: memory-mapped files are not supported on this platform ('" + path +
+                           "')");
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+MappedSampleFile::~MappedSampleFile() {
+#ifdef TIMED_HAS_MMAP
+  if (_data) { munmap(const_cast<char *>(_data), _bytes); }
+#endif
+}
+
+// _____________________________________________________________________________________________________________________
+unsigned MappedSampleFile::columns() const {
+  return _columns;
+}
+
+// _____________________________________________________________________________________________________________________
+size_t MappedSampleFile::size(SampleSink::Column column) const {
+  return column < 3 ? _counts[column] : 0;
+}
+
+// _____________________________________________________________________________________________________________________
+Time MappedSampleFile::at(SampleSink::Column column, size_t index) const {
+  if (index >= size(column)) {
+    throw std::out_of_range("MappedSampleFile: index " + std::to_string(index) + " out of range");
+  }
+  int64_t value = 0;
+  std::memcpy(&value, _data + valueOffset(index, _columns, column), sizeof(value));
+  return Time::fromNanoseconds(value);
+}
+
+// _____________________________________________________________________________________________________________________
+utils::Histogram MappedSampleFile::histogram(SampleSink::Column column, Time baseline,
+                                             unsigned significantDigits) const {
+  utils::Histogram histogram(significantDigits);
+  size_t count = size(column);
+  for (size_t i = 0; i < count; ++i) {
+    int64_t value = 0;
+    std::memcpy(&value, _data + valueOffset(i, _columns, column), sizeof(value));
+    histogram.record(Time::fromNanoseconds(value) - baseline);
+  }
+  return histogram;
+}
+
+}  // namespace benchmark
+}  // namespace timed
@@ -20,68 +20,27 @@ TimeValueUnit::TimeValueUnit(double v, std::string u) {
 
 // ===== Time ====================================================================================================
 // ----- public ________________________________________________________________________________________________________
-// _____________________________________________________________________________________________________________________
-Time::Time(uint64_t days,
-           uint64_t hours,
-           uint64_t minutes,
-           uint64_t seconds,
-           uint64_t milliseconds,
-           uint64_t microseconds,
-           uint64_t nanoseconds) {
-  _days = days;
-  _hours = hours;
-  _minutes = minutes;
-  _seconds = seconds;
-  _milliseconds = milliseconds;
-  _microseconds = microseconds;
-  _nanoseconds = nanoseconds;
-  _normalize();
-}
-
 // _____________________________________________________________________________________________________________________
 Time::Time(const TimeValueUnit& timeVU) {
-  if (timeVU.unit == "days" || timeVU.unit == "d") {
-    _nanoseconds = static_cast<uint64_t>(std::round(timeVU.value * 24 * 60 * 60 * 1000 * 1000 * 1000));
-  }
-  if (timeVU.unit == "hours" || timeVU.unit == "h") {
-    _nanoseconds = static_cast<uint64_t>(std::round(timeVU.value * 60 * 60 * 1000 * 1000 * 1000));
-  }
-  if (timeVU.unit == "minutes" || timeVU.unit == "m") {
-    _nanoseconds = static_cast<uint64_t>(std::round(timeVU.value * 60 * 1000 * 1000 * 1000));
-  }
-  if (timeVU.unit == "seconds" || timeVU.unit == "s") {
-    _nanoseconds = static_cast<uint64_t>(std::round(timeVU.value * 1000 * 1000 * 1000));
-  }
-  if (timeVU.unit == "milliseconds" || timeVU.unit == "ms") {
-    _nanoseconds = static_cast<uint64_t>(std::round(timeVU.value * 1000 * 1000));
-  }
-  if (timeVU.unit == "microseconds" || timeVU.unit == "us") {
-    _nanoseconds = static_cast<uint64_t>(std::round(timeVU.value * 1000));
-  }
-  if (timeVU.unit == "nanoseconds" || timeVU.unit == "ns") {
-    _nanoseconds = static_cast<uint64_t>(std::round(timeVU.value));
-  }
+  double factor = 0;
+  if (timeVU.unit == "days" || timeVU.unit == "d") { factor = NS_PER_D; }
+  if (timeVU.unit == "hours" || timeVU.unit == "h") { factor = NS_PER_H; }
+  if (timeVU.unit == "minutes" || timeVU.unit == "m") { factor = NS_PER_M; }
+  if (timeVU.unit == "seconds" || timeVU.unit == "s") { factor = NS_PER_S; }
+  if (timeVU.unit == "milliseconds" || timeVU.unit == "ms") { factor = NS_PER_MS; }
+  if (timeVU.unit == "microseconds" || timeVU.unit == "us") { factor = NS_PER_US; }
+  if (timeVU.unit == "nanoseconds" || timeVU.unit == "ns") { factor = 1; }
+  _ns = static_cast<int64_t>(std::round(timeVU.value * factor));
 }
 
 // _____________________________________________________________________________________________________________________
 Time::Time(const std::string& time, const std::string& fmt) {
   parseTime(time, fmt);
-  _normalize();
-}
-
-// _____________________________________________________________________________________________________________________
-void Time::reset() {
-  _days = 0;
-  _hours = 0;
-  _minutes = 0;
-  _seconds = 0;
-  _milliseconds = 0;
-  _microseconds = 0;
-  _nanoseconds = 0;
 }
 
 // _____________________________________________________________________________________________________________________
 void Time::parseTime(const std::string& time, const std::string& fmt) {
+  Components comp = _components();
   bool lastPercent = false;
   int timeIndex = 0;
 
@@ -105,13 +64,13 @@ void Time::parseTime(const std::string& time, const std::string& fmt) {
       }
       case 'd': {
         if (!lastPercent) { throw std::runtime_error("Invalid time format: " + fmt); }
-        _days = toValue();
+        comp.days = toValue();
         lastPercent = false;
         break;
       }
       case 'h': {
         if (!lastPercent) { throw std::runtime_error("Invalid time format: " + fmt); }
-        _hours = toValue();
+        comp.hours = toValue();
         lastPercent = false;
         break;
       }
@@ -120,30 +79,30 @@ void Time::parseTime(const std::string& time, const std::string& fmt) {
         // catch milliseconds
         if (fmt[i+1] == 's') {
           i++;
-          _milliseconds = toValue();
+          comp.milliseconds = toValue();
         }
         else {
-          _minutes = toValue();
+          comp.minutes = toValue();
         }
         lastPercent = false;
         break;
       }
       case 's': {
         if (!lastPercent) { throw std::runtime_error("Invalid time format: " + fmt); }
-        _seconds = toValue();
+        comp.seconds = toValue();
         lastPercent = false;
         break;
       }
       case 'u': {
         if (!lastPercent || fmt[i+1] != 's') { throw std::runtime_error("Invalid time format: " + fmt); }
         i++;
-        _microseconds = toValue();
+        comp.microseconds = toValue();
         lastPercent = false;
         break;
       }
       case 'n': {
         if (!lastPercent || fmt[i+1] != 's') { throw std::runtime_error("Invalid time format: " + fmt); }
-        _nanoseconds = toValue();
+        comp.nanoseconds = toValue();
         lastPercent = false;
         break;
       }
@@ -152,22 +111,29 @@ void Time::parseTime(const std::string& time, const std::string& fmt) {
       }
     }
   }
+  _ns = Time(comp.days, comp.hours, comp.minutes, comp.seconds, comp.milliseconds, comp.microseconds,
+             comp.nanoseconds)._ns;
 }
 
 // _____________________________________________________________________________________________________________________
 // TODO: fix this: if no superior unit of a provided unit is provided -> calculate superior units into unit.
 //  e.g.: h is provided but d is not provided -> consider d as part of h: (h: 2, d: 1 -> h = 2 + 24 = 26)
 std::string Time::format(const std::string& fmt) const {
+  Components comp = _components();
   if (fmt == "auto") {
     std::string autofmt;
-    if (_days > 0 || _hours > 0) {
+    if (comp.days > 0 || comp.hours > 0) {
       autofmt = "%dd:%hh:%mm-%ss";
       return format(autofmt);
     }
-    if (_seconds > 0 || _milliseconds > 0) {
-      autofmt = "%mm%ss%msms";
+    if (comp.seconds > 0 || comp.milliseconds > 0) {
+      autofmt = "%mm%ss%msms%usus";
       return format(autofmt);
     }
+    // the components are not cumulative, dropping the microseconds would print 1210ns as 210ns
+    if (comp.microseconds > 0) {
+      return format("%usus%nsns");
+    }
     return format("%nsns");
   }
 
@@ -182,7 +148,7 @@ std::string Time::format(const std::string& fmt) const {
       }
       case 'd': {
         if (lastPercent) {
-          ret += std::to_string(_days);
+          ret += std::to_string(comp.days);
           lastPercent = false;
           break;
         }
@@ -190,10 +156,10 @@ std::string Time::format(const std::string& fmt) const {
       case 'h': {
         if (lastPercent) {
           if (fmt.find("%d") != std::string::npos) {
-            ret += std::to_string(_days * 24 + _hours);
+            ret += std::to_string(comp.days * 24 + comp.hours);
           }
           else {
-            ret += std::to_string(_hours);
+            ret += std::to_string(comp.hours);
           }
           lastPercent = false;
           break;
@@ -204,16 +170,16 @@ std::string Time::format(const std::string& fmt) const {
           // catch milliseconds
           if (fmt[i + 1] == 's') {
             i++;
-            ret += std::to_string(_milliseconds);
+            ret += std::to_string(comp.milliseconds);
           } else {
             if (fmt.find("%d") != std::string::npos && fmt.find("%h") != std::string::npos) {
-              ret += std::to_string(_days * 24 * 60 + _hours * 60 + _minutes);
+              ret += std::to_string(comp.days * 24 * 60 + comp.hours * 60 + comp.minutes);
             }
             else if (fmt.find("%h") != std::string::npos) {
-              ret += std::to_string(_hours * 60 + _minutes);
+              ret += std::to_string(comp.hours * 60 + comp.minutes);
             }
             else {
-              ret += std::to_string(_minutes);
+              ret += std::to_string(comp.minutes);
             }
           }
           lastPercent = false;
@@ -222,7 +188,7 @@ std::string Time::format(const std::string& fmt) const {
       }
       case 's': {
         if (lastPercent) {
-          ret += std::to_string(_seconds);
+          ret += std::to_string(comp.seconds);
           lastPercent = false;
           break;
         }
@@ -230,7 +196,7 @@ std::string Time::format(const std::string& fmt) const {
       case 'u': {
         if (lastPercent && fmt[i+1] == 's') {
           ++i;
-          ret += std::to_string(_microseconds);
+          ret += std::to_string(comp.microseconds);
           lastPercent = false;
           break;
         }
@@ -238,7 +204,7 @@ std::string Time::format(const std::string& fmt) const {
       case 'n': {
         if (lastPercent && fmt[i+1] == 's') {
           ++i;
-          ret += std::to_string(_nanoseconds);
+          ret += std::to_string(comp.nanoseconds);
           lastPercent = false;
           break;
         }
@@ -266,33 +232,34 @@ double Time::timeInUnit(const std::string& unit) const {
 
 // _____________________________________________________________________________________________________________________
 TimeValueUnit Time::getTime() const {
+  Components comp = _components();
   TimeValueUnit tvu;
-  if (_days > 4) {
+  if (comp.days > 4) {
     tvu.value = getDays();
     tvu.unit = "d";
     return tvu;
   }
-  if (_days > 0 || _hours > 12) {
+  if (comp.days > 0 || comp.hours > 12) {
     tvu.value = getHours();
     tvu.unit = "h";
     return tvu;
   }
-  if (_minutes > 10) {
+  if (comp.minutes > 10) {
     tvu.value = getMinutes();
     tvu.unit = "m";
     return tvu;
   }
-  if (_seconds > 10) {
+  if (comp.seconds > 10) {
     tvu.value = getSeconds();
     tvu.unit = "s";
     return tvu;
   }
-  if (_milliseconds > 500) {
+  if (comp.milliseconds > 500) {
     tvu.value = getMilliseconds();
     tvu.unit = "ms";
     return tvu;
   }
-  if (_microseconds > 500) {
+  if (comp.microseconds > 500) {
     tvu.value = getMicroseconds();
     tvu.unit = "us";
     return tvu;
@@ -302,248 +269,24 @@ TimeValueUnit Time::getTime() const {
   return tvu;
 }
 
-// _____________________________________________________________________________________________________________________
-double Time::getDays() const {
-  auto d = static_cast<double>(_days);
-  d += static_cast<double>(_hours) / 24;
-  d += static_cast<double>(_minutes) / 24 / 60;
-  d += static_cast<double>(_seconds) / 24 / 60 / 60;
-  d += static_cast<double>(_milliseconds) / 24 / 60 / 60 / 1000;
-  d += static_cast<double>(_microseconds) / 24 / 60 / 60 / 1000 / 1000;
-  d += static_cast<double>(_nanoseconds) / 24 / 60 / 60 / 1000 / 1000 / 1000;
-  return d;
-}
-
-// _____________________________________________________________________________________________________________________
-double Time::getHours() const {
-  auto h = static_cast<double>(_hours);
-  h += static_cast<double>(_days) * 24;
-  h += static_cast<double>(_minutes) / 60;
-  h += static_cast<double>(_seconds) / 60 / 60;
-  h += static_cast<double>(_milliseconds) / 60 / 60 / 1000;
-  h += static_cast<double>(_microseconds) / 60 / 60 / 1000 / 1000;
-  h += static_cast<double>(_nanoseconds) / 60 / 60 / 1000 / 1000 / 1000;
-  return h;
-}
-
-// _____________________________________________________________________________________________________________________
-double Time::getMinutes() const {
-  auto m = static_cast<double>(_minutes);
-  m += static_cast<double>(_days) * 24 * 60;
-  m += static_cast<double>(_hours) * 60;
-  m += static_cast<double>(_seconds) / 60;
-  m += static_cast<double>(_milliseconds) / 60 / 1000;
-  m += static_cast<double>(_microseconds) / 60 / 1000 / 1000;
-  m += static_cast<double>(_nanoseconds) / 60 / 1000 / 1000;
-  return m;
-}
-
-// _____________________________________________________________________________________________________________________
-double Time::getSeconds() const {
-  auto s = static_cast<double>(_seconds);
-  s += static_cast<double>(_days) * 24 * 60 * 60;
-  s += static_cast<double>(_hours) * 60 * 60;
-  s += static_cast<double>(_minutes) * 60;
-  s += static_cast<double>(_milliseconds) / 1000;
-  s += static_cast<double>(_microseconds) / 1000 / 1000;
-  s += static_cast<double>(_nanoseconds) / 1000 / 1000 / 1000;
-  return s;
-}
-
-// _____________________________________________________________________________________________________________________
-double Time::getMilliseconds() const {
-  auto ms = static_cast<double>(_milliseconds);
-  ms += static_cast<double>(_days) * 24 * 60 * 60 * 1000;
-  ms += static_cast<double>(_hours) * 60 * 60 * 1000;
-  ms += static_cast<double>(_minutes) * 60 * 1000;
-  ms += static_cast<double>(_seconds) * 1000;
-  ms += static_cast<double>(_microseconds) / 1000;
-  ms += static_cast<double>(_nanoseconds) / 1000 / 1000;
-  return ms;
-}
-
-// _____________________________________________________________________________________________________________________
-double Time::getMicroseconds() const {
-  auto us = static_cast<double>(_microseconds);
-  us += static_cast<double>(_days) * 24 * 60 * 60 * 1000 * 1000;
-  us += static_cast<double>(_hours) * 60 * 60 * 1000 * 1000;
-  us += static_cast<double>(_minutes) * 60 * 1000 * 1000;
-  us += static_cast<double>(_seconds) * 1000 * 1000;
-  us += static_cast<double>(_milliseconds) * 1000;
-  us += static_cast<double>(_nanoseconds) / 1000;
-  return us;
-}
-
-
-// _____________________________________________________________________________________________________________________
-uint64_t Time::getNanoseconds() const {
-  uint64_t ns = _nanoseconds;
-  ns += _days * 24 * 60 * 60 * 1000 * 1000 * 1000;
-  ns += _hours * 60 * 60 * 1000 * 1000 * 1000;
-  ns += _minutes * 60 * 1000 * 1000 * 1000;
-  ns += _seconds * 1000 * 1000 * 1000;
-  ns += _milliseconds * 1000 * 1000;
-  ns += _microseconds * 1000;
-  return ns;
-}
-
-// _____________________________________________________________________________________________________________________
-Time Time::operator+(const Time &t) const {
-  return Time(t._days + _days, t._hours + _hours, t._minutes + _minutes, t._seconds + _seconds,
-                    t._milliseconds + _milliseconds, t._microseconds + _microseconds, t._nanoseconds + _nanoseconds);
-}
-
-// _____________________________________________________________________________________________________________________
-Time Time::operator-(const Time &t) const {
-  if (t > *this) {
-    return Time();
-  }
-  auto ns = getNanoseconds() - t.getNanoseconds();
-  return Time(0, 0, 0, 0, 0, 0, ns);
-}
-
-// _____________________________________________________________________________________________________________________
-template<typename Numeric>
-Time Time::operator*(Numeric value) {
-  return Time(value * _days, value + _hours, value + _minutes, value + _seconds,
-                    value + _milliseconds, value + _microseconds, value + _nanoseconds);
-}
-
-// _____________________________________________________________________________________________________________________
-Time Time::operator*(const Time& t) const {
-  uint64_t ns = getNanoseconds() * t.getNanoseconds();
-  return Time(0, 0, 0, 0, 0, 0, ns);
-}
-
-// _____________________________________________________________________________________________________________________
-template<typename Numeric>
-Time Time::operator/(Numeric value) {
-  uint64_t ns = getNanoseconds() / value;
-  return Time(0, 0, 0, 0, 0, 0, ns);
-}
-
-// _____________________________________________________________________________________________________________________
-Time &Time::operator+=(const Time &t) {
-  _days += t._days;
-  _hours += t._hours;
-  _minutes += t._minutes;
-  _seconds += t._seconds;
-  _milliseconds += t._milliseconds;
-  _microseconds += t._microseconds;
-  _nanoseconds += t._nanoseconds;
-  _normalize();
-  return *this;
-}
-
-// _____________________________________________________________________________________________________________________
-Time &Time::operator+=(uint64_t nanoseconds) {
-  _nanoseconds += nanoseconds;
-  _normalize();
-  return *this;
-}
-
-// _____________________________________________________________________________________________________________________
-Time &Time::operator-=(const Time &t) {
-  _days -= t._days;
-  _hours -= t._hours;
-  _minutes -= t._minutes;
-  _seconds -= t._seconds;
-  _milliseconds -= t._milliseconds;
-  _microseconds -= t._microseconds;
-  _nanoseconds -= t._nanoseconds;
-  _normalize();
-  return *this;
-}
-
-// _____________________________________________________________________________________________________________________
-template<typename Numeric>
-Time &Time::operator*=(Numeric value) {
-  _days *= value;
-  _hours *= value;
-  _minutes *= value;
-  _seconds *= value;
-  _milliseconds *= value;
-  _microseconds *= value;
-  _nanoseconds *= value;
-  _normalize();
-  return *this;
-}
-
-// _____________________________________________________________________________________________________________________
-template<typename Numeric>
-Time &Time::operator/=(Numeric value) {
-  _nanoseconds = std::round(getNanoseconds() / value);
-  _days = 0;
-  _hours = 0;
-  _minutes = 0;
-  _seconds = 0;
-  _milliseconds = 0;
-  _microseconds = 0;
-  _normalize();
-  return *this;
-}
-
-// _____________________________________________________________________________________________________________________
-bool Time::operator==(const Time &t) const {
-  return (getNanoseconds() == t.getNanoseconds());
-}
-
-// _____________________________________________________________________________________________________________________
-bool Time::operator!=(const Time &t) const {
-  return (getNanoseconds() != t.getNanoseconds());
-}
-
-// _____________________________________________________________________________________________________________________
-bool Time::operator>(const Time &t) const {
-  return (getNanoseconds() > t.getNanoseconds());
-}
-
-// _____________________________________________________________________________________________________________________
-bool Time::operator>=(const Time &t) const {
-  return (getNanoseconds() >= t.getNanoseconds());
-}
-
-// _____________________________________________________________________________________________________________________
-bool Time::operator<(const Time &t) const {
-  return (getNanoseconds() <= t.getNanoseconds());
-}
-
-// _____________________________________________________________________________________________________________________
-bool Time::operator<=(const Time &t) const {
-  return (getNanoseconds() <= t.getNanoseconds());
-}
-
-// _____________________________________________________________________________________________________________________
-Time::operator uint64_t () const {
-  return getNanoseconds();
-}
-
-// _____________________________________________________________________________________________________________________
-Time::operator long () const {
-  return static_cast<long>(getNanoseconds());
-}
-
-// _____________________________________________________________________________________________________________________
-Time::operator double () const {
-  return static_cast<double>(getNanoseconds());
-}
-
 // ----- private -------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
-void Time::_normalize() {
-  _nanoseconds = getNanoseconds();
-  _microseconds = _nanoseconds / 1000;
-  _nanoseconds = _nanoseconds - (_microseconds * 1000);
-  _milliseconds = _microseconds / 1000;
-  _microseconds = _microseconds - (_milliseconds * 1000);
-  _seconds = _milliseconds / 1000;
-  _milliseconds = _milliseconds - (_seconds * 1000);
-  _minutes = _seconds / 60;
-  _seconds = _seconds - (_minutes * 60);
-  _hours = _minutes / 60;
-  _minutes = _minutes - (_hours * 60);
-  _days = _hours / 24;
-  _hours = _hours - (_days * 24);
+Time::Components Time::_components() const {
+  Components c;
+  uint64_t rest = _ns < 0 ? 0 : static_cast<uint64_t>(_ns);
+  c.days = rest / NS_PER_D;
+  rest -= c.days * NS_PER_D;
+  c.hours = rest / NS_PER_H;
+  rest -= c.hours * NS_PER_H;
+  c.minutes = rest / NS_PER_M;
+  rest -= c.minutes * NS_PER_M;
+  c.seconds = rest / NS_PER_S;
+  rest -= c.seconds * NS_PER_S;
+  c.milliseconds = rest / NS_PER_MS;
+  rest -= c.milliseconds * NS_PER_MS;
+  c.microseconds = rest / NS_PER_US;
+  c.nanoseconds = rest - c.microseconds * NS_PER_US;
+  return c;
 }
 
 // ----- ostream -------------------------------------------------------------------------------------------------------
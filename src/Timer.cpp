@@ -3,137 +3,132 @@
 //
 // This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
 
-#include <iostream>
-
 #include "timed/Timer.h"
 
+#if TIMED_HAS_TSC && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
 namespace timed {
+namespace detail {
 
-// ===== WallTimer =====================================================================================================
-// ----- public --------------------------------------------------------------------------------------------------------
-// _____________________________________________________________________________________________________________________
-void WallTimer::start() {
-  if (_running) { return; }
-  if (_stopped) reset();
-  _running = true;
-  auto now = std::chrono::steady_clock::now();
-  _intervals.emplace_back(now, now);
-}
+namespace {
 
+#if TIMED_HAS_TSC
 // _____________________________________________________________________________________________________________________
-Time WallTimer::pause() {
-  if (!_running) { return getTime(); }
-  auto now = std::chrono::steady_clock::now();
-  _intervals.back().second = now;
-  _running = false;
-  return Time(0, 0, 0, 0, 0, 0,
-                     std::chrono::duration_cast<std::chrono::nanoseconds>(
-                         _intervals.back().second - _intervals.back().first).count());
+bool hasInvariantTsc() {
+  unsigned regs[4] = {0, 0, 0, 0};
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0x80000000);
+  if (static_cast<unsigned>(info[0]) < 0x80000007) { return false; }
+  __cpuid(info, 0x80000007);
+  regs[3] = static_cast<unsigned>(info[3]);
+#else
+  if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) { return false; }
+  __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+  // CPUID.80000007H:EDX[8]: invariant TSC
+  return (regs[3] & (1U << 8)) != 0;
 }
 
 // _____________________________________________________________________________________________________________________
-Time WallTimer::stop() {
-  if (!_running) { return getTime(); }
-  auto now = std::chrono::steady_clock::now();
-  _intervals.back().second = now;
-  _stopped = true;
-  _running = false;
-  return getTime();
+TscCalibration calibrateTsc() {
+  TscCalibration calibration;
+  if (!hasInvariantTsc()) { return calibration; }
+  // measure ticks over a 20 ms window of std::chrono::steady_clock. The steady clock reading is bracketed by two TSC
+  // reads so the TSC value can be taken from the middle of the bracket.
+  auto sample = [](uint64_t& ns, uint64_t& ticks) {
+    uint64_t before = startTicks(true);
+    ns = steadyTicks();
+    uint64_t after = stopTicks(true);
+    ticks = before + (after - before) / 2;
+  };
+  uint64_t ns0, ticks0, ns1, ticks1;
+  sample(ns0, ticks0);
+  do {
+    sample(ns1, ticks1);
+  } while (ns1 - ns0 < 20 * 1000 * 1000);
+  if (ticks1 <= ticks0) { return calibration; }
+  calibration.invariant = true;
+  calibration.nsPerTick = static_cast<double>(ns1 - ns0) / static_cast<double>(ticks1 - ticks0);
+  return calibration;
 }
-
+#else
 // _____________________________________________________________________________________________________________________
-void WallTimer::calibrate() {
-  WallTimer wt;
-  std::vector<Time> t(1000);
-  for (int i = 0; i < 1000; ++i) {
-    wt.start();
-    t[i] = wt.stop();
-    wt.reset();
-  }
-  _baseLine = utils::mean(t);
+TscCalibration calibrateTsc() {
+  return TscCalibration();
 }
+#endif
+
+}  // namespace
 
 // _____________________________________________________________________________________________________________________
-Time WallTimer::getTime() const {
-  std::chrono::time_point<std::chrono::steady_clock> now;
-  if (_running) {
-    now = std::chrono::steady_clock::now();
-  }
-  Time time;
-  for (auto &interval: _intervals) {
-    if (_running && interval == _intervals.back()) {
-      time += std::chrono::duration_cast<std::chrono::nanoseconds>(now - interval.first).count();
-    }
-    else {
-      time += std::chrono::duration_cast<std::chrono::nanoseconds>(interval.second - interval.first).count();
-    }
-  }
-  return time;
+const TscCalibration &tscCalibration() {
+  static const TscCalibration calibration = calibrateTsc();
+  return calibration;
 }
 
-// ===== CPUTimer ======================================================================================================
-// ----- public --------------------------------------------------------------------------------------------------------
 // _____________________________________________________________________________________________________________________
+uint64_t cpuNanoseconds(CPUClock clock) {
 #ifdef _WIN32
-CPUTimer::CPUTimer() {
-  std::cout << "WARNING: CPU Timer not supported on Windows OS. Consider using WallTimer instead." << std::endl;
-}
+  (void) clock;
+  return static_cast<uint64_t>(1000.0 * 1000.0 * 1000.0 * static_cast<double>(std::clock()) / CLOCKS_PER_SEC);
 #else
-CPUTimer::CPUTimer() = default;
+  timespec ts{};
+  clock_gettime(clock == CPUClock::THREAD ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000 * 1000 * 1000 + static_cast<uint64_t>(ts.tv_nsec);
 #endif
-
-// _____________________________________________________________________________________________________________________
-void CPUTimer::start() {
-  if (_running) return;
-  if (_stopped) reset();
-  _running = true;
-  auto now = std::clock();
-  _intervals.emplace_back(now, now);
 }
 
-// _____________________________________________________________________________________________________________________
-Time CPUTimer::pause() {
-  if (!_running) { return getTime(); }
-  auto now = std::clock();
-  _intervals.back().second = now;
-  auto ms = static_cast<uint64_t>(1000.0 * static_cast<double>(_intervals.back().second - _intervals.back().first) /
-                                  CLOCKS_PER_SEC);
-  _running = false;
-  return Time(0, 0, 0, 0, ms, 0, 0);
-}
+}  // namespace detail
 
-// _____________________________________________________________________________________________________________________
-Time CPUTimer::stop() {
-  if (!_running) { return getTime(); }
-  auto now = std::clock();
-  _intervals.back().second = now;
-  _stopped = true;
-  _running = false;
-  return getTime();
-}
+namespace {
 
 // _____________________________________________________________________________________________________________________
-void CPUTimer::calibrate() {
-  CPUTimer cput;
-  std::vector<Time> t(1000);
-  for (int i = 0; i < 1000; ++i) {
-    cput.start();
-    cput.stop();
-    t.push_back(cput.getTime());
+template<typename TimerT>
+Time measureOverhead(TimerT timer) {
+  constexpr int WARMUP = 100;
+  constexpr int SAMPLES = 1000;
+  std::vector<Time> samples;
+  samples.reserve(SAMPLES);
+  for (int i = 0; i < WARMUP + SAMPLES; ++i) {
+    timer.start();
+    Time t = timer.stop();
+    if (i >= WARMUP) { samples.push_back(t); }
   }
-  _baseLine = utils::mean(t);
+  return Time::fromNanoseconds(static_cast<int64_t>(utils::Summarizer().percentiles(samples, {5})[0]));
 }
 
+}  // namespace
+
 // _____________________________________________________________________________________________________________________
-Time CPUTimer::getTime() const {
-  double time = 0;
-  for (auto &interval: _intervals) {
-    time += 1000.0 * static_cast<double>(interval.second - interval.first) / CLOCKS_PER_SEC;
+Time timerOverhead(ClockSource source) {
+  // calibration only needs the last interval, AccumulatorStorage never allocates
+  switch (source) {
+    case ClockSource::TSC: {
+      static const Time overhead = measureOverhead(BasicTscTimer<AccumulatorStorage<TscInterval>>());
+      return overhead;
+    }
+    case ClockSource::CPU_PROCESS: {
+      static const Time overhead =
+        measureOverhead(BasicCPUTimer<AccumulatorStorage<CPUClockInterval>>(CPUClock::PROCESS));
+      return overhead;
+    }
+    case ClockSource::CPU_THREAD: {
+      static const Time overhead =
+        measureOverhead(BasicCPUTimer<AccumulatorStorage<CPUClockInterval>>(CPUClock::THREAD));
+      return overhead;
+    }
+    case ClockSource::STEADY:
+      break;
   }
-  TimeValueUnit tvu;
-  tvu.value = time * 1000 * 1000;
-  tvu.unit = "ns";
-  return Time(tvu) - _baseLine;
+  static const Time overhead = measureOverhead(BasicWallTimer<AccumulatorStorage<SteadyClockInterval>>());
+  return overhead;
 }
 
-}  // namespace timed
\ No newline at end of file
+}  // namespace timed
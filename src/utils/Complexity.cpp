@@ -0,0 +1,84 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cmath>
+#include <stdexcept>
+
+#include "timed/utils/Complexity.h"
+
+namespace timed {
+namespace utils {
+
+// _____________________________________________________________________________________________________________________
+const char *toString(Complexity complexity) {
+  switch (complexity) {
+    case Complexity::O_1: return "O(1)";
+    case Complexity::O_LOG_N: return "O(log n)";
+    case Complexity::O_N: return "O(n)";
+    case Complexity::O_N_LOG_N: return "O(n log n)";
+    case Complexity::O_N_SQUARED: return "O(n^2)";
+  }
+  return "unknown";
+}
+
+// _____________________________________________________________________________________________________________________
+double complexityFunction(Complexity complexity, double n) {
+  switch (complexity) {
+    case Complexity::O_1: return 1;
+    case Complexity::O_LOG_N: return n > 1 ? std::log2(n) : 0;
+    case Complexity::O_N: return n;
+    case Complexity::O_N_LOG_N: return n > 1 ? n * std::log2(n) : 0;
+    case Complexity::O_N_SQUARED: return n * n;
+  }
+  return 0;
+}
+
+// _____________________________________________________________________________________________________________________
+ComplexityFit fitComplexity(const std::vector<double> &n, const std::vector<double> &times, Complexity complexity) {
+  if (n.size() != times.size()) {
+    throw std::runtime_error("fitComplexity: got " + std::to_string(n.size()) + " sizes and " +
+                             std::to_string(times.size()) + " times");
+  }
+  if (n.empty()) {
+    throw std::runtime_error("fitComplexity: no data");
+  }
+  // minimizing sum (t - c f)^2 over c: c = sum(t f) / sum(f^2)
+  double sumTF = 0;
+  double sumFF = 0;
+  double sumT = 0;
+  for (size_t i = 0; i < n.size(); ++i) {
+    double f = complexityFunction(complexity, n[i]);
+    sumTF += times[i] * f;
+    sumFF += f * f;
+    sumT += times[i];
+  }
+  ComplexityFit fit;
+  fit.complexity = complexity;
+  fit.coefficient = sumFF > 0 ? sumTF / sumFF : 0;
+  double sumSquaredResiduals = 0;
+  for (size_t i = 0; i < n.size(); ++i) {
+    double residual = times[i] - fit.coefficient * complexityFunction(complexity, n[i]);
+    sumSquaredResiduals += residual * residual;
+  }
+  fit.rms = std::sqrt(sumSquaredResiduals / static_cast<double>(n.size()));
+  double mean = sumT / static_cast<double>(n.size());
+  fit.relativeRms = mean != 0 ? fit.rms / mean : 0;
+  return fit;
+}
+
+// _____________________________________________________________________________________________________________________
+ComplexityFit fitComplexity(const std::vector<double> &n, const std::vector<double> &times) {
+  const Complexity models[] = {Complexity::O_1, Complexity::O_LOG_N, Complexity::O_N, Complexity::O_N_LOG_N,
+                               Complexity::O_N_SQUARED};
+  ComplexityFit best = fitComplexity(n, times, models[0]);
+  for (auto model: models) {
+    ComplexityFit fit = fitComplexity(n, times, model);
+    if (fit.rms < best.rms) { best = fit; }
+  }
+  return best;
+}
+
+}  // namespace utils
+}  // namespace timed
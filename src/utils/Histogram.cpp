@@ -0,0 +1,229 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "timed/utils/Histogram.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace timed {
+namespace utils {
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+inline unsigned countLeadingZeros(uint64_t value) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return 63 - static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+}  // namespace
+
+// ===== Histogram =====================================================================================================
+// ----- public --------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+Histogram::Histogram(unsigned significantDigits, Time highestTrackable) {
+  if (significantDigits < 1 || significantDigits > 5) {
+    throw std::runtime_error("Histogram: significant digits must be in [1, 5], got " +
+                             std::to_string(significantDigits));
+  }
+  if (highestTrackable.count() < 2) {
+    throw std::runtime_error("Histogram: highest trackable value must be at least 2ns");
+  }
+  _significantDigits = significantDigits;
+  _highestTrackable = static_cast<uint64_t>(highestTrackable.count());
+  // smallest power of two sub-bucket count that resolves 2 * 10^digits single units
+  uint64_t largestSingleUnitValue = 2 * static_cast<uint64_t>(std::pow(10, significantDigits));
+  unsigned subBucketCountMagnitude = 0;
+  while ((uint64_t(1) << subBucketCountMagnitude) < largestSingleUnitValue) { ++subBucketCountMagnitude; }
+  _subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+  uint64_t subBucketCount = uint64_t(1) << subBucketCountMagnitude;
+  _subBucketHalfCount = subBucketCount / 2;
+  _subBucketMask = subBucketCount - 1;
+  uint64_t smallestUntrackable = subBucketCount;
+  size_t bucketsNeeded = 1;
+  while (smallestUntrackable <= _highestTrackable) {
+    if (smallestUntrackable > (UINT64_MAX >> 1)) {
+      ++bucketsNeeded;
+      break;
+    }
+    smallestUntrackable <<= 1;
+    ++bucketsNeeded;
+  }
+  _countsLength = (bucketsNeeded + 1) * _subBucketHalfCount;
+}
+
+// _____________________________________________________________________________________________________________________
+void Histogram::record(Time time) {
+  record(time, 1);
+}
+
+// _____________________________________________________________________________________________________________________
+void Histogram::record(Time time, uint64_t count) {
+  if (_counts.empty()) { _counts.resize(_countsLength, 0); }
+  uint64_t value = time.count() < 0 ? 0 : static_cast<uint64_t>(time.count());
+  if (value > _highestTrackable) { value = _highestTrackable; }
+  _counts[_countsIndex(value)] += count;
+  _totalCount += count;
+  if (value < _min) { _min = value; }
+  if (value > _max) { _max = value; }
+}
+
+// _____________________________________________________________________________________________________________________
+void Histogram::merge(const Histogram &other) {
+  if (other._significantDigits != _significantDigits || other._highestTrackable != _highestTrackable) {
+    throw std::runtime_error("Histogram: cannot merge histograms with different configurations");
+  }
+  if (other._counts.empty()) { return; }
+  if (_counts.empty()) { _counts.resize(_countsLength, 0); }
+  for (size_t i = 0; i < _countsLength; ++i) {
+    _counts[i] += other._counts[i];
+  }
+  _totalCount += other._totalCount;
+  if (other._min < _min) { _min = other._min; }
+  if (other._max > _max) { _max = other._max; }
+}
+
+// _____________________________________________________________________________________________________________________
+void Histogram::reset() {
+  std::fill(_counts.begin(), _counts.end(), 0);
+  _totalCount = 0;
+  _min = UINT64_MAX;
+  _max = 0;
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t Histogram::count() const {
+  return _totalCount;
+}
+
+// _____________________________________________________________________________________________________________________
+bool Histogram::empty() const {
+  return _totalCount == 0;
+}
+
+// _____________________________________________________________________________________________________________________
+Time Histogram::min() const {
+  if (empty()) { return Time(); }
+  return Time::fromNanoseconds(static_cast<int64_t>(_min));
+}
+
+// _____________________________________________________________________________________________________________________
+Time Histogram::max() const {
+  if (empty()) { return Time(); }
+  return Time::fromNanoseconds(static_cast<int64_t>(_max));
+}
+
+// _____________________________________________________________________________________________________________________
+Time Histogram::mean() const {
+  if (empty()) { return Time(); }
+  double sum = 0;
+  for (size_t i = 0; i < _countsLength; ++i) {
+    if (_counts[i] == 0) { continue; }
+    sum += static_cast<double>(_medianEquivalent(_valueFromIndex(i))) * static_cast<double>(_counts[i]);
+  }
+  return Time::fromNanoseconds(static_cast<int64_t>(std::round(sum / static_cast<double>(_totalCount))));
+}
+
+// _____________________________________________________________________________________________________________________
+Time Histogram::stddev() const {
+  if (empty()) { return Time(); }
+  double m = static_cast<double>(mean().count());
+  double sum = 0;
+  for (size_t i = 0; i < _countsLength; ++i) {
+    if (_counts[i] == 0) { continue; }
+    double dev = static_cast<double>(_medianEquivalent(_valueFromIndex(i))) - m;
+    sum += dev * dev * static_cast<double>(_counts[i]);
+  }
+  return Time::fromNanoseconds(static_cast<int64_t>(std::round(std::sqrt(sum / static_cast<double>(_totalCount)))));
+}
+
+// _____________________________________________________________________________________________________________________
+Time Histogram::percentile(double percentile) const {
+  if (empty()) { return Time(); }
+  if (percentile <= 0) { return min(); }
+  if (percentile > 100) { percentile = 100; }
+  auto countAtPercentile = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(_totalCount)));
+  if (countAtPercentile < 1) { countAtPercentile = 1; }
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < _countsLength; ++i) {
+    cumulative += _counts[i];
+    if (cumulative >= countAtPercentile) {
+      uint64_t value = _valueFromIndex(i);
+      uint64_t highest = value + _equivalentRange(value) - 1;
+      // never report beyond the exact extrema
+      if (highest > _max) { highest = _max; }
+      if (highest < _min) { highest = _min; }
+      return Time::fromNanoseconds(static_cast<int64_t>(highest));
+    }
+  }
+  return max();
+}
+
+// _____________________________________________________________________________________________________________________
+Time Histogram::median() const {
+  return percentile(50);
+}
+
+// _____________________________________________________________________________________________________________________
+unsigned Histogram::significantDigits() const {
+  return _significantDigits;
+}
+
+// _____________________________________________________________________________________________________________________
+Time Histogram::highestTrackable() const {
+  return Time::fromNanoseconds(static_cast<int64_t>(_highestTrackable));
+}
+
+// _____________________________________________________________________________________________________________________
+size_t Histogram::bucketCount() const {
+  return _countsLength;
+}
+
+// ----- private -------------------------------------------------------------------------------------------------------
+// _____________________________________________________________________________________________________________________
+size_t Histogram::_countsIndex(uint64_t value) const {
+  // index of the power of two bucket (0 for values below the sub-bucket count)
+  unsigned bucketIndex = 64 - _subBucketHalfCountMagnitude - 1 - countLeadingZeros(value | _subBucketMask);
+  uint64_t subBucketIndex = value >> bucketIndex;
+  return ((static_cast<size_t>(bucketIndex) + 1) << _subBucketHalfCountMagnitude) +
+         static_cast<size_t>(subBucketIndex - _subBucketHalfCount);
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t Histogram::_valueFromIndex(size_t index) const {
+  auto bucketIndex = static_cast<int64_t>(index >> _subBucketHalfCountMagnitude) - 1;
+  uint64_t subBucketIndex = (index & (_subBucketHalfCount - 1)) + _subBucketHalfCount;
+  if (bucketIndex < 0) {
+    subBucketIndex -= _subBucketHalfCount;
+    bucketIndex = 0;
+  }
+  return subBucketIndex << bucketIndex;
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t Histogram::_equivalentRange(uint64_t value) const {
+  unsigned bucketIndex = 64 - _subBucketHalfCountMagnitude - 1 - countLeadingZeros(value | _subBucketMask);
+  return uint64_t(1) << bucketIndex;
+}
+
+// _____________________________________________________________________________________________________________________
+uint64_t Histogram::_medianEquivalent(uint64_t value) const {
+  return value + _equivalentRange(value) / 2;
+}
+
+}  // namespace utils
+}  // namespace timed
@@ -0,0 +1,507 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <cmath>
+
+#include "timed/utils/Reduce.h"
+
+// The vector kernels are compiled with per function target attributes, so the library itself does not need any
+// -m flags and the kernels are only executed after the runtime check in bestInstructionSet().
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// GCC 12's AVX-512 reductions and extracts start from _mm256_undefined_pd() and friends, which -Wall reports as
+// uninitialized once they are inlined into the kernels below
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#define TIMED_SIMD_X86 1
+#define TIMED_TARGET_AVX2 __attribute__((target("avx2")))
+#define TIMED_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#else
+#define TIMED_SIMD_X86 0
+#endif
+
+namespace timed {
+namespace utils {
+namespace simd {
+
+namespace {
+
+// ===== scalar ========================================================================================================
+// _____________________________________________________________________________________________________________________
+template<typename T>
+double scalarSum(const T *data, size_t size) {
+  if constexpr (std::is_floating_point<T>::value) {
+    double sum = 0;
+    for (size_t i = 0; i < size; ++i) { sum += data[i]; }
+    return sum;
+  } else {
+    // integers are accumulated exactly (wrapping like the vector kernels) and converted once
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; ++i) { sum += static_cast<uint64_t>(data[i]); }
+    return static_cast<double>(static_cast<T>(sum));
+  }
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+double scalarSumOfSquaredDeviations(const T *data, size_t size, double center) {
+  double sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    double dev = static_cast<double>(data[i]) - center;
+    sum += dev * dev;
+  }
+  return sum;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+double scalarSumOfAbsoluteDeviations(const T *data, size_t size, double center) {
+  double sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    sum += std::abs(static_cast<double>(data[i]) - center);
+  }
+  return sum;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+MinMax<T> scalarMinMax(const T *data, size_t size, size_t begin = 0, MinMax<T> init = {0, 0}) {
+  if (size == 0) { return {0, 0}; }
+  MinMax<T> ret = begin == 0 ? MinMax<T>{data[0], data[0]} : init;
+  for (size_t i = begin; i < size; ++i) {
+    ret.min = std::min(ret.min, data[i]);
+    ret.max = std::max(ret.max, data[i]);
+  }
+  return ret;
+}
+
+#if TIMED_SIMD_X86
+// ===== AVX2 ==========================================================================================================
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX2 inline __m256d avx2ToDouble(__m256i x) {
+  // AVX2 has no 64 bit integer conversion: both 32 bit halves are converted exactly via the exponent trick and added,
+  // which rounds once, like a scalar conversion
+  const __m256i lowExponent = _mm256_set1_epi64x(0x4330000000000000);   // 2^52
+  const __m256i highExponent = _mm256_set1_epi64x(0x4530000000000000);  // 2^84
+  const __m256d bothExponents = _mm256_set1_pd(19342813118337666422669312.0);  // 2^84 + 2^52
+  __m256i low = _mm256_blend_epi32(lowExponent, x, 0x55);
+  __m256i high = _mm256_xor_si256(_mm256_srli_epi64(x, 32), highExponent);
+  __m256d highDouble = _mm256_sub_pd(_mm256_castsi256_pd(high), bothExponents);
+  return _mm256_add_pd(highDouble, _mm256_castsi256_pd(low));
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX2 inline __m256d avx2Load(const double *data) {
+  return _mm256_loadu_pd(data);
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX2 inline __m256d avx2Load(const uint64_t *data) {
+  return avx2ToDouble(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)));
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX2 inline __m256d avx2Load(const int64_t *data) {
+  __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  // converted as unsigned, negative values are 2^64 too large
+  __m256d negative = _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_setzero_si256(), x));
+  return _mm256_sub_pd(avx2ToDouble(x), _mm256_and_pd(negative, _mm256_set1_pd(18446744073709551616.0)));
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX2 inline double avx2HorizontalSum(__m256d x) {
+  __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX2 double avx2Sum(const double *data, size_t size) {
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(data + i));
+    acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(data + i + 4));
+  }
+  double sum = avx2HorizontalSum(_mm256_add_pd(acc0, acc1));
+  for (; i < size; ++i) { sum += data[i]; }
+  return sum;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+TIMED_TARGET_AVX2 double avx2IntegerSum(const T *data, size_t size) {
+  __m256i acc = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+  }
+  alignas(32) uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+  uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  for (; i < size; ++i) { sum += static_cast<uint64_t>(data[i]); }
+  return static_cast<double>(static_cast<T>(sum));
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+TIMED_TARGET_AVX2 double avx2SumOfSquaredDeviations(const T *data, size_t size, double center) {
+  const __m256d c = _mm256_set1_pd(center);
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m256d dev0 = _mm256_sub_pd(avx2Load(data + i), c);
+    __m256d dev1 = _mm256_sub_pd(avx2Load(data + i + 4), c);
+    acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(dev0, dev0));
+    acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(dev1, dev1));
+  }
+  return avx2HorizontalSum(_mm256_add_pd(acc0, acc1)) + scalarSumOfSquaredDeviations(data + i, size - i, center);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+TIMED_TARGET_AVX2 double avx2SumOfAbsoluteDeviations(const T *data, size_t size, double center) {
+  const __m256d c = _mm256_set1_pd(center);
+  const __m256d signBit = _mm256_set1_pd(-0.0);
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(signBit, _mm256_sub_pd(avx2Load(data + i), c)));
+    acc1 = _mm256_add_pd(acc1, _mm256_andnot_pd(signBit, _mm256_sub_pd(avx2Load(data + i + 4), c)));
+  }
+  return avx2HorizontalSum(_mm256_add_pd(acc0, acc1)) + scalarSumOfAbsoluteDeviations(data + i, size - i, center);
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX2 MinMax<double> avx2MinMax(const double *data, size_t size) {
+  if (size < 4) { return scalarMinMax(data, size); }
+  __m256d min = _mm256_loadu_pd(data);
+  __m256d max = min;
+  size_t i = 4;
+  for (; i + 4 <= size; i += 4) {
+    __m256d x = _mm256_loadu_pd(data + i);
+    min = _mm256_min_pd(min, x);
+    max = _mm256_max_pd(max, x);
+  }
+  alignas(32) double minLanes[4];
+  alignas(32) double maxLanes[4];
+  _mm256_store_pd(minLanes, min);
+  _mm256_store_pd(maxLanes, max);
+  MinMax<double> ret{*std::min_element(minLanes, minLanes + 4), *std::max_element(maxLanes, maxLanes + 4)};
+  return scalarMinMax(data, size, i, ret);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+TIMED_TARGET_AVX2 MinMax<T> avx2IntegerMinMax(const T *data, size_t size) {
+  if (size < 4) { return scalarMinMax(data, size); }
+  // AVX2 only compares signed 64 bit integers: unsigned values are compared with flipped sign bits
+  const __m256i bias = _mm256_set1_epi64x(std::is_signed<T>::value ? 0 : INT64_MIN);
+  __m256i min = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)), bias);
+  __m256i max = min;
+  size_t i = 4;
+  for (; i + 4 <= size; i += 4) {
+    __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), bias);
+    min = _mm256_blendv_epi8(min, x, _mm256_cmpgt_epi64(min, x));
+    max = _mm256_blendv_epi8(max, x, _mm256_cmpgt_epi64(x, max));
+  }
+  alignas(32) T minLanes[4];
+  alignas(32) T maxLanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(minLanes), _mm256_xor_si256(min, bias));
+  _mm256_store_si256(reinterpret_cast<__m256i *>(maxLanes), _mm256_xor_si256(max, bias));
+  MinMax<T> ret{*std::min_element(minLanes, minLanes + 4), *std::max_element(maxLanes, maxLanes + 4)};
+  return scalarMinMax(data, size, i, ret);
+}
+
+// ===== AVX-512 =======================================================================================================
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX512 inline __m512d avx512Load(const double *data) {
+  return _mm512_loadu_pd(data);
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX512 inline __m512d avx512Load(const int64_t *data) {
+  return _mm512_cvtepi64_pd(_mm512_loadu_si512(data));
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX512 inline __m512d avx512Load(const uint64_t *data) {
+  return _mm512_cvtepu64_pd(_mm512_loadu_si512(data));
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX512 double avx512Sum(const double *data, size_t size) {
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    acc0 = _mm512_add_pd(acc0, _mm512_loadu_pd(data + i));
+    acc1 = _mm512_add_pd(acc1, _mm512_loadu_pd(data + i + 8));
+  }
+  double sum = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+  for (; i < size; ++i) { sum += data[i]; }
+  return sum;
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+TIMED_TARGET_AVX512 double avx512IntegerSum(const T *data, size_t size) {
+  __m512i acc = _mm512_setzero_si512();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    acc = _mm512_add_epi64(acc, _mm512_loadu_si512(data + i));
+  }
+  auto sum = static_cast<uint64_t>(_mm512_reduce_add_epi64(acc));
+  for (; i < size; ++i) { sum += static_cast<uint64_t>(data[i]); }
+  return static_cast<double>(static_cast<T>(sum));
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+TIMED_TARGET_AVX512 double avx512SumOfSquaredDeviations(const T *data, size_t size, double center) {
+  const __m512d c = _mm512_set1_pd(center);
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m512d dev0 = _mm512_sub_pd(avx512Load(data + i), c);
+    __m512d dev1 = _mm512_sub_pd(avx512Load(data + i + 8), c);
+    acc0 = _mm512_add_pd(acc0, _mm512_mul_pd(dev0, dev0));
+    acc1 = _mm512_add_pd(acc1, _mm512_mul_pd(dev1, dev1));
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)) +
+         scalarSumOfSquaredDeviations(data + i, size - i, center);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+TIMED_TARGET_AVX512 double avx512SumOfAbsoluteDeviations(const T *data, size_t size, double center) {
+  const __m512d c = _mm512_set1_pd(center);
+  __m512d acc0 = _mm512_setzero_pd();
+  __m512d acc1 = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    acc0 = _mm512_add_pd(acc0, _mm512_abs_pd(_mm512_sub_pd(avx512Load(data + i), c)));
+    acc1 = _mm512_add_pd(acc1, _mm512_abs_pd(_mm512_sub_pd(avx512Load(data + i + 8), c)));
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)) +
+         scalarSumOfAbsoluteDeviations(data + i, size - i, center);
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX512 MinMax<double> avx512MinMax(const double *data, size_t size) {
+  if (size < 8) { return scalarMinMax(data, size); }
+  __m512d min = _mm512_loadu_pd(data);
+  __m512d max = min;
+  size_t i = 8;
+  for (; i + 8 <= size; i += 8) {
+    __m512d x = _mm512_loadu_pd(data + i);
+    min = _mm512_min_pd(min, x);
+    max = _mm512_max_pd(max, x);
+  }
+  return scalarMinMax(data, size, i, MinMax<double>{_mm512_reduce_min_pd(min), _mm512_reduce_max_pd(max)});
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX512 MinMax<int64_t> avx512MinMax(const int64_t *data, size_t size) {
+  if (size < 8) { return scalarMinMax(data, size); }
+  __m512i min = _mm512_loadu_si512(data);
+  __m512i max = min;
+  size_t i = 8;
+  for (; i + 8 <= size; i += 8) {
+    __m512i x = _mm512_loadu_si512(data + i);
+    min = _mm512_min_epi64(min, x);
+    max = _mm512_max_epi64(max, x);
+  }
+  MinMax<int64_t> ret{static_cast<int64_t>(_mm512_reduce_min_epi64(min)),
+                      static_cast<int64_t>(_mm512_reduce_max_epi64(max))};
+  return scalarMinMax(data, size, i, ret);
+}
+
+// _____________________________________________________________________________________________________________________
+TIMED_TARGET_AVX512 MinMax<uint64_t> avx512MinMax(const uint64_t *data, size_t size) {
+  if (size < 8) { return scalarMinMax(data, size); }
+  __m512i min = _mm512_loadu_si512(data);
+  __m512i max = min;
+  size_t i = 8;
+  for (; i + 8 <= size; i += 8) {
+    __m512i x = _mm512_loadu_si512(data + i);
+    min = _mm512_min_epu64(min, x);
+    max = _mm512_max_epu64(max, x);
+  }
+  MinMax<uint64_t> ret{static_cast<uint64_t>(_mm512_reduce_min_epu64(min)),
+                       static_cast<uint64_t>(_mm512_reduce_max_epu64(max))};
+  return scalarMinMax(data, size, i, ret);
+}
+#endif
+
+// ===== dispatch ======================================================================================================
+// _____________________________________________________________________________________________________________________
+InstructionSet detectInstructionSet() {
+#if TIMED_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) { return InstructionSet::AVX512; }
+  if (__builtin_cpu_supports("avx2")) { return InstructionSet::AVX2; }
+#endif
+  return InstructionSet::SCALAR;
+}
+
+// _____________________________________________________________________________________________________________________
+inline InstructionSet usable(InstructionSet requested) {
+  return std::min(requested, bestInstructionSet());
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+double dispatchSum(const T *data, size_t size, InstructionSet instructionSet) {
+#if TIMED_SIMD_X86
+  switch (usable(instructionSet)) {
+    case InstructionSet::AVX512:
+      if constexpr (std::is_floating_point<T>::value) { return avx512Sum(data, size); }
+      else { return avx512IntegerSum(data, size); }
+    case InstructionSet::AVX2:
+      if constexpr (std::is_floating_point<T>::value) { return avx2Sum(data, size); }
+      else { return avx2IntegerSum(data, size); }
+    case InstructionSet::SCALAR:
+      break;
+  }
+#endif
+  return scalarSum(data, size);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+double dispatchSumOfSquaredDeviations(const T *data, size_t size, double center, InstructionSet instructionSet) {
+#if TIMED_SIMD_X86
+  switch (usable(instructionSet)) {
+    case InstructionSet::AVX512: return avx512SumOfSquaredDeviations(data, size, center);
+    case InstructionSet::AVX2: return avx2SumOfSquaredDeviations(data, size, center);
+    case InstructionSet::SCALAR: break;
+  }
+#endif
+  return scalarSumOfSquaredDeviations(data, size, center);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+double dispatchSumOfAbsoluteDeviations(const T *data, size_t size, double center, InstructionSet instructionSet) {
+#if TIMED_SIMD_X86
+  switch (usable(instructionSet)) {
+    case InstructionSet::AVX512: return avx512SumOfAbsoluteDeviations(data, size, center);
+    case InstructionSet::AVX2: return avx2SumOfAbsoluteDeviations(data, size, center);
+    case InstructionSet::SCALAR: break;
+  }
+#endif
+  return scalarSumOfAbsoluteDeviations(data, size, center);
+}
+
+// _____________________________________________________________________________________________________________________
+template<typename T>
+MinMax<T> dispatchMinMax(const T *data, size_t size, InstructionSet instructionSet) {
+#if TIMED_SIMD_X86
+  switch (usable(instructionSet)) {
+    case InstructionSet::AVX512: return avx512MinMax(data, size);
+    case InstructionSet::AVX2:
+      if constexpr (std::is_floating_point<T>::value) { return avx2MinMax(data, size); }
+      else { return avx2IntegerMinMax(data, size); }
+    case InstructionSet::SCALAR: break;
+  }
+#endif
+  return scalarMinMax(data, size);
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+InstructionSet bestInstructionSet() {
+  static const InstructionSet instructionSet = detectInstructionSet();
+  return instructionSet;
+}
+
+// _____________________________________________________________________________________________________________________
+bool isSupported(InstructionSet instructionSet) {
+  return instructionSet <= bestInstructionSet();
+}
+
+// _____________________________________________________________________________________________________________________
+const char *toString(InstructionSet instructionSet) {
+  switch (instructionSet) {
+    case InstructionSet::AVX512: return "AVX-512";
+    case InstructionSet::AVX2: return "AVX2";
+    case InstructionSet::SCALAR: break;
+  }
+  return "scalar";
+}
+
+// _____________________________________________________________________________________________________________________
+double sum(const double *data, size_t size, InstructionSet instructionSet) {
+  return dispatchSum(data, size, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+double sum(const int64_t *data, size_t size, InstructionSet instructionSet) {
+  return dispatchSum(data, size, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+double sum(const uint64_t *data, size_t size, InstructionSet instructionSet) {
+  return dispatchSum(data, size, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+double sumOfSquaredDeviations(const double *data, size_t size, double center, InstructionSet instructionSet) {
+  return dispatchSumOfSquaredDeviations(data, size, center, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+double sumOfSquaredDeviations(const int64_t *data, size_t size, double center, InstructionSet instructionSet) {
+  return dispatchSumOfSquaredDeviations(data, size, center, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+double sumOfSquaredDeviations(const uint64_t *data, size_t size, double center, InstructionSet instructionSet) {
+  return dispatchSumOfSquaredDeviations(data, size, center, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+double sumOfAbsoluteDeviations(const double *data, size_t size, double center, InstructionSet instructionSet) {
+  return dispatchSumOfAbsoluteDeviations(data, size, center, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+double sumOfAbsoluteDeviations(const int64_t *data, size_t size, double center, InstructionSet instructionSet) {
+  return dispatchSumOfAbsoluteDeviations(data, size, center, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+double sumOfAbsoluteDeviations(const uint64_t *data, size_t size, double center, InstructionSet instructionSet) {
+  return dispatchSumOfAbsoluteDeviations(data, size, center, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+MinMax<double> minMax(const double *data, size_t size, InstructionSet instructionSet) {
+  return dispatchMinMax(data, size, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+MinMax<int64_t> minMax(const int64_t *data, size_t size, InstructionSet instructionSet) {
+  return dispatchMinMax(data, size, instructionSet);
+}
+
+// _____________________________________________________________________________________________________________________
+MinMax<uint64_t> minMax(const uint64_t *data, size_t size, InstructionSet instructionSet) {
+  return dispatchMinMax(data, size, instructionSet);
+}
+
+}  // namespace simd
+}  // namespace utils
+}  // namespace timed
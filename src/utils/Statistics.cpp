@@ -3,49 +3,79 @@
 //
 // This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <type_traits>
+
 #include "timed/utils/Statistics.h"
 
 namespace timed {
 namespace utils {
 
+namespace {
+
+static_assert(sizeof(Time) == sizeof(int64_t) && std::is_standard_layout<Time>::value,
+              "Time must be a plain nanosecond count");
+
+// Time only holds its nanosecond count, so a vector of Time is reduced in place instead of being copied
+inline const int64_t *nanoseconds(const std::vector<Time>& vec) {
+  return reinterpret_cast<const int64_t *>(vec.data());
+}
+
+inline Time roundedNanoseconds(double ns) {
+  return Time::fromNanoseconds(static_cast<int64_t>(std::llround(ns)));
+}
+
+// median of a resample of vec drawn into scratch
+double resampledMedian(const std::vector<double> &vec, std::vector<double> &scratch, std::mt19937_64 &gen) {
+  std::uniform_int_distribution<size_t> index(0, vec.size() - 1);
+  scratch.resize(vec.size());
+  for (auto &x: scratch) { x = vec[index(gen)]; }
+  auto middle = scratch.begin() + static_cast<std::ptrdiff_t>(scratch.size() / 2);
+  std::nth_element(scratch.begin(), middle, scratch.end());
+  return *middle;
+}
+
+// percentile interval of the central confidence mass of sorted
+ConfidenceInterval percentileInterval(const std::vector<double> &sorted, double confidence) {
+  double tail = (1 - confidence) / 2;
+  auto at = [&sorted](double quantile) {
+    auto index = static_cast<size_t>(std::floor(quantile * static_cast<double>(sorted.size() - 1) + 0.5));
+    return sorted[std::min(index, sorted.size() - 1)];
+  };
+  return {at(tail), at(1 - tail)};
+}
+
+}  // namespace
+
 Time min(const std::vector<Time>& vec) {
   if (vec.empty()) { return Time(); }
-  Time minTime(vec[0]);
-  for (auto& t: vec) {
-    if (t < minTime) {
-      minTime = t;
-    }
-  }
-  return minTime;
+  return Time::fromNanoseconds(simd::minMax(nanoseconds(vec), vec.size()).min);
 }
 
 Time max(const std::vector<Time>& vec) {
   if (vec.empty()) { return Time(); }
-  Time minTime(vec[0]);
-  for (auto& t: vec) {
-    if (t > minTime) {
-      minTime = t;
-    }
-  }
-  return minTime;
+  return Time::fromNanoseconds(simd::minMax(nanoseconds(vec), vec.size()).max);
 }
 
 Time mean(const std::vector<Time>& vec) {
-  std::vector<uint64_t> nsVec(vec.size());
-  std::transform(vec.begin(), vec.end(), nsVec.begin(), [](Time t) { return t.getNanoseconds(); });
-  TimeValueUnit tvu;
-  tvu.value = mean(nsVec);
-  tvu.unit = "ns";
-  return Time(tvu);
+  if (vec.empty()) { return Time(); }
+  return roundedNanoseconds(simd::sum(nanoseconds(vec), vec.size()) / static_cast<double>(vec.size()));
 }
 
 Time stddev(const std::vector<Time>& vec) {
-  std::vector<uint64_t> nsVec(vec.size());
-  std::transform(vec.begin(), vec.end(), nsVec.begin(), [](Time t) { return t.getNanoseconds(); });
-  TimeValueUnit tvu;
-  tvu.value = medianAbsolutePercentError(nsVec);
-  tvu.unit = "ns";
-  return Time(tvu);
+  if (vec.empty()) { return Time(); }
+  double m = simd::sum(nanoseconds(vec), vec.size()) / static_cast<double>(vec.size());
+  double sum = simd::sumOfSquaredDeviations(nanoseconds(vec), vec.size(), m);
+  return roundedNanoseconds(std::sqrt(sum / static_cast<double>(vec.size())));
+}
+
+Time meanAbsoluteDeviation(const std::vector<Time>& vec) {
+  if (vec.empty()) { return Time(); }
+  double m = simd::sum(nanoseconds(vec), vec.size()) / static_cast<double>(vec.size());
+  return roundedNanoseconds(simd::sumOfAbsoluteDeviations(nanoseconds(vec), vec.size(), m) /
+                            static_cast<double>(vec.size()));
 }
 
 Time median(const std::vector<Time>& vec) {
@@ -63,5 +93,101 @@ double medianAbsolutePercentError(const std::vector<Time>& vec) {
   return medianAbsolutePercentError(nsVec);
 }
 
+MannWhitneyResult mannWhitneyU(const std::vector<double> &a, const std::vector<double> &b) {
+  MannWhitneyResult result;
+  if (a.empty() || b.empty()) { return result; }
+  // (value, sample) pairs in ascending order, ties get the mean of their ranks
+  std::vector<std::pair<double, bool>> values;
+  values.reserve(a.size() + b.size());
+  for (double x: a) { values.emplace_back(x, true); }
+  for (double x: b) { values.emplace_back(x, false); }
+  std::sort(values.begin(), values.end());
+  double rankSumA = 0;
+  double tieTerm = 0;
+  for (size_t i = 0; i < values.size();) {
+    size_t j = i;
+    while (j < values.size() && values[j].first == values[i].first) { ++j; }
+    double rank = static_cast<double>(i + j + 1) / 2;
+    for (size_t k = i; k < j; ++k) {
+      if (values[k].second) { rankSumA += rank; }
+    }
+    auto ties = static_cast<double>(j - i);
+    tieTerm += ties * ties * ties - ties;
+    i = j;
+  }
+  auto n1 = static_cast<double>(a.size());
+  auto n2 = static_cast<double>(b.size());
+  double n = n1 + n2;
+  result.u = rankSumA - n1 * (n1 + 1) / 2;
+  double mean = n1 * n2 / 2;
+  double variance = n1 * n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1)));
+  if (variance <= 0) { return result; }
+  double deviation = std::max(std::abs(result.u - mean) - 0.5, 0.0);
+  result.z = std::copysign(deviation / std::sqrt(variance), result.u - mean);
+  result.pValue = std::erfc(std::abs(result.z) / std::sqrt(2.0));
+  return result;
+}
+
+ConfidenceInterval bootstrapMedianRatio(const std::vector<double> &a, const std::vector<double> &b, double confidence,
+                                        unsigned resamples, uint64_t seed) {
+  ConfidenceInterval interval;
+  if (a.empty() || b.empty() || resamples == 0) { return interval; }
+  std::mt19937_64 gen(seed);
+  std::vector<double> scratch;
+  std::vector<double> ratios;
+  ratios.reserve(resamples);
+  for (unsigned i = 0; i < resamples; ++i) {
+    double medianA = resampledMedian(a, scratch, gen);
+    double medianB = resampledMedian(b, scratch, gen);
+    if (medianA > 0) { ratios.push_back(medianB / medianA); }
+  }
+  if (ratios.empty()) { return interval; }
+  std::sort(ratios.begin(), ratios.end());
+  return percentileInterval(ratios, confidence);
+}
+
+WilcoxonResult wilcoxonSignedRank(const std::vector<double> &differences) {
+  WilcoxonResult result;
+  // (absolute difference, positive) pairs in ascending order, ties get the mean of their ranks
+  std::vector<std::pair<double, bool>> values;
+  values.reserve(differences.size());
+  for (double x: differences) {
+    if (x != 0) { values.emplace_back(std::abs(x), x > 0); }
+  }
+  if (values.empty()) { return result; }
+  std::sort(values.begin(), values.end());
+  double tieTerm = 0;
+  for (size_t i = 0; i < values.size();) {
+    size_t j = i;
+    while (j < values.size() && values[j].first == values[i].first) { ++j; }
+    double rank = static_cast<double>(i + j + 1) / 2;
+    for (size_t k = i; k < j; ++k) {
+      if (values[k].second) { result.w += rank; }
+    }
+    auto ties = static_cast<double>(j - i);
+    tieTerm += ties * ties * ties - ties;
+    i = j;
+  }
+  auto n = static_cast<double>(values.size());
+  double mean = n * (n + 1) / 4;
+  double variance = n * (n + 1) * (2 * n + 1) / 24 - tieTerm / 48;
+  if (variance <= 0) { return result; }
+  double deviation = std::max(std::abs(result.w - mean) - 0.5, 0.0);
+  result.z = std::copysign(deviation / std::sqrt(variance), result.w - mean);
+  result.pValue = std::erfc(std::abs(result.z) / std::sqrt(2.0));
+  return result;
+}
+
+ConfidenceInterval bootstrapMedian(const std::vector<double> &vec, double confidence, unsigned resamples,
+                                   uint64_t seed) {
+  if (vec.empty() || resamples == 0) { return {}; }
+  std::mt19937_64 gen(seed);
+  std::vector<double> scratch;
+  std::vector<double> medians(resamples);
+  for (auto &median: medians) { median = resampledMedian(vec, scratch, gen); }
+  std::sort(medians.begin(), medians.end());
+  return percentileInterval(medians, confidence);
+}
+
 }  // namespace utils
 }  // namespace timed
@@ -0,0 +1,44 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cmath>
+#include <cstdio>
+
+#include "timed/utils/Units.h"
+
+namespace timed {
+namespace utils {
+
+namespace {
+
+// _____________________________________________________________________________________________________________________
+std::string format(double value, const std::string &unit, double base, const char *const *prefixes, size_t count) {
+  size_t i = 0;
+  double scaled = value;
+  while (i + 1 < count && std::abs(scaled) >= base) {
+    scaled /= base;
+    ++i;
+  }
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.2f ", scaled);
+  return buffer + std::string(prefixes[i]) + unit;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________________________________________________
+std::string formatSI(double value, const std::string &unit) {
+  static const char *const prefixes[] = {"", "k", "M", "G", "T", "P", "E"};
+  return format(value, unit, 1000.0, prefixes, sizeof(prefixes) / sizeof(prefixes[0]));
+}
+
+// _____________________________________________________________________________________________________________________
+std::string formatIEC(double value, const std::string &unit) {
+  static const char *const prefixes[] = {"", "Ki", "Mi", "Gi", "Ti", "Pi", "Ei"};
+  return format(value, unit, 1024.0, prefixes, sizeof(prefixes) / sizeof(prefixes[0]));
+}
+
+}  // namespace utils
+}  // namespace timed
@@ -0,0 +1,122 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "timed/Allocations.h"
+#include "timed/Benchmark.h"
+#include "timed/Registry.h"
+
+TEST(AllocationTrackerTest, counters) {
+  ASSERT_TRUE(timed::allocationTrackingEnabled());
+  auto before = timed::threadAllocationCounters();
+  auto *value = new int64_t(1);
+  timed::benchmark::doNotOptimize(value);
+  auto afterNew = timed::threadAllocationCounters();
+  ASSERT_EQ(before.allocations + 1, afterNew.allocations);
+  ASSERT_EQ(before.bytesAllocated + sizeof(int64_t), afterNew.bytesAllocated);
+  ASSERT_GE(afterNew.liveBytes - before.liveBytes, static_cast<int64_t>(sizeof(int64_t)));
+  delete value;
+  auto afterDelete = timed::threadAllocationCounters();
+  ASSERT_EQ(before.deallocations + 1, afterDelete.deallocations);
+  ASSERT_EQ(before.liveBytes, afterDelete.liveBytes);
+
+  // malloc family: realloc counts as one deallocation and one allocation
+  void *block = std::malloc(100);
+  timed::benchmark::doNotOptimize(block);
+  block = std::realloc(block, 10000);
+  std::free(block);
+  void *aligned = nullptr;
+  ASSERT_EQ(0, posix_memalign(&aligned, 64, 256));
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % 64);
+  std::free(aligned);
+  auto *overAligned = new std::aligned_storage_t<256, 128>;
+  timed::benchmark::doNotOptimize(overAligned);
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(overAligned) % 128);
+  delete overAligned;
+  auto after = timed::threadAllocationCounters();
+  ASSERT_EQ(afterDelete.allocations + 4, after.allocations);
+  ASSERT_EQ(afterDelete.deallocations + 4, after.deallocations);
+  ASSERT_EQ(afterDelete.bytesAllocated + 100 + 10000 + 256 + 256, after.bytesAllocated);
+  ASSERT_EQ(before.liveBytes, after.liveBytes);
+  ASSERT_GE(after.peakLiveBytes - before.liveBytes, 10000);
+
+  // counters are per thread
+  std::thread thread([]() {
+    auto counters = timed::threadAllocationCounters();
+    ASSERT_EQ(0, counters.allocations);
+    auto ptr = std::make_unique<int>(1);
+    timed::benchmark::doNotOptimize(ptr);
+    ASSERT_EQ(1, timed::threadAllocationCounters().allocations);
+  });
+  thread.join();
+}
+
+TEST(AllocationTrackerTest, benchmark) {
+  timed::benchmark::Config config;
+  config.iterations = 100;
+  timed::benchmark::Benchmark allocating(config, []() {
+    std::vector<char> buffer(1000);
+    timed::benchmark::doNotOptimize(buffer.data());
+    auto value = std::make_unique<int>(1);
+    timed::benchmark::doNotOptimize(value);
+  }, []() {
+    // the precedent op is not counted
+    std::vector<char> buffer(5000);
+    timed::benchmark::doNotOptimize(buffer.data());
+  });
+  const auto &result = allocating.run();
+  ASSERT_TRUE(result.allocationsTracked);
+  ASSERT_EQ(200, result.allocations);
+  ASSERT_DOUBLE_EQ(2, result.allocationsPerOp());
+  ASSERT_DOUBLE_EQ(1000 + sizeof(int), result.allocatedBytesPerOp());
+  ASSERT_GE(result.peakLiveBytes, 1000);
+  ASSERT_LT(result.peakLiveBytes, 5000);
+  std::stringstream ss;
+  ss << result;
+  ASSERT_NE(std::string::npos, ss.str().find(" Allocations:\n  per op:    2.00\n"));
+
+  // a second run adds samples and allocations, the per op values stay the same
+  allocating.run();
+  ASSERT_EQ(200, result.size());
+  ASSERT_EQ(400, result.allocations);
+  ASSERT_DOUBLE_EQ(2, result.allocationsPerOp());
+  ASSERT_DOUBLE_EQ(1000 + sizeof(int), result.allocatedBytesPerOp());
+
+  config.autoIterations = true;
+  config.maxTime = timed::Time::fromNanoseconds(50 * timed::Time::NS_PER_MS);
+  int64_t x = 0;
+  timed::benchmark::Benchmark quiet(config, [&x]() { timed::benchmark::doNotOptimize(x += 1); });
+  const auto &quietResult = quiet.run();
+  ASSERT_TRUE(quietResult.allocationsTracked);
+  ASSERT_EQ(0, quietResult.allocations);
+  ASSERT_EQ(0, quietResult.peakLiveBytes);
+}
+
+TEST(AllocationTrackerTest, limit) {
+  timed::benchmark::Registry registry;
+  int64_t x = 0;
+  registry.add("quiet", [&x]() { timed::benchmark::doNotOptimize(x += 1); }).iterations(10).maxAllocationsPerOp(0);
+  timed::benchmark::RunOptions options;
+  std::stringstream out;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, out, registry));
+
+  registry.add("allocating", []() {
+    auto value = std::make_unique<int>(1);
+    timed::benchmark::doNotOptimize(value);
+  }).iterations(10).maxAllocationsPerOp(0);
+  ASSERT_EQ(3, timed::benchmark::runRegistered(options, out, registry));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
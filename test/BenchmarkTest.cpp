@@ -3,12 +3,252 @@
 //
 // This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
 
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
 #include <gtest/gtest.h>
 
 #include "timed/Benchmark.h"
+#include "timed/utils/Statistics.h"
+
+// used by the BUSY_WAIT_* macros
+using timed::WallTimer;
 
 TEST(BenchmarkTest, Config) {}
 
 TEST(BenchmarkTest, Result) {}
 
-TEST(BenchmarkTest, Benchmark) {}
\ No newline at end of file
+TEST(BenchmarkTest, Benchmark) {}
+
+TEST(BenchmarkTest, histogram) {
+  timed::benchmark::Config config;
+  config.iterations = 200;
+  config.histogram = true;
+  timed::benchmark::Benchmark benchmark(config, []() { SLEEP_US(50); });
+  auto &result = benchmark.run();
+  ASSERT_TRUE(result.histogramOnly);
+  ASSERT_TRUE(result.wallTimes.empty());
+  ASSERT_EQ(result.size(), 200);
+  ASSERT_EQ(result.wallHistogram.count(), 200);
+  ASSERT_EQ(result.cpuHistogram.count(), 200);
+  ASSERT_GE(result.wallHistogram.median().getMicroseconds(), 40);
+}
+
+TEST(BenchmarkTest, overhead) {
+  for (bool histogram: {false, true}) {
+    timed::benchmark::Config config;
+    config.iterations = 5;
+    config.histogram = histogram;
+    config.threadCpuTime = true;
+    timed::benchmark::Benchmark benchmark(config, []() {});
+    std::stringstream ss;
+    ss << benchmark.run();
+    ASSERT_NE(std::string::npos, ss.str().find(" thread CPU\n")) << ss.str();
+    config.threadCpuTime = false;
+    timed::benchmark::Benchmark withoutThreadCpu(config, []() {});
+    std::stringstream without;
+    without << withoutThreadCpu.run();
+    ASSERT_EQ(std::string::npos, without.str().find("thread CPU")) << without.str();
+  }
+}
+
+TEST(BenchmarkTest, basicBenchmark) {
+  timed::benchmark::Config config;
+  config.iterations = 50;
+  int calls = 0;
+  int setups = 0;
+  // deduced as BasicBenchmark<lambda, lambda>, both are called directly
+  timed::benchmark::BasicBenchmark benchmark(config, [&calls]() { ++calls; }, [&setups]() { ++setups; });
+  static_assert(!std::is_same<decltype(benchmark), timed::benchmark::Benchmark>::value);
+  auto &result = benchmark.run();
+  ASSERT_EQ(50, calls);
+  ASSERT_EQ(50, setups);
+  ASSERT_EQ(50, result.size());
+  ASSERT_EQ(config.title, result.title);
+
+  // without precedent operation
+  timed::benchmark::BasicBenchmark noSetup(config, [&calls]() { ++calls; });
+  noSetup.run();
+  ASSERT_EQ(100, calls);
+}
+
+TEST(BenchmarkTest, doNotOptimize) {
+  timed::benchmark::Config config;
+  config.autoIterations = true;
+  config.maxTime = timed::Time::fromNanoseconds(50 * timed::Time::NS_PER_MS);
+  uint64_t x = 0;
+  timed::benchmark::BasicBenchmark benchmark(config, [&x]() {
+    x += 3;
+    timed::benchmark::doNotOptimize(x);
+  });
+  auto &result = benchmark.run();
+  // calibration batches are not recorded
+  ASSERT_GE(x, 3 * result.batchSize * result.size());
+  ASSERT_EQ(0, x % 3);
+  const int constant = 42;
+  timed::benchmark::doNotOptimize(constant);
+  timed::benchmark::doNotOptimize(result);
+  timed::benchmark::clobberMemory();
+}
+
+TEST(BenchmarkTest, warmup) {
+  timed::benchmark::Config config;
+  config.iterations = 20;
+  config.warmupIterations = 5;
+  int calls = 0;
+  timed::benchmark::BasicBenchmark benchmark(config, [&calls]() { ++calls; });
+  auto &result = benchmark.run();
+  ASSERT_EQ(25, calls);
+  ASSERT_EQ(5, result.warmupWallTimes.size());
+  ASSERT_EQ(20, result.size());
+
+  // a second run warms up again, the warmup samples of the first run do not count
+  benchmark.run();
+  ASSERT_EQ(50, calls);
+  ASSERT_EQ(10, result.warmupWallTimes.size());
+  ASSERT_EQ(40, result.size());
+}
+
+TEST(BenchmarkTest, steadyStateWarmup) {
+  timed::benchmark::Config config;
+  config.iterations = 10;
+  config.detectSteadyState = true;
+  config.steadyStateWindow = 5;
+  config.steadyStateTolerance = 0.5;
+  int calls = 0;
+  // the first ten calls get faster (warming up), later ones take constant time
+  timed::benchmark::BasicBenchmark benchmark(config, [&calls]() {
+    BUSY_WAIT_US(std::max(100, 2000 - 200 * calls++));
+  });
+  auto &result = benchmark.run();
+  // the windows are not stable before the tenth call
+  ASSERT_GE(result.warmupWallTimes.size(), 10);
+  ASSERT_GE(result.warmupWallTimes.front().getMicroseconds(), 1500);
+  ASSERT_EQ(10, result.size());
+  ASSERT_LT(timed::utils::max(result.adjustedWallTimes()).getMicroseconds(), 1500);
+}
+
+TEST(BenchmarkTest, scaling) {
+  timed::benchmark::Config config;
+  config.iterations = 100;
+  config.threadCounts = {1, 2, 4};
+  std::atomic<uint64_t> calls{0};
+  timed::benchmark::BasicBenchmark benchmark(config, [&calls]() { calls.fetch_add(1); });
+  auto results = benchmark.runScaling();
+  ASSERT_EQ(3, results.size());
+  ASSERT_EQ(700, calls.load());
+  for (size_t i = 0; i < results.size(); ++i) {
+    ASSERT_EQ(config.threadCounts[i], results[i].threads);
+    ASSERT_EQ(100 * config.threadCounts[i], results[i].operations);
+    ASSERT_EQ(results[i].operations, results[i].latencies.wallTimes.size());
+    ASSERT_GT(results[i].throughput, 0);
+    ASSERT_GT(results[i].efficiency, 0);
+    ASSERT_FALSE(results[i].pinned);
+  }
+  ASSERT_DOUBLE_EQ(1.0, results[0].efficiency);
+}
+
+TEST(BenchmarkTest, scalingDescending) {
+  timed::benchmark::Config config;
+  config.iterations = 10;
+  config.threadCounts = {8, 4, 1};
+  timed::benchmark::BasicBenchmark benchmark(config, []() {});
+  auto results = benchmark.runScaling();
+  ASSERT_EQ(3, results.size());
+  ASSERT_EQ(1, results[2].threads);
+  // efficiency is relative to the smallest thread count, not to the first entry
+  ASSERT_DOUBLE_EQ(1.0, results[2].efficiency);
+}
+
+TEST(BenchmarkTest, scalingPinned) {
+  timed::benchmark::Config config;
+  config.iterations = 10;
+  config.threadCounts = {1};
+  config.pinThreads = true;
+  timed::benchmark::BasicBenchmark benchmark(config, []() {});
+  auto results = benchmark.runScaling();
+  ASSERT_EQ(1, results.size());
+#ifdef __linux__
+  ASSERT_TRUE(results[0].pinned);
+#endif
+  auto defaults = timed::benchmark::detail::defaultThreadCounts();
+  ASSERT_EQ(1, defaults.front());
+  ASSERT_EQ(std::max(std::thread::hardware_concurrency(), 1U), defaults.back());
+}
+
+TEST(BenchmarkTest, autoIterations) {
+  timed::benchmark::Config config;
+  config.autoIterations = true;
+  config.minSampleTime = timed::Time::fromNanoseconds(20 * timed::Time::NS_PER_US);
+  config.maxTime = timed::Time::fromNanoseconds(200 * timed::Time::NS_PER_MS);
+  volatile uint64_t counter = 0;
+  timed::benchmark::Benchmark benchmark(config, [&counter]() { counter = counter + 1; });
+  timed::WallTimer timer;
+  timer.start();
+  auto &result = benchmark.run();
+  timer.stop();
+  // a few nanoseconds per call: many calls per sample
+  ASSERT_GT(result.batchSize, 100);
+  ASSERT_GE(result.size(), 1);
+  ASSERT_EQ(result.wallTimes.size(), result.cpuTimes.size());
+  // samples are per call
+  ASSERT_LT(timed::utils::median(result.adjustedWallTimes()).count(), 1000);
+  // baseline measurement plus budget plus one batch
+  ASSERT_LT(timer.getTime().getMilliseconds(), 400);
+  ASSERT_GE(counter, result.batchSize * result.size());
+}
+
+TEST(BenchmarkTest, autoIterationsSlowOp) {
+  timed::benchmark::Config config;
+  config.autoIterations = true;
+  config.minSampleTime = timed::Time::fromNanoseconds(10 * timed::Time::NS_PER_US);
+  config.maxTime = timed::Time::fromNanoseconds(100 * timed::Time::NS_PER_MS);
+  config.minSamples = 5;
+  timed::benchmark::Benchmark benchmark(config, []() { SLEEP_US(100); });
+  auto &result = benchmark.run();
+  // a single call already takes longer than minSampleTime
+  ASSERT_EQ(result.batchSize, 1);
+  ASSERT_GE(result.size(), 5);
+  ASSERT_GE(timed::utils::median(result.adjustedWallTimes()).getMicroseconds(), 90);
+}
+TEST(BenchmarkTest, throughput) {
+  timed::benchmark::Config config;
+  config.iterations = 20;
+  config.bytesPerIteration = 1024 * 1024;
+  config.itemsPerIteration = 1000;
+  timed::benchmark::Benchmark benchmark(config, []() { SLEEP_US(1000); });
+  auto &result = benchmark.run();
+  ASSERT_EQ(config.bytesPerIteration, result.bytesPerIteration);
+  ASSERT_EQ(config.itemsPerIteration, result.itemsPerIteration);
+  // at least 1ms per call: at most 1 GiB/s and 1 M items/s
+  ASSERT_GT(result.bytesPerSecond(), 0);
+  ASSERT_LE(result.bytesPerSecond(), 1024.0 * 1024 * 1024 * 1.01);
+  ASSERT_LE(result.itemsPerSecond(), 1e6 * 1.01);
+  ASSERT_DOUBLE_EQ(result.bytesPerSecond() / result.itemsPerSecond(), 1024.0 * 1024 / 1000);
+  std::stringstream ss;
+  ss << result;
+  ASSERT_NE(std::string::npos, ss.str().find("Throughput:"));
+  ASSERT_NE(std::string::npos, ss.str().find("MiB/s"));
+
+  // nothing declared: no throughput
+  timed::benchmark::Result empty;
+  ASSERT_EQ(0, empty.bytesPerSecond());
+  ASSERT_EQ(0, empty.itemsPerSecond());
+}
+
+TEST(BenchmarkTest, allocationsNotTracked) {
+  // the AllocationTracker library is not linked into this test
+  ASSERT_FALSE(timed::allocationTrackingEnabled());
+  ASSERT_EQ(0, timed::threadAllocationCounters().allocations);
+  timed::benchmark::Config config;
+  config.iterations = 5;
+  timed::benchmark::Benchmark benchmark(config, []() { std::vector<int> v(10); });
+  auto &result = benchmark.run();
+  ASSERT_FALSE(result.allocationsTracked);
+  ASSERT_EQ(0, result.allocationsPerOp());
+  std::stringstream ss;
+  ss << result;
+  ASSERT_EQ(std::string::npos, ss.str().find("Allocations:"));
+}
@@ -0,0 +1,155 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "timed/Compare.h"
+#include "timed/Export.h"
+#include "timed/Registry.h"
+
+namespace {
+
+// samples around median ns with 2% noise
+timed::benchmark::Result makeResult(const std::string &title, double median, uint64_t seed) {
+  timed::benchmark::Result result;
+  result.title = title;
+  std::mt19937_64 gen(seed);
+  std::normal_distribution<double> noise(1, 0.02);
+  for (int i = 0; i < 200; ++i) {
+    result.wallTimes.push_back(timed::Time::fromNanoseconds(std::llround(median * noise(gen))));
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(CompareTest, verdicts) {
+  auto baseline = makeResult("bm", 1000, 1);
+  auto slower = timed::benchmark::compare(baseline, makeResult("bm", 1200, 2));
+  ASSERT_EQ(timed::benchmark::Verdict::SLOWER, slower.verdict);
+  ASSERT_NEAR(1.2, slower.ratio, 0.02);
+  ASSERT_LE(slower.ratioLow, slower.ratio);
+  ASSERT_GE(slower.ratioHigh, slower.ratio);
+  ASSERT_GT(slower.ratioLow, 1.15);
+  ASSERT_LT(slower.pValue, 0.001);
+  ASSERT_EQ(200, slower.baselineSamples);
+
+  auto faster = timed::benchmark::compare(baseline, makeResult("bm", 800, 3));
+  ASSERT_EQ(timed::benchmark::Verdict::FASTER, faster.verdict);
+
+  // same distribution
+  auto same = timed::benchmark::compare(baseline, makeResult("bm", 1000, 4));
+  ASSERT_EQ(timed::benchmark::Verdict::UNCHANGED, same.verdict);
+
+  // significant, but below the threshold
+  timed::benchmark::CompareOptions options;
+  options.threshold = 0.1;
+  auto small = timed::benchmark::compare(baseline, makeResult("bm", 1050, 5), options);
+  ASSERT_LT(small.pValue, options.alpha);
+  ASSERT_EQ(timed::benchmark::Verdict::UNCHANGED, small.verdict);
+
+  std::stringstream ss;
+  ss << slower;
+  ASSERT_EQ(0, ss.str().find("Comparison: 'bm': slower\n"));
+
+  // even sample counts: the median of the two middle values, as for the printed Result
+  timed::benchmark::Result even;
+  even.title = "even";
+  for (int64_t ns: {11000, 11020, 11100, 11200}) { even.wallTimes.push_back(timed::Time::fromNanoseconds(ns)); }
+  auto evenComparison = timed::benchmark::compare(even, even);
+  ASSERT_EQ(11060, evenComparison.baselineMedian.count());
+  std::stringstream evenOut;
+  evenOut << evenComparison;
+  ASSERT_NE(std::string::npos, evenOut.str().find("median:    11us60ns -> 11us60ns\n")) << evenOut.str();
+
+  timed::benchmark::Result histogram;
+  histogram.useHistograms(3);
+  ASSERT_THROW(timed::benchmark::compare(baseline, histogram), std::runtime_error);
+}
+
+TEST(CompareTest, paired) {
+  // strong drift over the run: unpaired, the 10% difference drowns in the spread of both samples
+  timed::benchmark::Result baseline;
+  timed::benchmark::Result contender;
+  baseline.title = "a";
+  contender.title = "b";
+  for (int i = 0; i < 100; ++i) {
+    double drift = 1000 + 50 * i;
+    baseline.wallTimes.push_back(timed::Time::fromNanoseconds(std::llround(drift)));
+    contender.wallTimes.push_back(timed::Time::fromNanoseconds(std::llround(1.1 * drift + (i % 3))));
+  }
+  ASSERT_EQ(timed::benchmark::Verdict::UNCHANGED, timed::benchmark::compare(baseline, contender).verdict);
+  auto paired = timed::benchmark::comparePaired(baseline, contender);
+  ASSERT_EQ("b", paired.title);
+  ASSERT_EQ(timed::benchmark::Verdict::SLOWER, paired.verdict);
+  ASSERT_NEAR(1.1, paired.ratio, 0.01);
+  ASSERT_LE(paired.ratioLow, paired.ratio);
+  ASSERT_GE(paired.ratioHigh, paired.ratio);
+  ASSERT_LT(paired.pValue, 0.001);
+  ASSERT_EQ(timed::benchmark::Verdict::UNCHANGED, timed::benchmark::comparePaired(baseline, baseline).verdict);
+
+  contender.wallTimes.pop_back();
+  ASSERT_THROW(timed::benchmark::comparePaired(baseline, contender), std::runtime_error);
+}
+
+TEST(CompareTest, matchByTitle) {
+  std::vector<timed::benchmark::Result> baseline = {makeResult("a", 1000, 1), makeResult("b", 1000, 2)};
+  std::vector<timed::benchmark::Result> contender = {makeResult("c", 1000, 3), makeResult("b", 2000, 4),
+                                                     makeResult("a", 1000, 5)};
+  auto comparisons = timed::benchmark::compare(baseline, contender);
+  ASSERT_EQ(2, comparisons.size());
+  ASSERT_EQ("b", comparisons[0].title);
+  ASSERT_EQ(timed::benchmark::Verdict::SLOWER, comparisons[0].verdict);
+  ASSERT_EQ("a", comparisons[1].title);
+  ASSERT_TRUE(timed::benchmark::hasRegression(comparisons));
+  comparisons.erase(comparisons.begin());
+  ASSERT_FALSE(timed::benchmark::hasRegression(comparisons));
+}
+
+TEST(CompareTest, runWithBaseline) {
+  std::string path = testing::TempDir() + "timed_compare_baseline.bin";
+  {
+    std::ofstream file(path, std::ios::binary);
+    timed::benchmark::writeSamples(file, makeResult("fast", 1, 1));
+    timed::benchmark::writeSamples(file, makeResult("other", 1000, 2));
+  }
+  auto loaded = timed::benchmark::loadBaseline(path);
+  ASSERT_EQ(2, loaded.size());
+  ASSERT_EQ("other", loaded[1].title);
+
+  // a 200us op is far slower than the 1ns baseline
+  timed::benchmark::Registry registry;
+  registry.add("fast", []() {
+    timed::WallTimer timer;
+    timer.start();
+    while (timer.getTime().getMicroseconds() < 200) {}
+  }).iterations(20);
+  timed::benchmark::RunOptions options;
+  options.baseline = path;
+  std::stringstream out;
+  ASSERT_EQ(2, timed::benchmark::runRegistered(options, out, registry));
+  ASSERT_NE(std::string::npos, out.str().find("Comparison: 'fast': slower"));
+
+  options.baseline = path + ".missing";
+  ASSERT_THROW(timed::benchmark::runRegistered(options, out, registry), std::runtime_error);
+  std::remove(path.c_str());
+
+  const char *argv[] = {"bench", "--baseline=base.bin", "--threshold=0.1", "--alpha=0.01"};
+  auto parsed = timed::benchmark::parseArguments(4, argv);
+  ASSERT_EQ("base.bin", parsed.baseline);
+  ASSERT_DOUBLE_EQ(0.1, parsed.compare.threshold);
+  ASSERT_DOUBLE_EQ(0.01, parsed.compare.alpha);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
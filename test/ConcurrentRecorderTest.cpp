@@ -0,0 +1,102 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "timed/ConcurrentRecorder.h"
+
+using namespace timed;
+
+TEST(ConcurrentRecorderTest, single_thread) {
+  ConcurrentRecorder recorder;
+  for (int i = 0; i < 10000; ++i) {
+    recorder.record(Time::fromNanoseconds(i), Time::fromNanoseconds(2 * i));
+  }
+  benchmark::Result result;
+  ASSERT_EQ(recorder.collect(result), 10000);
+  ASSERT_EQ(result.wallTimes.size(), 10000);
+  ASSERT_EQ(result.cpuTimes.size(), 10000);
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(result.wallTimes[i].count(), i);
+    ASSERT_EQ(result.cpuTimes[i].count(), 2 * i);
+  }
+  // already collected samples are not collected again
+  ASSERT_EQ(recorder.collect(result), 0);
+  // a wall time without CPU time would break the pairing of wall and CPU times
+  ASSERT_THROW(recorder.record(Time::fromNanoseconds(1)), std::runtime_error);
+  ASSERT_EQ(recorder.collect(result), 0);
+  recorder.record(Time::fromNanoseconds(1), Time::fromNanoseconds(2));
+  ASSERT_EQ(recorder.collect(result), 1);
+  ASSERT_EQ(result.wallTimes.size(), 10001);
+  ASSERT_EQ(result.cpuTimes.size(), 10001);
+  ASSERT_EQ(recorder.threadCount(), 1);
+
+  ConcurrentRecorder wallOnly;
+  wallOnly.record(Time::fromNanoseconds(1));
+  ASSERT_THROW(wallOnly.record(Time::fromNanoseconds(1), Time::fromNanoseconds(2)), std::runtime_error);
+}
+
+TEST(ConcurrentRecorderTest, collect_while_recording) {
+  const int numThreads = 4;
+  const int samplesPerThread = 100000;
+  ConcurrentRecorder recorder;
+  benchmark::Result result;
+  std::atomic<int> finished{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&recorder, &finished, t]() {
+      for (int i = 0; i < samplesPerThread; ++i) {
+        recorder.record(Time::fromNanoseconds(t));
+      }
+      finished.fetch_add(1);
+    });
+  }
+  size_t collected = 0;
+  while (finished.load() < numThreads) {
+    collected += recorder.collect(result);
+  }
+  for (auto &t: threads) {
+    t.join();
+  }
+  collected += recorder.collect(result);
+  ASSERT_EQ(collected, numThreads * samplesPerThread);
+  ASSERT_EQ(result.wallTimes.size(), numThreads * samplesPerThread);
+  std::vector<int> perThread(numThreads, 0);
+  for (const auto &t: result.wallTimes) {
+    perThread[t.count()]++;
+  }
+  for (int t = 0; t < numThreads; ++t) {
+    ASSERT_EQ(perThread[t], samplesPerThread);
+  }
+  ASSERT_EQ(recorder.threadCount(), numThreads);
+}
+
+TEST(ConcurrentRecorderTest, multiple_recorders) {
+  ConcurrentRecorder a;
+  ConcurrentRecorder b;
+  for (int i = 0; i < 10; ++i) {
+    a.record(Time::fromNanoseconds(1));
+    b.record(Time::fromNanoseconds(2));
+  }
+  benchmark::Result resultA;
+  benchmark::Result resultB;
+  ASSERT_EQ(a.collect(resultA), 10);
+  ASSERT_EQ(b.collect(resultB), 10);
+  ASSERT_EQ(resultA.wallTimes.back().count(), 1);
+  ASSERT_EQ(resultB.wallTimes.back().count(), 2);
+  // alternating between recorders keeps one buffer per recorder
+  ASSERT_EQ(a.threadCount(), 1);
+  ASSERT_EQ(b.threadCount(), 1);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
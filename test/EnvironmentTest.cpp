@@ -0,0 +1,84 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "timed/Benchmark.h"
+#include "timed/Environment.h"
+#include "timed/Registry.h"
+
+TEST(EnvironmentTest, machineContext) {
+  auto context = timed::machineContext();
+  ASSERT_GT(context.cores, 0);
+#ifdef __linux__
+  ASSERT_EQ(0, context.kernel.rfind("Linux ", 0));
+  ASSERT_GE(context.loadAverage[0], 0);
+#endif
+  std::stringstream ss;
+  ss << context;
+  ASSERT_NE(std::string::npos, ss.str().find(std::to_string(context.cores) + " cores"));
+}
+
+TEST(EnvironmentTest, warnings) {
+  timed::MachineContext context;
+  context.cores = 4;
+  ASSERT_TRUE(timed::environmentWarnings(context).empty());
+  context.governor = "performance";
+  context.turbo = 0;
+  context.loadAverage = {3.5, 1, 1};
+  ASSERT_TRUE(timed::environmentWarnings(context).empty());
+
+  context.governor = "powersave";
+  context.turbo = 1;
+  context.loadAverage = {6, 1, 1};
+  auto warnings = timed::environmentWarnings(context);
+  ASSERT_EQ(3, warnings.size());
+  ASSERT_NE(std::string::npos, warnings[0].find("'powersave'"));
+  ASSERT_NE(std::string::npos, warnings[1].find("turbo"));
+  ASSERT_EQ("load average 6.00 exceeds 4 cores", warnings[2]);
+}
+
+TEST(EnvironmentTest, benchmark) {
+  timed::benchmark::Config config;
+  config.iterations = 10;
+  config.pinCpu = 0;
+  config.lockMemory = true;
+  config.realtimePriority = 1;
+  int64_t x = 0;
+  timed::benchmark::Benchmark benchmark(config, [&x]() { timed::benchmark::doNotOptimize(x += 1); });
+  const auto &result = benchmark.run();
+  ASSERT_EQ(10, result.size());
+  ASSERT_GT(result.machine.cores, 0);
+  auto expected = timed::environmentWarnings(result.machine);
+  ASSERT_GE(result.warnings.size(), expected.size());
+  // settings that need privileges may fail, failures are warnings
+  for (const auto &warning: result.warnings) {
+    bool failure = warning.rfind("cannot", 0) == 0;
+    ASSERT_TRUE(failure || std::find(expected.begin(), expected.end(), warning) != expected.end()) << warning;
+  }
+  if (!result.warnings.empty()) {
+    std::stringstream ss;
+    ss << result;
+    ASSERT_NE(std::string::npos, ss.str().find(" Warning: " + result.warnings[0] + "\n"));
+  }
+}
+
+TEST(EnvironmentTest, parseArguments) {
+  const char *argv[] = {"bench", "--pin-cpu=2", "--realtime-priority=10", "--lock-memory"};
+  auto options = timed::benchmark::parseArguments(4, argv);
+  ASSERT_EQ(2, options.pinCpu);
+  ASSERT_EQ(10, options.realtimePriority);
+  ASSERT_TRUE(options.lockMemory);
+  const char *invalid[] = {"bench", "--realtime-priority=100"};
+  ASSERT_THROW(timed::benchmark::parseArguments(2, invalid), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
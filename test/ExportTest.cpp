@@ -0,0 +1,233 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "timed/Export.h"
+#include "timed/Reporter.h"
+
+namespace {
+
+timed::benchmark::Result makeResult(size_t samples, bool threadCpu) {
+  timed::benchmark::Result result;
+  result.title = "name with \"quotes\"";
+  result.wallTimeBaseline = timed::Time::fromNanoseconds(40);
+  result.cpuTimeBaseline = timed::Time::fromNanoseconds(30);
+  result.batchSize = 7;
+  std::mt19937_64 gen(samples);
+  std::uniform_int_distribution<int64_t> dist(100, 1000000);
+  for (size_t i = 0; i < samples; ++i) {
+    result.wallTimes.push_back(timed::Time::fromNanoseconds(dist(gen)));
+    result.cpuTimes.push_back(timed::Time::fromNanoseconds(dist(gen)));
+    if (threadCpu) result.threadCpuTimes.push_back(timed::Time::fromNanoseconds(dist(gen)));
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(ExportTest, json) {
+  auto result = makeResult(100, false);
+  result.bytesPerIteration = 64;
+  std::stringstream ss;
+  timed::benchmark::writeJson(ss, result);
+  auto json = ss.str();
+  ASSERT_EQ('{', json.front());
+  ASSERT_EQ('}', json.back());
+  ASSERT_NE(std::string::npos, json.find("\"name\": \"name with \\\"quotes\\\"\""));
+  ASSERT_NE(std::string::npos, json.find("\"samples\": 100"));
+  ASSERT_NE(std::string::npos, json.find("\"batch_size\": 7"));
+  ASSERT_NE(std::string::npos, json.find("\"overhead_ns\": {\"wall\": 40, \"cpu\": 30"));
+  ASSERT_NE(std::string::npos, json.find("\"wall_time_ns\": {\"min\": "));
+  ASSERT_NE(std::string::npos, json.find("\"bytes_per_iteration\": 64"));
+  ASSERT_EQ(std::string::npos, json.find("thread_cpu_time_ns"));
+  ASSERT_EQ("\"a\\nb\\u0001\"", timed::benchmark::jsonString("a\nb\x01"));
+
+  std::stringstream fit;
+  timed::benchmark::writeJson(fit, "sort/n", timed::utils::ComplexityFit{timed::utils::Complexity::O_N, 2, 0, 0});
+  ASSERT_EQ("{\"type\": \"complexity\", \"name\": \"sort/n\", \"complexity\": \"O(n)\", \"coefficient_ns\": 2, "
+            "\"rms_ns\": 0, \"relative_rms\": 0}", fit.str());
+}
+
+TEST(ExportTest, csv) {
+  auto result = makeResult(3, true);
+  std::stringstream ss;
+  timed::benchmark::writeCsvHeader(ss);
+  timed::benchmark::writeCsv(ss, result);
+  std::string line;
+  std::getline(ss, line);
+  ASSERT_EQ("benchmark,sample,wall_ns,cpu_ns,thread_cpu_ns", line);
+  std::getline(ss, line);
+  std::string expected = "\"name with \"\"quotes\"\"\",0," + std::to_string(result.wallTimes[0].count()) + "," +
+                         std::to_string(result.cpuTimes[0].count()) + "," +
+                         std::to_string(result.threadCpuTimes[0].count());
+  ASSERT_EQ(expected, line);
+  size_t rows = 1;
+  while (std::getline(ss, line)) { ++rows; }
+  ASSERT_EQ(3, rows);
+}
+
+TEST(ExportTest, binaryRoundTrip) {
+  for (bool threadCpu: {false, true}) {
+    // several blocks and a partial one
+    auto result = makeResult(3 * timed::benchmark::SampleWriter::DEFAULT_BLOCK_SIZE + 17, threadCpu);
+    std::stringstream ss;
+    timed::benchmark::writeSamples(ss, result);
+    // delta + varint: far below 8 bytes per value
+    ASSERT_LT(ss.str().size(), result.wallTimes.size() * (threadCpu ? 3 : 2) * 4);
+    auto read = timed::benchmark::readSamples(ss);
+    ASSERT_EQ(result.title, read.title);
+    ASSERT_EQ(7, read.batchSize);
+    ASSERT_EQ(result.wallTimeBaseline, read.wallTimeBaseline);
+    ASSERT_EQ(result.cpuTimeBaseline, read.cpuTimeBaseline);
+    ASSERT_EQ(result.wallTimes, read.wallTimes);
+    ASSERT_EQ(result.cpuTimes, read.cpuTimes);
+    ASSERT_EQ(result.threadCpuTimes, read.threadCpuTimes);
+  }
+}
+
+TEST(ExportTest, resultRoundTrip) {
+  auto result = makeResult(1000, true);
+  result.info = "info";
+  result.bytesPerIteration = 4096;
+  result.itemsPerIteration = 3;
+  result.warmupWallTimes = {timed::Time::fromNanoseconds(500), timed::Time::fromNanoseconds(-1)};
+  result.perfCounters = {{timed::PerfEvent::INSTRUCTIONS, 12.5}};
+  result.perfCountersError = "error";
+  result.allocationsTracked = true;
+  result.allocations = 2000;
+  result.allocatedBytes = 1 << 20;
+  result.peakLiveBytes = 512;
+  result.machine.cpuModel = "CPU";
+  result.machine.cores = 8;
+  result.machine.turbo = 0;
+  result.machine.loadAverage = {0.5, 1.25, 2};
+  result.warnings = {"first", "second"};
+  std::stringstream ss;
+  timed::benchmark::writeResult(ss, result);
+  timed::benchmark::writeResult(ss, makeResult(10, false));
+  auto read = timed::benchmark::readResult(ss);
+  ASSERT_EQ(result.title, read.title);
+  ASSERT_EQ("info", read.info);
+  ASSERT_EQ(7, read.batchSize);
+  ASSERT_EQ(4096, read.bytesPerIteration);
+  ASSERT_EQ(3, read.itemsPerIteration);
+  ASSERT_EQ(result.warmupWallTimes, read.warmupWallTimes);
+  ASSERT_EQ(1, read.perfCounters.size());
+  ASSERT_EQ(timed::PerfEvent::INSTRUCTIONS, read.perfCounters[0].event);
+  ASSERT_DOUBLE_EQ(12.5, read.perfCounters[0].perOp);
+  ASSERT_EQ("error", read.perfCountersError);
+  ASSERT_TRUE(read.allocationsTracked);
+  ASSERT_EQ(2000, read.allocations);
+  ASSERT_EQ(1 << 20, read.allocatedBytes);
+  ASSERT_EQ(512, read.peakLiveBytes);
+  ASSERT_EQ("CPU", read.machine.cpuModel);
+  ASSERT_EQ(8, read.machine.cores);
+  ASSERT_EQ(0, read.machine.turbo);
+  ASSERT_EQ(result.machine.loadAverage, read.machine.loadAverage);
+  ASSERT_EQ(result.warnings, read.warnings);
+  ASSERT_EQ(result.threadCpuTimeBaseline, read.threadCpuTimeBaseline);
+  ASSERT_EQ(result.wallTimes, read.wallTimes);
+  ASSERT_EQ(result.threadCpuTimes, read.threadCpuTimes);
+  ASSERT_EQ(10, timed::benchmark::readResult(ss).size());
+
+  std::stringstream samplesOnly;
+  timed::benchmark::writeSamples(samplesOnly, result);
+  ASSERT_THROW(timed::benchmark::readResult(samplesOnly), std::runtime_error);
+  result.useHistograms(3);
+  ASSERT_THROW(timed::benchmark::writeResult(ss, result), std::runtime_error);
+}
+
+TEST(ExportTest, streamingReader) {
+  std::stringstream ss;
+  {
+    timed::benchmark::SampleWriter writer(ss, "stream", {"a", "b"}, {timed::Time(), timed::Time::fromNanoseconds(-5)},
+                                          1, 4);
+    for (int64_t i = 0; i < 10; ++i) {
+      // negative values and deltas
+      writer.add({timed::Time::fromNanoseconds(i * i), timed::Time::fromNanoseconds(-i * 1000)});
+    }
+    ASSERT_THROW(writer.add({timed::Time()}), std::runtime_error);
+  }
+  // a second stream follows the first one
+  timed::benchmark::writeSamples(ss, makeResult(5, false));
+
+  timed::benchmark::SampleReader reader(ss);
+  ASSERT_EQ("stream", reader.title());
+  ASSERT_EQ((std::vector<std::string>{"a", "b"}), reader.columns());
+  ASSERT_EQ(-5, reader.baselines()[1].count());
+  std::vector<timed::Time> row;
+  int64_t i = 0;
+  while (reader.next(row)) {
+    ASSERT_EQ(i * i, row[0].count());
+    ASSERT_EQ(-i * 1000, row[1].count());
+    ++i;
+  }
+  ASSERT_EQ(10, i);
+  ASSERT_FALSE(reader.next(row));
+  ASSERT_EQ(5, timed::benchmark::readSamples(ss).wallTimes.size());
+}
+
+TEST(ExportTest, corruptStreams) {
+  std::stringstream notSamples("hello world");
+  ASSERT_THROW(timed::benchmark::SampleReader reader(notSamples), std::runtime_error);
+
+  std::stringstream ss;
+  timed::benchmark::writeSamples(ss, makeResult(1000, false));
+  std::string data = ss.str();
+  std::stringstream truncated(data.substr(0, data.size() / 2));
+  ASSERT_THROW(timed::benchmark::readSamples(truncated), std::runtime_error);
+
+  // a block claiming more rows than a writer ever puts into one block must not be allocated
+  std::stringstream header;
+  timed::benchmark::SampleWriter(header, "huge", {"wall"}, {timed::Time()}).finish();
+  std::string huge = header.str().substr(0, header.str().size() - 1);
+  // 2^32 rows, 2^34 bytes (varints)
+  huge += std::string("\x80\x80\x80\x80\x10\x80\x80\x80\x80\x40", 10);
+  std::stringstream hugeBlock(huge);
+  ASSERT_THROW(timed::benchmark::readSamples(hugeBlock), std::runtime_error);
+
+  timed::benchmark::Result histogram;
+  histogram.useHistograms(3);
+  ASSERT_THROW(timed::benchmark::writeSamples(ss, histogram), std::runtime_error);
+}
+
+TEST(ExportTest, reporters) {
+  auto result = makeResult(10, false);
+  std::stringstream json;
+  auto reporter = timed::benchmark::makeReporter("json", json);
+  reporter->begin();
+  reporter->report(result);
+  reporter->report("sort/n", timed::utils::ComplexityFit());
+  reporter->end();
+  ASSERT_EQ(0, json.str().find("{\"benchmarks\": [\n  {\"type\": \"result\""));
+  ASSERT_NE(std::string::npos, json.str().find("},\n  {\"type\": \"complexity\""));
+  ASSERT_EQ("}\n]}\n", json.str().substr(json.str().size() - 5));
+
+  std::stringstream csv;
+  reporter = timed::benchmark::makeReporter("csv", csv);
+  reporter->begin();
+  reporter->report(result);
+  reporter->end();
+  std::string rows = csv.str();
+  ASSERT_EQ(11, std::count(rows.begin(), rows.end(), '\n'));
+
+  std::stringstream binary;
+  reporter = timed::benchmark::makeReporter("binary", binary);
+  reporter->report(result);
+  ASSERT_EQ(result.wallTimes, timed::benchmark::readSamples(binary).wallTimes);
+
+  ASSERT_THROW(timed::benchmark::makeReporter("xml", json), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
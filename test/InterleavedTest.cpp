@@ -0,0 +1,87 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "timed/Interleaved.h"
+
+namespace {
+
+int64_t work(int n) {
+  int64_t x = 0;
+  for (int i = 0; i < n; ++i) {
+    timed::benchmark::doNotOptimize(x += i);
+  }
+  return x;
+}
+
+}  // namespace
+
+TEST(InterleavedTest, run) {
+  timed::benchmark::Config config;
+  config.iterations = 200;
+  config.warmupIterations = 5;
+  int precedentCalls = 0;
+  timed::benchmark::InterleavedBenchmark benchmark(config);
+  // both short entries run the very same code, two separately inlined copies of the loop may differ in speed just by
+  // their alignment
+  auto shortOp = []() { work(2000); };
+  benchmark.add("short", shortOp, [&precedentCalls]() { ++precedentCalls; })
+           .add("long", []() { work(8000); })
+           .add("short again", shortOp);
+  ASSERT_EQ(3, benchmark.size());
+  const auto &result = benchmark.run();
+  ASSERT_EQ(3, result.results.size());
+  ASSERT_EQ(205, precedentCalls);
+  for (const auto &r: result.results) {
+    ASSERT_EQ(200, r.size());
+    ASSERT_EQ(5, r.warmupWallTimes.size());
+    ASSERT_EQ(1, r.batchSize);
+    ASSERT_GT(r.machine.cores, 0);
+  }
+  ASSERT_EQ("long", result.results[1].title);
+  ASSERT_EQ(2, result.comparisons.size());
+  ASSERT_EQ("long", result.comparisons[0].title);
+  ASSERT_EQ(timed::benchmark::Verdict::SLOWER, result.comparisons[0].verdict);
+  ASSERT_GT(result.comparisons[0].ratio, 1.5);
+  ASSERT_EQ(200, result.comparisons[0].baselineSamples);
+  ASSERT_LT(result.comparisons[1].ratio, 1.5);
+
+  std::stringstream ss;
+  ss << result;
+  ASSERT_NE(std::string::npos, ss.str().find("Benchmark: 'short again'\n"));
+  ASSERT_NE(std::string::npos, ss.str().find("Relative speed (200 interleaved rounds, baseline 'short'):\n"));
+  ASSERT_NE(std::string::npos, ss.str().find("  'long': ratio "));
+}
+
+TEST(InterleavedTest, autoIterations) {
+  timed::benchmark::Config config;
+  config.iterations = 20;
+  config.autoIterations = true;
+  config.minSampleTime = timed::Time::fromNanoseconds(100 * timed::Time::NS_PER_US);
+  int64_t x = 0;
+  timed::benchmark::InterleavedBenchmark benchmark(config);
+  benchmark.add("tiny", [&x]() { timed::benchmark::doNotOptimize(x += 1); })
+           .add("small", []() { work(1000); });
+  const auto &result = benchmark.run();
+  ASSERT_GT(result.results[0].batchSize, result.results[1].batchSize);
+  ASSERT_GT(result.results[1].batchSize, 1);
+  ASSERT_EQ(20, result.results[0].size());
+  ASSERT_EQ(20, result.results[1].size());
+}
+
+TEST(InterleavedTest, empty) {
+  timed::benchmark::InterleavedBenchmark benchmark;
+  ASSERT_THROW(benchmark.run(), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <gtest/gtest.h>
+
+#include "timed/IntervalStorage.h"
+#include "timed/Timer.h"
+
+using namespace timed;
+
+using TickInterval = std::pair<uint64_t, uint64_t>;
+
+TEST(AccumulatorStorageTest, open_close) {
+  AccumulatorStorage<TickInterval> storage;
+  ASSERT_TRUE(storage.intervals().empty());
+  storage.open(10);
+  ASSERT_EQ(storage.close(15), 5);
+  storage.open(20);
+  ASSERT_EQ(storage.close(30), 10);
+  ASSERT_EQ(storage.total(), 15);
+  ASSERT_EQ(storage.intervals().size(), 1);
+  ASSERT_EQ(storage.back(), TickInterval(20, 30));
+  storage.clear();
+  ASSERT_EQ(storage.total(), 0);
+  ASSERT_TRUE(storage.intervals().empty());
+}
+
+TEST(RingBufferStorageTest, open_close) {
+  RingBufferStorage<TickInterval, 2> storage;
+  ASSERT_TRUE(storage.intervals().empty());
+  storage.open(0);
+  storage.close(1);
+  storage.open(10);
+  storage.close(12);
+  storage.open(20);
+  storage.close(23);
+  // oldest interval is overwritten but still counted
+  ASSERT_EQ(storage.total(), 6);
+  auto intervals = storage.intervals();
+  ASSERT_EQ(intervals.size(), 2);
+  ASSERT_EQ(intervals[0], TickInterval(10, 12));
+  ASSERT_EQ(intervals[1], TickInterval(20, 23));
+  storage.clear();
+  ASSERT_EQ(storage.total(), 0);
+  ASSERT_TRUE(storage.intervals().empty());
+}
+
+TEST(VectorStorageTest, open_close) {
+  VectorStorage<TickInterval> storage;
+  storage.open(0);
+  storage.close(1);
+  storage.open(10);
+  storage.close(12);
+  storage.open(20);
+  storage.close(23);
+  ASSERT_EQ(storage.total(), 6);
+  ASSERT_EQ(storage.intervals().size(), 3);
+  ASSERT_EQ(storage.back(), TickInterval(20, 23));
+}
+
+TEST(IntervalStorageTest, timer_policies) {
+  {
+    BasicWallTimer<AccumulatorStorage<SteadyClockInterval>> wallTimer;
+    wallTimer.start();
+    SLEEP_MS(10);
+    wallTimer.pause();
+    wallTimer.start();
+    SLEEP_MS(10);
+    auto time = wallTimer.stop();
+    ASSERT_NEAR(time.getMilliseconds(), 20, 2);
+    ASSERT_EQ(wallTimer.getIntervals().size(), 1);
+  }
+  {
+    BasicWallTimer<RingBufferStorage<SteadyClockInterval, 4>> wallTimer;
+    for (int i = 0; i < 6; ++i) {
+      wallTimer.start();
+      SLEEP_MS(5);
+      wallTimer.pause();
+    }
+    ASSERT_NEAR(wallTimer.getTime().getMilliseconds(), 30, 3);
+    ASSERT_EQ(wallTimer.getIntervals().size(), 4);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
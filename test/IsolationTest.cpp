@@ -0,0 +1,120 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <csignal>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "timed/Isolation.h"
+#include "timed/Registry.h"
+
+namespace {
+
+int counter = 0;
+
+timed::benchmark::Result makeResult(const std::string &title) {
+  timed::benchmark::Config config;
+  config.title = title;
+  config.iterations = 10;
+  timed::benchmark::Benchmark benchmark(config, []() { timed::benchmark::doNotOptimize(++counter); });
+  return benchmark.run();
+}
+
+}  // namespace
+
+TEST(IsolationTest, results) {
+  auto run = timed::benchmark::runIsolated([]() {
+    return std::vector<timed::benchmark::Result>{makeResult("first"), makeResult("second")};
+  });
+  ASSERT_TRUE(run.ok()) << run.error;
+  ASSERT_EQ(2, run.results.size());
+  ASSERT_EQ("first", run.results[0].title);
+  ASSERT_EQ("second", run.results[1].title);
+  ASSERT_EQ(10, run.results[1].size());
+  ASSERT_GT(run.results[0].machine.cores, 0);
+  // the child ran op on its own copy of the memory
+  ASSERT_EQ(0, counter);
+}
+
+TEST(IsolationTest, failures) {
+  auto thrown = timed::benchmark::runIsolated([]() -> std::vector<timed::benchmark::Result> {
+    throw std::runtime_error("broken benchmark");
+  });
+  ASSERT_FALSE(thrown.ok());
+  ASSERT_EQ("broken benchmark", thrown.error);
+
+  auto crashed = timed::benchmark::runIsolated([]() -> std::vector<timed::benchmark::Result> {
+    std::raise(SIGSEGV);
+    return {};
+  });
+  ASSERT_FALSE(crashed.ok());
+  ASSERT_EQ(0, crashed.error.rfind("killed by signal " + std::to_string(SIGSEGV), 0)) << crashed.error;
+  ASSERT_TRUE(crashed.results.empty());
+
+  auto timedOut = timed::benchmark::runIsolated([]() {
+    std::this_thread::sleep_for(std::chrono::seconds(10));
+    return std::vector<timed::benchmark::Result>();
+  }, timed::Time::fromNanoseconds(100 * timed::Time::NS_PER_MS));
+  ASSERT_EQ("timed out after 100ms", timedOut.error);
+
+  auto histogram = timed::benchmark::runIsolated([]() {
+    timed::benchmark::Result result;
+    result.useHistograms(3);
+    return std::vector<timed::benchmark::Result>{result};
+  });
+  ASSERT_NE(std::string::npos, histogram.error.find("histogram-only"));
+}
+
+TEST(IsolationTest, registry) {
+  timed::benchmark::Registry registry;
+  registry.add("fine", []() { timed::benchmark::doNotOptimize(++counter); }).iterations(10);
+  registry.add("crashing", []() { std::raise(SIGABRT); }).iterations(10);
+  registry.add("fine too", []() { timed::benchmark::doNotOptimize(++counter); }).iterations(10);
+  const char *argv[] = {"bench", "--isolate=repetition", "--repetitions=2", "--timeout=10s"};
+  auto options = timed::benchmark::parseArguments(4, argv);
+  ASSERT_EQ(timed::benchmark::Isolation::REPETITION, options.isolation);
+  ASSERT_EQ(10, options.timeout.getSeconds());
+  std::stringstream out;
+  ASSERT_EQ(4, timed::benchmark::runRegistered(options, out, registry));
+  ASSERT_NE(std::string::npos, out.str().find("Benchmark: 'fine [2/2]'"));
+  ASSERT_NE(std::string::npos, out.str().find("Benchmark: 'fine too [1/2]'"));
+  ASSERT_EQ(std::string::npos, out.str().find("Benchmark: 'crashing"));
+  ASSERT_EQ(0, counter);
+
+  options.isolation = timed::benchmark::Isolation::BENCHMARK;
+  options.filter = "fine";
+  std::stringstream benchmarkOut;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, benchmarkOut, registry));
+  ASSERT_NE(std::string::npos, benchmarkOut.str().find("Benchmark: 'fine too [2/2]'"));
+
+  const char *isolate[] = {"bench", "--isolate"};
+  ASSERT_EQ(timed::benchmark::Isolation::BENCHMARK, timed::benchmark::parseArguments(2, isolate).isolation);
+  const char *invalid[] = {"bench", "--isolate=thread"};
+  ASSERT_THROW(timed::benchmark::parseArguments(2, invalid), std::runtime_error);
+  const char *timeoutOnly[] = {"bench", "--timeout=10s"};
+  ASSERT_THROW(timed::benchmark::parseArguments(2, timeoutOnly), std::runtime_error);
+}
+
+TEST(IsolationTest, histogramOnlyRejected) {
+  timed::benchmark::Registry registry;
+  registry.add("histogram", []() {}).iterations(10).configure([](timed::benchmark::Config &config) {
+    config.histogram = true;
+  });
+  timed::benchmark::RunOptions options;
+  options.isolation = timed::benchmark::Isolation::REPETITION;
+  std::stringstream out;
+  ASSERT_THROW(timed::benchmark::runRegistered(options, out, registry), std::runtime_error);
+  ASSERT_TRUE(out.str().empty());
+  options.isolation = timed::benchmark::Isolation::NONE;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, out, registry));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,79 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "timed/Benchmark.h"
+#include "timed/PerfCounters.h"
+
+namespace {
+
+void work() {
+  uint64_t x = 0;
+  for (uint64_t i = 0; i < 10000; ++i) { timed::benchmark::doNotOptimize(x += i); }
+}
+
+}  // namespace
+
+TEST(PerfCountersTest, timer) {
+  timed::PerfCounterTimer timer;
+  if (!timer.available()) {
+    // graceful degradation: no counters, but a reason and no effect of start()/stop()
+    ASSERT_FALSE(timer.error().empty());
+    ASSERT_TRUE(timer.events().empty());
+    timer.start();
+    timer.stop();
+    ASSERT_TRUE(timer.getCounts().empty());
+    ASSERT_EQ(0, timer.getCount(timed::PerfEvent::CYCLES));
+    GTEST_SKIP() << timer.error();
+  }
+  ASSERT_EQ(timer.events().size(), timer.getCounts().size());
+  timer.start();
+  work();
+  timer.stop();
+  double instructions = timer.getCount(timed::PerfEvent::INSTRUCTIONS);
+  if (instructions > 0) {
+    ASSERT_GT(instructions, 10000);
+  }
+  // stop() without start() does not count
+  timer.stop();
+  ASSERT_EQ(instructions, timer.getCount(timed::PerfEvent::INSTRUCTIONS));
+  timer.reset();
+  ASSERT_EQ(0, timer.getCount(timed::PerfEvent::INSTRUCTIONS));
+}
+
+TEST(PerfCountersTest, benchmark) {
+  timed::benchmark::Config config;
+  config.iterations = 50;
+  config.perfCounters = true;
+  timed::benchmark::Benchmark benchmark(config, work);
+  const auto &result = benchmark.run();
+  ASSERT_EQ(50, result.size());
+  std::stringstream ss;
+  ss << result;
+  // either counters or the reason why there are none
+  ASSERT_NE(result.perfCounters.empty(), result.perfCountersError.empty());
+  if (result.perfCounters.empty()) {
+    ASSERT_NE(std::string::npos, ss.str().find(" Counters: unavailable ("));
+  } else {
+    ASSERT_NE(std::string::npos, ss.str().find(" Counters (per op):\n"));
+    if (result.perfCounter(timed::PerfEvent::INSTRUCTIONS) > 0) {
+      ASSERT_GT(result.perfCounter(timed::PerfEvent::INSTRUCTIONS), 10000);
+    }
+  }
+
+  config.perfCounters = false;
+  timed::benchmark::Benchmark plain(config, work);
+  ASSERT_TRUE(plain.run().perfCounters.empty());
+  ASSERT_TRUE(plain.getResult().perfCountersError.empty());
+  ASSERT_EQ(0, plain.getResult().instructionsPerCycle());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
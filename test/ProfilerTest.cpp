@@ -0,0 +1,83 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "timed/Profiler.h"
+
+using namespace timed;
+using namespace timed::profiler;
+
+namespace {
+
+void leaf() {
+  TIMED_ZONE("leaf");
+  SLEEP_MS(2);
+}
+
+void outer() {
+  TIMED_ZONE("outer");
+  for (int i = 0; i < 3; ++i) {
+    leaf();
+  }
+  SLEEP_MS(2);
+}
+
+const ZoneStats *child(const ZoneStats &stats, const std::string &name) {
+  for (const auto &c: stats.children) {
+    if (c.name == name) { return &c; }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(ProfilerTest, nested_zones) {
+  outer();
+  outer();
+  auto root = Profiler::instance().merged();
+  auto outerStats = child(root, "outer");
+  ASSERT_NE(outerStats, nullptr);
+  ASSERT_EQ(outerStats->calls, 2);
+  ASSERT_EQ(outerStats->path, "outer");
+  auto leafStats = child(*outerStats, "leaf");
+  ASSERT_NE(leafStats, nullptr);
+  ASSERT_EQ(leafStats->calls, 6);
+  ASSERT_EQ(leafStats->path, "outer/leaf");
+  ASSERT_EQ(leafStats->inclusive, leafStats->exclusive);
+  ASSERT_GE(leafStats->min.getMilliseconds(), 2);
+  ASSERT_LE(leafStats->min, leafStats->max);
+  // outer's exclusive time excludes the leaf zones
+  ASSERT_EQ(outerStats->exclusive, outerStats->inclusive - leafStats->inclusive);
+  ASSERT_GE(outerStats->exclusive.getMilliseconds(), 4);
+  ASSERT_LT(outerStats->exclusive, leafStats->inclusive);
+}
+
+TEST(ProfilerTest, multithreaded_merge) {
+  auto work = []() {
+    TIMED_ZONE("worker");
+    leaf();
+  };
+  std::thread t1(work);
+  std::thread t2(work);
+  t1.join();
+  t2.join();
+  // trees of finished threads are still merged
+  auto root = Profiler::instance().merged();
+  auto workerStats = child(root, "worker");
+  ASSERT_NE(workerStats, nullptr);
+  ASSERT_EQ(workerStats->calls, 2);
+  auto leafStats = child(*workerStats, "leaf");
+  ASSERT_NE(leafStats, nullptr);
+  ASSERT_EQ(leafStats->calls, 2);
+  ASSERT_GE(Profiler::instance().threadCount(), 2);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,249 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "timed/Registry.h"
+
+namespace {
+
+int registeredCalls = 0;
+
+void registeredBenchmark() {
+  ++registeredCalls;
+}
+
+}  // namespace
+
+TIMED_BENCHMARK(registeredBenchmark).iterations(3);
+
+TEST(RegistryTest, macro) {
+  auto matching = timed::benchmark::Registry::instance().matching("^registeredBenchmark$");
+  ASSERT_EQ(1, matching.size());
+  ASSERT_EQ("registeredBenchmark", matching[0]->name());
+  ASSERT_EQ("registeredBenchmark", matching[0]->config().title);
+  ASSERT_EQ(3, matching[0]->config().iterations);
+  std::stringstream ss;
+  timed::benchmark::RunOptions options;
+  options.filter = "registered";
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, ss));
+  ASSERT_EQ(3, registeredCalls);
+}
+
+TEST(RegistryTest, registry) {
+  timed::benchmark::Registry registry;
+  int setups = 0;
+  registry.add("a/copy", []() {}).setup([&setups]() { ++setups; }).iterations(5);
+  registry.add("a/move", []() {}).bytesPerIteration(64).itemsPerIteration(8);
+  registry.add("b/copy", []() {}).configure([](timed::benchmark::Config &config) { config.histogram = true; });
+  ASSERT_EQ(3, registry.size());
+  ASSERT_THROW(registry.add("a/copy", []() {}), std::runtime_error);
+  ASSERT_EQ(3, registry.matching(".*").size());
+  ASSERT_EQ(2, registry.matching("copy").size());
+  ASSERT_EQ(1, registry.matching("^a/m").size());
+  ASSERT_EQ(0, registry.matching("c/").size());
+  auto move = registry.matching("move")[0];
+  ASSERT_EQ(64, move->config().bytesPerIteration);
+  ASSERT_EQ(8, move->config().itemsPerIteration);
+  ASSERT_TRUE(registry.matching("b/copy")[0]->config().histogram);
+  registry.matching("a/copy")[0]->instances()[0].precedentOp();
+  ASSERT_EQ(1, setups);
+  registry.clear();
+  ASSERT_EQ(0, registry.size());
+}
+
+TEST(RegistryTest, ranges) {
+  ASSERT_EQ((std::vector<int64_t>{1, 2, 3}), timed::benchmark::linearRange(1, 3));
+  ASSERT_EQ((std::vector<int64_t>{0, 4, 8}), timed::benchmark::linearRange(0, 10, 4));
+  ASSERT_EQ((std::vector<int64_t>{1, 8, 64, 100}), timed::benchmark::geometricRange(1, 100, 8));
+  ASSERT_EQ((std::vector<int64_t>{1 << 10, 1 << 20, 1 << 30}),
+            timed::benchmark::geometricRange(1 << 10, 1 << 30, 1024));
+  ASSERT_EQ((std::vector<int64_t>{5}), timed::benchmark::geometricRange(5, 5));
+  ASSERT_THROW(timed::benchmark::linearRange(0, 10, 0), std::runtime_error);
+  ASSERT_THROW(timed::benchmark::geometricRange(0, 10), std::runtime_error);
+  ASSERT_THROW(timed::benchmark::geometricRange(1, 10, 1), std::runtime_error);
+}
+
+TEST(RegistryTest, parameterized) {
+  timed::benchmark::Registry registry;
+  std::vector<timed::benchmark::Arguments> calls;
+  auto op = [&calls](const timed::benchmark::Arguments &args) { calls.push_back(args); };
+  auto &registration = registry.add("sort", op)
+    .arg(7)
+    .argsProduct({{1, 2}, {10, 20, 30}})
+    .iterations(2)
+    .configure([](timed::benchmark::Config &config, const timed::benchmark::Arguments &args) {
+      config.bytesPerIteration = static_cast<uint64_t>(args[0]);
+    });
+  ASSERT_TRUE(registration.parameterized());
+  auto instances = registration.instances();
+  ASSERT_EQ(7, instances.size());
+  ASSERT_EQ("sort/7", instances[0].name);
+  ASSERT_EQ("sort/1/10", instances[1].name);
+  ASSERT_EQ("sort/1/30", instances[3].name);
+  ASSERT_EQ("sort/2/10", instances[4].name);
+  ASSERT_EQ((timed::benchmark::Arguments{2, 30}), instances[6].arguments);
+  ASSERT_EQ("sort/2/30", instances[6].config.title);
+  ASSERT_EQ(2, instances[6].config.bytesPerIteration);
+  instances[4].op();
+  ASSERT_EQ((timed::benchmark::Arguments{2, 10}), calls.back());
+
+  // the filter applies to instance names
+  timed::benchmark::RunOptions options;
+  options.filter = "^sort/2/";
+  std::stringstream out;
+  calls.clear();
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, out, registry));
+  ASSERT_EQ(6, calls.size());
+  options.list = true;
+  options.filter = "/7$";
+  std::stringstream list;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, list, registry));
+  ASSERT_EQ("sort/7\n", list.str());
+
+  registry.add("empty", [](const timed::benchmark::Arguments &) {});
+  ASSERT_THROW(registry.matching("empty")[0]->instances(), std::runtime_error);
+}
+
+TEST(RegistryTest, complexity) {
+  timed::benchmark::Registry registry;
+  // linear in the first argument, the second argument selects the cost per element
+  registry.add("linear", [](const timed::benchmark::Arguments &args) {
+    timed::WallTimer timer;
+    timer.start();
+    while (timer.getTime().getMicroseconds() < static_cast<double>(args[0] * args[1])) {}
+  }).argsProduct({{100, 200, 400, 800}, {1, 2}}).iterations(3).complexity();
+  timed::benchmark::RunOptions options;
+  std::stringstream out;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, out, registry));
+  ASSERT_NE(std::string::npos, out.str().find("Complexity: 'linear/n/1'"));
+  ASSERT_NE(std::string::npos, out.str().find("Complexity: 'linear/n/2'"));
+  ASSERT_NE(std::string::npos, out.str().find("best fit:  O(n)\n"));
+}
+
+TEST(RegistryTest, parseArguments) {
+  const char *argv[] = {"bench", "--filter=^a/", "--repetitions=3", "--min-time=250ms", "--threads=1,2,4",
+                        "--format=console", "--list"};
+  auto options = timed::benchmark::parseArguments(7, argv);
+  ASSERT_EQ("^a/", options.filter);
+  ASSERT_EQ(3, options.repetitions);
+  ASSERT_EQ(250, options.minTime.getMilliseconds());
+  ASSERT_EQ((std::vector<unsigned>{1, 2, 4}), options.threadCounts);
+  ASSERT_EQ("console", options.format);
+  ASSERT_TRUE(options.list);
+  ASSERT_FALSE(options.help);
+
+  const char *seconds[] = {"bench", "--min-time=1.5"};
+  ASSERT_EQ(1500, timed::benchmark::parseArguments(2, seconds).minTime.getMilliseconds());
+
+  auto parse = [](const char *arg) {
+    const char *args[] = {"bench", arg};
+    return timed::benchmark::parseArguments(2, args);
+  };
+  ASSERT_TRUE(parse("--help").help);
+  ASSERT_THROW(parse("--unknown"), std::runtime_error);
+  ASSERT_THROW(parse("--repetitions=0"), std::runtime_error);
+  ASSERT_THROW(parse("--repetitions=x"), std::runtime_error);
+  ASSERT_THROW(parse("--min-time=5h"), std::runtime_error);
+  ASSERT_THROW(parse("--threads=1,,2"), std::runtime_error);
+  ASSERT_THROW(parse("--filter=("), std::runtime_error);
+  ASSERT_THROW(parse("--list=yes"), std::runtime_error);
+  // no wrap around or narrowing
+  ASSERT_THROW(parse("--repetitions=4294967297"), std::runtime_error);
+  ASSERT_THROW(parse("--pin-cpu=2147483648"), std::runtime_error);
+  ASSERT_EQ(2147483647, parse("--pin-cpu=2147483647").pinCpu);
+  ASSERT_THROW(parse("--min-time=inf"), std::runtime_error);
+  ASSERT_THROW(parse("--min-time=nan"), std::runtime_error);
+  ASSERT_THROW(parse("--min-time=1e300"), std::runtime_error);
+  ASSERT_THROW(parse("--threshold=nan"), std::runtime_error);
+
+  const char *baselineThreads[] = {"bench", "--baseline=base.bin", "--threads=1,2"};
+  ASSERT_THROW(timed::benchmark::parseArguments(3, baselineThreads), std::runtime_error);
+}
+
+TEST(RegistryTest, run) {
+  timed::benchmark::Registry registry;
+  int copies = 0;
+  int moves = 0;
+  registry.add("copy", [&copies]() { ++copies; }).iterations(10);
+  registry.add("move", [&moves]() { ++moves; }).iterations(10);
+  timed::benchmark::RunOptions options;
+
+  // list does not run anything
+  options.list = true;
+  std::stringstream list;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, list, registry));
+  ASSERT_EQ("copy\nmove\n", list.str());
+  ASSERT_EQ(0, copies);
+
+  options.list = false;
+  options.filter = "copy";
+  options.repetitions = 2;
+  std::stringstream out;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, out, registry));
+  ASSERT_EQ(20, copies);
+  ASSERT_EQ(0, moves);
+  ASSERT_NE(std::string::npos, out.str().find("'copy [2/2]'"));
+
+  // scaling mode
+  options.filter = "move";
+  options.repetitions = 1;
+  options.threadCounts = {1, 2};
+  std::stringstream scaling;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, scaling, registry));
+  ASSERT_EQ(30, moves);
+  ASSERT_NE(std::string::npos, scaling.str().find("(scaling)"));
+
+  options.filter = "nothing";
+  ASSERT_EQ(1, timed::benchmark::runRegistered(options, scaling, registry));
+  options.filter = "copy";
+  options.format = "unknown";
+  ASSERT_THROW(timed::benchmark::runRegistered(options, scaling, registry), std::runtime_error);
+}
+
+TEST(RegistryTest, uncheckedAllocationLimit) {
+  // the AllocationTracker library is not linked, a limit cannot be checked and fails the run
+  timed::benchmark::Registry registry;
+  registry.add("limited", []() {}).iterations(3).maxAllocationsPerOp(0);
+  timed::benchmark::RunOptions options;
+  std::stringstream out;
+  ASSERT_EQ(3, timed::benchmark::runRegistered(options, out, registry));
+}
+
+TEST(RegistryTest, repetitionsAreReportedWhenFinished) {
+  timed::benchmark::Registry registry;
+  std::stringstream out;
+  bool firstReported = false;
+  registry.add("rep", [&out, &firstReported]() {
+    if (out.str().find("'rep [1/2]'") != std::string::npos) { firstReported = true; }
+  }).iterations(3);
+  timed::benchmark::RunOptions options;
+  options.repetitions = 2;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, out, registry));
+  ASSERT_TRUE(firstReported);
+}
+
+TEST(RegistryTest, minTime) {
+  timed::benchmark::Registry registry;
+  registry.add("fast", []() {});
+  timed::benchmark::RunOptions options;
+  options.minTime = timed::Time::fromNanoseconds(100 * timed::Time::NS_PER_MS);
+  timed::WallTimer timer;
+  timer.start();
+  std::stringstream out;
+  ASSERT_EQ(0, timed::benchmark::runRegistered(options, out, registry));
+  timer.stop();
+  // an empty op converges long before, min time keeps it sampling
+  ASSERT_GE(timer.getTime().getMilliseconds(), 100);
+  ASSERT_NE(std::string::npos, out.str().find("Batch size"));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
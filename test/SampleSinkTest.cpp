@@ -0,0 +1,178 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "timed/Benchmark.h"
+#include "timed/SampleSink.h"
+
+using timed::benchmark::SampleSink;
+
+TEST(SampleSinkTest, writeAndRead) {
+  std::string path = testing::TempDir() + "timed_sample_sink.bin";
+  {
+    // one page per region: 1000 rows of 3 values span several regions
+    timed::benchmark::MmapSampleSink sink(path, 1);
+    sink.begin(3);
+    ASSERT_THROW(sink.begin(3), std::runtime_error);
+    for (int i = 0; i < 1000; ++i) {
+      sink.add(SampleSink::WALL, timed::Time::fromNanoseconds(100 + i));
+      sink.add(SampleSink::CPU, timed::Time::fromNanoseconds(2 * i));
+      sink.add(SampleSink::THREAD_CPU, timed::Time::fromNanoseconds(-i));
+    }
+    ASSERT_EQ(1000, sink.size(SampleSink::WALL));
+
+    // readable while the sink is still open
+    timed::benchmark::MappedSampleFile file(path);
+    ASSERT_EQ(1000, file.size(SampleSink::CPU));
+    sink.flush();
+#ifdef __linux__
+    // only the header region and the two newest regions stay mapped (the reader maps the file once)
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    int mappings = 0;
+    while (std::getline(maps, line)) {
+      if (line.find("timed_sample_sink.bin") != std::string::npos) { ++mappings; }
+    }
+    ASSERT_LE(mappings, 4);
+#endif
+  }
+  timed::benchmark::MappedSampleFile file(path);
+  ASSERT_EQ(3, file.columns());
+  ASSERT_EQ(1000, file.size(SampleSink::WALL));
+  ASSERT_EQ(1000, file.size(SampleSink::THREAD_CPU));
+  ASSERT_EQ(100, file.at(SampleSink::WALL, 0).count());
+  ASSERT_EQ(1099, file.at(SampleSink::WALL, 999).count());
+  ASSERT_EQ(1998, file.at(SampleSink::CPU, 999).count());
+  ASSERT_EQ(-5, file.at(SampleSink::THREAD_CPU, 5).count());
+  ASSERT_THROW((void) file.at(SampleSink::WALL, 1000), std::out_of_range);
+
+  auto histogram = file.histogram(SampleSink::WALL, timed::Time::fromNanoseconds(100));
+  ASSERT_EQ(1000, histogram.count());
+  ASSERT_EQ(0, histogram.min().count());
+  ASSERT_NEAR(999, histogram.max().count(), 1);
+
+  // the destructor truncated the file to header and rows
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  ASSERT_EQ(timed::benchmark::MmapSampleSink::HEADER_BYTES + 1000 * 3 * 8, static_cast<size_t>(in.tellg()));
+  std::remove(path.c_str());
+}
+
+TEST(SampleSinkTest, invalidFiles) {
+  ASSERT_THROW(timed::benchmark::MappedSampleFile(testing::TempDir() + "timed_missing.bin"), std::runtime_error);
+  std::string path = testing::TempDir() + "timed_no_samples.bin";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << std::string(100, 'x');
+  }
+  ASSERT_THROW(timed::benchmark::MappedSampleFile{path}, std::runtime_error);
+  std::remove(path.c_str());
+
+  // one row of two columns announced, but the file ends in the middle of its second value
+  {
+    std::string header(timed::benchmark::MmapSampleSink::HEADER_BYTES, '\0');
+    uint32_t version = 1;
+    uint32_t columns = 2;
+    uint64_t counts[3] = {1, 1, 0};
+    header.replace(0, 8, "TIMEDMAP");
+    header.replace(8, 4, reinterpret_cast<const char *>(&version), 4);
+    header.replace(12, 4, reinterpret_cast<const char *>(&columns), 4);
+    header.replace(16, 24, reinterpret_cast<const char *>(counts), 24);
+    std::ofstream out(path, std::ios::binary);
+    out << header << std::string(12, '\0');
+  }
+  ASSERT_THROW(timed::benchmark::MappedSampleFile{path}, std::runtime_error);
+  std::remove(path.c_str());
+
+  timed::benchmark::MmapSampleSink sink(testing::TempDir() + "timed_unused.bin");
+  ASSERT_THROW(sink.add(SampleSink::WALL, timed::Time()), std::runtime_error);
+  ASSERT_THROW(sink.begin(4), std::runtime_error);
+}
+
+TEST(SampleSinkTest, benchmark) {
+  std::string path = testing::TempDir() + "timed_benchmark_samples.bin";
+  timed::benchmark::Config config;
+  config.iterations = 500;
+  config.sink = std::make_shared<timed::benchmark::MmapSampleSink>(path);
+  timed::benchmark::Benchmark benchmark(config, []() {
+    int x = 0;
+    for (int i = 0; i < 100; ++i) { timed::benchmark::doNotOptimize(x += i); }
+  });
+  const auto &result = benchmark.run();
+  ASSERT_TRUE(result.histogramOnly);
+  ASSERT_TRUE(result.wallTimes.empty());
+  ASSERT_EQ(500, result.size());
+
+  timed::benchmark::MappedSampleFile file(path);
+  ASSERT_EQ(2, file.columns());
+  ASSERT_EQ(500, file.size(SampleSink::WALL));
+  ASSERT_EQ(500, file.size(SampleSink::CPU));
+  ASSERT_EQ(0, file.size(SampleSink::THREAD_CPU));
+  auto histogram = file.histogram(SampleSink::WALL, result.wallTimeBaseline);
+  ASSERT_EQ(result.wallHistogram.count(), histogram.count());
+  ASSERT_EQ(result.wallHistogram.max(), histogram.max());
+  ASSERT_EQ(result.wallHistogram.median(), histogram.median());
+  std::remove(path.c_str());
+}
+
+TEST(SampleSinkTest, runTwice) {
+  std::string path = testing::TempDir() + "timed_benchmark_samples_twice.bin";
+  timed::benchmark::Config config;
+  config.iterations = 200;
+  config.sink = std::make_shared<timed::benchmark::MmapSampleSink>(path);
+  // every run begins and ends the sink, the file collects the samples of all runs
+  timed::benchmark::Benchmark benchmark(config, []() {});
+  benchmark.run();
+  ASSERT_EQ(200, timed::benchmark::MappedSampleFile(path).size(SampleSink::WALL));
+  benchmark.run();
+  ASSERT_EQ(400, timed::benchmark::MappedSampleFile(path).size(SampleSink::WALL));
+  // a second benchmark sharing the config (e.g. a repetition of runRegistered())
+  config.iterations = 100;
+  timed::benchmark::Benchmark repetition(config, []() {});
+  repetition.run();
+  timed::benchmark::MappedSampleFile file(path);
+  ASSERT_EQ(500, file.size(SampleSink::WALL));
+  ASSERT_EQ(500, file.size(SampleSink::CPU));
+  // another column count cannot be appended
+  ASSERT_THROW(config.sink->begin(3), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(SampleSinkTest, appendAcrossRegions) {
+  std::string path = testing::TempDir() + "timed_sample_sink_append.bin";
+  {
+    // one page per region, every run spans several regions
+    timed::benchmark::MmapSampleSink sink(path, 1);
+    for (int run = 0; run < 3; ++run) {
+      sink.begin(2);
+      for (int i = 0; i < 1000; ++i) {
+        sink.add(SampleSink::WALL, timed::Time::fromNanoseconds(run * 1000 + i));
+        sink.add(SampleSink::CPU, timed::Time::fromNanoseconds(-(run * 1000 + i)));
+      }
+      sink.end();
+    }
+  }
+  timed::benchmark::MappedSampleFile file(path);
+  ASSERT_EQ(3000, file.size(SampleSink::WALL));
+  for (size_t i = 0; i < 3000; ++i) {
+    ASSERT_EQ(static_cast<int64_t>(i), file.at(SampleSink::WALL, i).count());
+    ASSERT_EQ(-static_cast<int64_t>(i), file.at(SampleSink::CPU, i).count());
+  }
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  ASSERT_EQ(timed::benchmark::MmapSampleSink::HEADER_BYTES + 3000 * 2 * 8, static_cast<size_t>(in.tellg()));
+  std::remove(path.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -69,6 +69,18 @@ TEST(TimeTest, format) {
   ASSERT_EQ(time.format("%ns"), "24000000");
 }
 
+TEST(TimeTest, formatAuto) {
+  ASSERT_EQ("740ns", Time::fromNanoseconds(740).format("auto"));
+  ASSERT_EQ("1us210ns", Time::fromNanoseconds(1210).format("auto"));
+  ASSERT_EQ("11us195ns", Time::fromNanoseconds(11195).format("auto"));
+  ASSERT_EQ("0m0s1ms500us", Time::fromNanoseconds(1500000).format("auto"));
+}
+
+TEST(TimeTest, representation) {
+  static_assert(sizeof(Time) == sizeof(int64_t), "Time must be a single tick count");
+  static_assert(std::is_trivially_copyable<Time>::value, "Time must be trivially copyable");
+}
+
 // TODO: implement missing tests:
 TEST(TimeTest, timeInUnit) {}
 TEST(TimeTest, getTime) {}
@@ -78,13 +90,33 @@ TEST(TimeTest, getMinutes) {}
 TEST(TimeTest, getSeconds) {}
 TEST(TimeTest, getMilliseconds) {}
 TEST(TimeTest, getMicroseconds) {}
-TEST(TimeTest, getNanoseconds) {}
+TEST(TimeTest, getNanoseconds) {
+  Time time(0, 0, 0, 1, 2, 3, 4);
+  ASSERT_EQ(time.getNanoseconds(), 1002003004);
+  ASSERT_EQ(Time::fromNanoseconds(1002003004), time);
+}
 
-TEST(TimeTest, plus_operator) {}
-TEST(TimeTest, minus_operator) {}
+TEST(TimeTest, plus_operator) {
+  constexpr Time t = Time(0, 0, 0, 0, 999) + Time(0, 0, 0, 0, 1);
+  static_assert(t.count() == Time::NS_PER_S, "constexpr addition");
+  ASSERT_EQ(t.getSeconds(), 1);
+}
+TEST(TimeTest, minus_operator) {
+  ASSERT_EQ((Time(0, 0, 0, 2) - Time(0, 0, 0, 1)).getNanoseconds(), 1000000000);
+  // clamped at zero
+  ASSERT_EQ((Time(0, 0, 0, 1) - Time(0, 0, 0, 2)).getNanoseconds(), 0);
+}
 TEST(TimeTest, asterix_operator) {}
-TEST(TimeTest, divide_operator) {}
-TEST(TimeTest, plus_eq_operator) {}
+TEST(TimeTest, divide_operator) {
+  ASSERT_EQ((Time::fromNanoseconds(10) / 4).count(), 3);
+  ASSERT_EQ((Time::fromNanoseconds(10) / 2.5).count(), 4);
+}
+TEST(TimeTest, plus_eq_operator) {
+  Time time;
+  for (int i = 0; i < 1000; ++i) { time += 1000000u; }
+  ASSERT_EQ(time.getSeconds(), 1);
+  ASSERT_EQ(time.format("%s:%ms"), "1:0");
+}
 TEST(TimeTest, minus_eq_operator) {}
 TEST(TimeTest, asterix_eq_operator) {}
 TEST(TimeTest, divide_eq_operator) {}
@@ -93,7 +125,10 @@ TEST(TimeTest, eq_operator) {}
 TEST(TimeTest, neq_operator) {}
 TEST(TimeTest, gt_operator) {}
 TEST(TimeTest, ge_operator) {}
-TEST(TimeTest, lt_operator) {}
+TEST(TimeTest, lt_operator) {
+  ASSERT_TRUE(Time::fromNanoseconds(1) < Time::fromNanoseconds(2));
+  ASSERT_FALSE(Time::fromNanoseconds(2) < Time::fromNanoseconds(2));
+}
 TEST(TimeTest, le_operator) {}
 
 TEST(TimeTest, uint64_t_operator) {}
@@ -102,6 +102,54 @@ TEST(WallTimerTest, multithreaded_task) {
   }
 }
 
+TEST(TscTimerTest, start_stop) {
+  {
+    TscTimer tscTimer;
+    tscTimer.start();
+    SLEEP_MS(100);
+    tscTimer.stop();
+    ASSERT_NEAR(tscTimer.getTime().getMilliseconds(), 100, 1);
+  }
+  {
+    TscTimer tscTimer;
+    tscTimer.start();
+    SLEEP_MS(100);
+    tscTimer.stop();
+    tscTimer.start();
+    SLEEP_MS(100);
+    auto time = tscTimer.stop();
+    ASSERT_NEAR(time.getMilliseconds(), 100, 1);
+  }
+  {
+    TscTimer tscTimer;
+    auto time = tscTimer.stop();
+    ASSERT_EQ(time.getNanoseconds(), 0);
+  }
+}
+
+TEST(TscTimerTest, start_pause) {
+  {
+    TscTimer tscTimer;
+    tscTimer.start();
+    SLEEP_MS(100);
+    auto time = tscTimer.pause();
+    ASSERT_NEAR(time.getMilliseconds(), 100, 1);
+    SLEEP_MS(100);
+    tscTimer.start();
+    SLEEP_MS(100);
+    ASSERT_NEAR(tscTimer.getTime().getMilliseconds(), 200, 1);
+    time = tscTimer.stop();
+    ASSERT_NEAR(time.getMilliseconds(), 200, 1);
+  }
+}
+
+TEST(TscTimerTest, calibration) {
+  ASSERT_GT(TscTimer::nanosecondsPerTick(), 0);
+  if (!TscTimer::usesTsc()) {
+    ASSERT_EQ(TscTimer::nanosecondsPerTick(), 1.0);
+  }
+}
+
 #ifdef _WIN32
 #else
 TEST(CPUTimerTest, start_stop) {
@@ -215,10 +263,71 @@ TEST(CPUTimerTest, multithreaded_task) {
     auto time = cpuTimer.stop();
     ASSERT_NEAR(time.getMilliseconds(), 200, 1);
   }
+  {
+    auto threadedBusyWait = []() -> void {
+      std::thread t1 = std::thread(BUSY_WAIT_MS, 100);
+      std::thread t2 = std::thread(BUSY_WAIT_MS, 100);
+      t1.join();
+      t2.join();
+    };
+    CPUTimer cpuTimer(CPUClock::THREAD);
+    cpuTimer.start();
+    threadedBusyWait();
+    auto time = cpuTimer.stop();
+    ASSERT_NEAR(time.getMilliseconds(), 0, 1);
+  }
+}
+
+TEST(CPUTimerTest, sub_millisecond_resolution) {
+  {
+    CPUTimer cpuTimer(CPUClock::THREAD);
+    cpuTimer.start();
+    BUSY_WAIT_US(300);
+    auto time = cpuTimer.stop();
+    ASSERT_NEAR(time.getMicroseconds(), 300, 100);
+  }
+  {
+    CPUTimer cpuTimer;
+    cpuTimer.start();
+    BUSY_WAIT_US(300);
+    auto time = cpuTimer.pause();
+    ASSERT_NEAR(time.getMicroseconds(), 300, 100);
+  }
 }
 
 #endif  // _WIN32
 
+TEST(TimerOverheadTest, calibrate) {
+  for (auto source: {ClockSource::STEADY, ClockSource::TSC, ClockSource::CPU_PROCESS, ClockSource::CPU_THREAD}) {
+    Time overhead = timerOverhead(source);
+    // cached for the process
+    ASSERT_EQ(overhead, timerOverhead(source));
+    ASSERT_LT(overhead.getMicroseconds(), 100);
+  }
+  WallTimer wallTimer;
+  ASSERT_EQ(Time(), wallTimer.getBaseline());
+  wallTimer.calibrate();
+  ASSERT_EQ(timerOverhead(ClockSource::STEADY), wallTimer.getBaseline());
+  CPUTimer cpuTimer(CPUClock::THREAD);
+  cpuTimer.calibrate();
+  ASSERT_EQ(timerOverhead(ClockSource::CPU_THREAD), cpuTimer.getBaseline());
+  // the baseline is subtracted once per interval and never makes a measurement negative
+  wallTimer.start();
+  Time empty = wallTimer.pause();
+  ASSERT_GE(empty.count(), 0);
+  wallTimer.start();
+  SLEEP_MS(2);
+  wallTimer.stop();
+  auto intervals = wallTimer.getIntervals();
+  ASSERT_EQ(2, intervals.size());
+  int64_t raw = 0;
+  for (const auto &interval: intervals) {
+    raw += std::chrono::duration_cast<std::chrono::nanoseconds>(interval.second - interval.first).count();
+  }
+  Time expected = Time::fromNanoseconds(raw) - wallTimer.getBaseline() * 2;
+  ASSERT_EQ(expected, wallTimer.getTime());
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
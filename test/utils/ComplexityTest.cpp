@@ -0,0 +1,65 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "timed/utils/Complexity.h"
+
+using timed::utils::Complexity;
+
+namespace {
+
+std::vector<double> sizes() {
+  return {1 << 10, 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20};
+}
+
+std::vector<double> timesOf(Complexity complexity, double coefficient, double noise) {
+  std::vector<double> ret;
+  int sign = 1;
+  for (double n: sizes()) {
+    ret.push_back(coefficient * timed::utils::complexityFunction(complexity, n) * (1 + sign * noise));
+    sign = -sign;
+  }
+  return ret;
+}
+
+}  // namespace
+
+TEST(ComplexityTest, exact) {
+  auto fit = timed::utils::fitComplexity(sizes(), timesOf(Complexity::O_N, 2.5, 0), Complexity::O_N);
+  ASSERT_EQ(Complexity::O_N, fit.complexity);
+  ASSERT_DOUBLE_EQ(2.5, fit.coefficient);
+  ASSERT_NEAR(0, fit.rms, 1e-6);
+  ASSERT_NEAR(0, fit.relativeRms, 1e-12);
+}
+
+TEST(ComplexityTest, bestFit) {
+  const Complexity models[] = {Complexity::O_1, Complexity::O_LOG_N, Complexity::O_N, Complexity::O_N_LOG_N,
+                               Complexity::O_N_SQUARED};
+  for (auto model: models) {
+    SCOPED_TRACE(timed::utils::toString(model));
+    auto fit = timed::utils::fitComplexity(sizes(), timesOf(model, 3, 0.02));
+    ASSERT_EQ(model, fit.complexity);
+    ASSERT_NEAR(3, fit.coefficient, 0.1);
+    ASSERT_LT(fit.relativeRms, 0.05);
+  }
+}
+
+TEST(ComplexityTest, errors) {
+  ASSERT_THROW(timed::utils::fitComplexity({}, {}), std::runtime_error);
+  ASSERT_THROW(timed::utils::fitComplexity({1, 2}, {1}), std::runtime_error);
+  ASSERT_STREQ("O(n log n)", timed::utils::toString(Complexity::O_N_LOG_N));
+  ASSERT_EQ(0, timed::utils::complexityFunction(Complexity::O_LOG_N, 1));
+  ASSERT_DOUBLE_EQ(10, timed::utils::complexityFunction(Complexity::O_LOG_N, 1024));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
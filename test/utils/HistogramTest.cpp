@@ -0,0 +1,100 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "timed/utils/Histogram.h"
+#include "timed/utils/Statistics.h"
+
+using namespace timed;
+using timed::utils::Histogram;
+
+TEST(HistogramTest, empty) {
+  Histogram histogram;
+  ASSERT_TRUE(histogram.empty());
+  ASSERT_EQ(histogram.count(), 0);
+  ASSERT_EQ(histogram.min().count(), 0);
+  ASSERT_EQ(histogram.percentile(50).count(), 0);
+}
+
+TEST(HistogramTest, exact_small_values) {
+  Histogram histogram(3);
+  for (int i = 1; i <= 100; ++i) {
+    histogram.record(Time::fromNanoseconds(i));
+  }
+  ASSERT_EQ(histogram.count(), 100);
+  ASSERT_EQ(histogram.min().count(), 1);
+  ASSERT_EQ(histogram.max().count(), 100);
+  ASSERT_EQ(histogram.median().count(), 50);
+  ASSERT_EQ(histogram.percentile(99).count(), 99);
+  ASSERT_EQ(histogram.percentile(100).count(), 100);
+  ASSERT_EQ(histogram.mean().count(), 51);
+}
+
+TEST(HistogramTest, relative_precision) {
+  std::mt19937_64 rng(42);
+  std::lognormal_distribution<double> dist(10, 2);
+  for (unsigned digits = 1; digits <= 4; ++digits) {
+    Histogram histogram(digits);
+    std::vector<uint64_t> values;
+    for (int i = 0; i < 20000; ++i) {
+      auto v = static_cast<uint64_t>(dist(rng)) + 1;
+      values.push_back(v);
+      histogram.record(Time::fromNanoseconds(static_cast<int64_t>(v)));
+    }
+    std::sort(values.begin(), values.end());
+    double tolerance = std::pow(10.0, -static_cast<double>(digits));
+    for (double p: {50.0, 90.0, 99.0, 99.9}) {
+      auto exact = static_cast<double>(values[static_cast<size_t>(std::ceil(p / 100 * values.size())) - 1]);
+      auto approx = static_cast<double>(histogram.percentile(p).count());
+      ASSERT_NEAR(approx, exact, exact * tolerance) << "digits: " << digits << ", p" << p;
+    }
+    double exactMean = timed::utils::mean(values);
+    ASSERT_NEAR(static_cast<double>(histogram.mean().count()), exactMean, exactMean * tolerance);
+    double exactSD = timed::utils::stddev(values);
+    ASSERT_NEAR(static_cast<double>(histogram.stddev().count()), exactSD, exactSD * tolerance);
+  }
+}
+
+TEST(HistogramTest, range) {
+  Histogram histogram(3, Time(0, 2));
+  histogram.record(Time(0, 1));
+  histogram.record(Time(0, 5));
+  histogram.record(Time::fromNanoseconds(-1));
+  ASSERT_EQ(histogram.min().count(), 0);
+  // clamped to the highest trackable value
+  ASSERT_EQ(histogram.max(), Time(0, 2));
+  ASSERT_NEAR(histogram.median().getHours(), 1, 0.001);
+  ASSERT_THROW(Histogram(0), std::runtime_error);
+  ASSERT_THROW(Histogram(6), std::runtime_error);
+}
+
+TEST(HistogramTest, merge) {
+  Histogram a;
+  Histogram b;
+  Histogram all;
+  for (int i = 1; i <= 1000; ++i) {
+    (i % 2 ? a : b).record(Time::fromNanoseconds(i * 1000));
+    all.record(Time::fromNanoseconds(i * 1000));
+  }
+  a.merge(b);
+  ASSERT_EQ(a.count(), all.count());
+  ASSERT_EQ(a.min(), all.min());
+  ASSERT_EQ(a.max(), all.max());
+  ASSERT_EQ(a.median(), all.median());
+  ASSERT_EQ(a.percentile(99.9), all.percentile(99.9));
+  ASSERT_THROW(a.merge(Histogram(2)), std::runtime_error);
+  a.reset();
+  ASSERT_TRUE(a.empty());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,112 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "timed/utils/Reduce.h"
+
+namespace simd = timed::utils::simd;
+
+namespace {
+
+const simd::InstructionSet VECTOR_SETS[] = {simd::InstructionSet::AVX2, simd::InstructionSet::AVX512};
+
+// sizes around the vector widths and unroll factors, so every tail length is covered
+std::vector<size_t> sizes() {
+  std::vector<size_t> ret;
+  for (size_t i = 0; i <= 40; ++i) { ret.push_back(i); }
+  ret.push_back(100003);
+  return ret;
+}
+
+template<typename T>
+std::vector<T> randomData(size_t size, T low, T high) {
+  std::mt19937_64 gen(size);
+  std::vector<T> ret(size);
+  if constexpr (std::is_floating_point<T>::value) {
+    std::uniform_real_distribution<T> dist(low, high);
+    for (auto &x: ret) { x = dist(gen); }
+  } else {
+    std::uniform_int_distribution<T> dist(low, high);
+    for (auto &x: ret) { x = dist(gen); }
+  }
+  return ret;
+}
+
+template<typename T>
+void compareWithScalar(T low, T high) {
+  for (auto isa: VECTOR_SETS) {
+    if (!simd::isSupported(isa)) { continue; }
+    SCOPED_TRACE(simd::toString(isa));
+    for (size_t size: sizes()) {
+      SCOPED_TRACE(size);
+      auto data = randomData<T>(size, low, high);
+      double scalarSum = simd::sum(data.data(), size, simd::InstructionSet::SCALAR);
+      if constexpr (std::is_floating_point<T>::value) {
+        ASSERT_NEAR(scalarSum, simd::sum(data.data(), size, isa), 1e-9 * std::abs(scalarSum) + 1e-9);
+      } else {
+        // integers are summed exactly
+        ASSERT_EQ(scalarSum, simd::sum(data.data(), size, isa));
+      }
+      double center = size == 0 ? 0 : scalarSum / static_cast<double>(size);
+      double scalarSq = simd::sumOfSquaredDeviations(data.data(), size, center, simd::InstructionSet::SCALAR);
+      ASSERT_NEAR(scalarSq, simd::sumOfSquaredDeviations(data.data(), size, center, isa), 1e-9 * scalarSq + 1e-9);
+      double scalarAbs = simd::sumOfAbsoluteDeviations(data.data(), size, center, simd::InstructionSet::SCALAR);
+      ASSERT_NEAR(scalarAbs, simd::sumOfAbsoluteDeviations(data.data(), size, center, isa), 1e-9 * scalarAbs + 1e-9);
+      auto scalarMinMax = simd::minMax(data.data(), size, simd::InstructionSet::SCALAR);
+      auto minMax = simd::minMax(data.data(), size, isa);
+      ASSERT_EQ(scalarMinMax.min, minMax.min);
+      ASSERT_EQ(scalarMinMax.max, minMax.max);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ReduceTest, scalar) {
+  std::vector<int64_t> v {3, -1, 4, 1, -5};
+  ASSERT_EQ(2, simd::sum(v.data(), v.size(), simd::InstructionSet::SCALAR));
+  ASSERT_EQ(-5, simd::minMax(v.data(), v.size(), simd::InstructionSet::SCALAR).min);
+  ASSERT_EQ(4, simd::minMax(v.data(), v.size(), simd::InstructionSet::SCALAR).max);
+  ASSERT_DOUBLE_EQ(14, simd::sumOfAbsoluteDeviations(v.data(), v.size(), 0, simd::InstructionSet::SCALAR));
+  ASSERT_DOUBLE_EQ(52, simd::sumOfSquaredDeviations(v.data(), v.size(), 0, simd::InstructionSet::SCALAR));
+  auto empty = simd::minMax(v.data(), 0);
+  ASSERT_EQ(0, empty.min);
+  ASSERT_EQ(0, empty.max);
+}
+
+TEST(ReduceTest, double) {
+  compareWithScalar<double>(-1e6, 1e6);
+  compareWithScalar<double>(0, 1);
+}
+
+TEST(ReduceTest, int64) {
+  compareWithScalar<int64_t>(-1000000000000, 1000000000000);
+  // beyond 2^53 the conversion to double rounds, it must round like the scalar conversion
+  compareWithScalar<int64_t>(INT64_MIN / 4, INT64_MAX / 4);
+}
+
+TEST(ReduceTest, uint64) {
+  compareWithScalar<uint64_t>(0, 1000000000000);
+  // values with the highest bit set must not be compared as negative
+  compareWithScalar<uint64_t>(0, UINT64_MAX);
+}
+
+TEST(ReduceTest, unsupportedFallsBack) {
+  std::vector<double> v {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  // requesting any instruction set is safe, unsupported ones fall back to the best supported one
+  ASSERT_DOUBLE_EQ(45, simd::sum(v.data(), v.size(), simd::InstructionSet::AVX512));
+  ASSERT_TRUE(simd::isSupported(simd::InstructionSet::SCALAR));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
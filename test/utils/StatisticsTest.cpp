@@ -3,6 +3,7 @@
 //
 // This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
 
+#include <cstdint>
 #include <vector>
 #include <cmath>
 
@@ -67,6 +68,14 @@ TEST(StatisticsTest, mean) {
     std::vector<int> v {2, 2, 2, 4};
     ASSERT_FLOAT_EQ(2.5, stats::mean(v));
   }
+  {
+    // the sum exceeds 2^64
+    std::vector<uint64_t> v {UINT64_MAX, UINT64_MAX, UINT64_MAX};
+    ASSERT_DOUBLE_EQ(static_cast<double>(UINT64_MAX), stats::mean(v));
+    std::vector<int64_t> w {INT64_MAX, INT64_MAX};
+    ASSERT_DOUBLE_EQ(static_cast<double>(INT64_MAX), stats::mean(w));
+    ASSERT_DOUBLE_EQ(0, stats::stddev(w));
+  }
   // TODO: add more
 }
 
@@ -90,6 +99,144 @@ TEST(StatisticsTest, median) {
 // TODO: add missing tests:
 TEST(StatisticsTest, MAPE) {}
 
+TEST(StatisticsTest, timeReductions) {
+  std::vector<timed::Time> v;
+  std::vector<int64_t> ns;
+  for (int64_t i = 0; i < 1001; ++i) {
+    v.push_back(timed::Time::fromNanoseconds((i * 7919) % 1001 + 10));
+    ns.push_back(v.back().count());
+  }
+  ASSERT_EQ(timed::Time::fromNanoseconds(10), stats::min(v));
+  ASSERT_EQ(timed::Time::fromNanoseconds(1010), stats::max(v));
+  ASSERT_EQ(timed::Time::fromNanoseconds(510), stats::mean(v));
+  ASSERT_EQ(timed::Time::fromNanoseconds(std::llround(stats::stddev(ns))), stats::stddev(v));
+  ASSERT_EQ(timed::Time::fromNanoseconds(std::llround(stats::meanAbsoluteDeviation(ns))),
+            stats::meanAbsoluteDeviation(v));
+  ASSERT_EQ(timed::Time(), stats::mean(std::vector<timed::Time>()));
+}
+
+TEST(StatisticsTest, summary) {
+  stats::Summarizer summarizer;
+  {
+    std::vector<int> v {4, 2, 2, 2};
+    auto summary = summarizer.summarize(v);
+    ASSERT_EQ(4U, summary.count);
+    ASSERT_FLOAT_EQ(2, summary.min);
+    ASSERT_FLOAT_EQ(4, summary.max);
+    ASSERT_FLOAT_EQ(stats::mean(v), summary.mean);
+    ASSERT_FLOAT_EQ(stats::stddev(v), summary.stddev());
+    ASSERT_FLOAT_EQ(2, summary.median);
+    ASSERT_FLOAT_EQ(2, summary.p50);
+    ASSERT_FLOAT_EQ(4, summary.p99);
+    ASSERT_FLOAT_EQ(0, summary.medianAbsolutePercentError);
+  }
+  {
+    std::vector<double> v(1000);
+    for (size_t i = 0; i < v.size(); ++i) { v[i] = static_cast<double>((i * 7919) % 1000 + 1); }
+    auto summary = summarizer.summarize(v);
+    ASSERT_EQ(1000U, summary.count);
+    ASSERT_FLOAT_EQ(1, summary.min);
+    ASSERT_FLOAT_EQ(1000, summary.max);
+    ASSERT_FLOAT_EQ(500.5, summary.mean);
+    ASSERT_FLOAT_EQ(stats::stddev(v), summary.stddev());
+    ASSERT_FLOAT_EQ(500.5, summary.median);
+    ASSERT_FLOAT_EQ(500, summary.p50);
+    ASSERT_FLOAT_EQ(900, summary.p90);
+    ASSERT_FLOAT_EQ(990, summary.p99);
+    ASSERT_FLOAT_EQ(999, summary.p999);
+    ASSERT_FLOAT_EQ(stats::medianAbsolutePercentError(v), summary.medianAbsolutePercentError);
+    // the input is not touched
+    ASSERT_FLOAT_EQ(1, v[0]);
+  }
+  {
+    auto summary = summarizer.summarize(std::vector<int>());
+    ASSERT_EQ(0U, summary.count);
+    ASSERT_FLOAT_EQ(0, summary.median);
+  }
+  {
+    std::vector<timed::Time> v {timed::Time::fromNanoseconds(10), timed::Time::fromNanoseconds(30),
+                                timed::Time::fromNanoseconds(5)};
+    auto summary = summarizer.summarize(v, timed::Time::fromNanoseconds(8));
+    ASSERT_FLOAT_EQ(0, summary.min);
+    ASSERT_FLOAT_EQ(22, summary.max);
+    ASSERT_FLOAT_EQ(2, summary.median);
+  }
+}
+
+TEST(StatisticsTest, percentiles) {
+  stats::Summarizer summarizer;
+  std::vector<int> v;
+  for (int i = 100; i > 0; --i) { v.push_back(i); }
+  auto p = summarizer.percentiles(v, {99, 0, 50, 100, 25});
+  ASSERT_EQ(5U, p.size());
+  ASSERT_FLOAT_EQ(99, p[0]);
+  ASSERT_FLOAT_EQ(1, p[1]);
+  ASSERT_FLOAT_EQ(50, p[2]);
+  ASSERT_FLOAT_EQ(100, p[3]);
+  ASSERT_FLOAT_EQ(25, p[4]);
+}
+
+TEST(StatisticsTest, mannWhitneyU) {
+  // no overlap: U is 0 (a is smaller everywhere) and the difference is significant
+  std::vector<double> a {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  std::vector<double> b {11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+  auto result = timed::utils::mannWhitneyU(a, b);
+  ASSERT_DOUBLE_EQ(0, result.u);
+  ASSERT_LT(result.z, 0);
+  ASSERT_LT(result.pValue, 0.001);
+  ASSERT_DOUBLE_EQ(100, timed::utils::mannWhitneyU(b, a).u);
+  // same distribution
+  auto same = timed::utils::mannWhitneyU(a, a);
+  ASSERT_DOUBLE_EQ(50, same.u);
+  ASSERT_GT(same.pValue, 0.9);
+  // all values tied: no evidence
+  ASSERT_DOUBLE_EQ(1, timed::utils::mannWhitneyU({3, 3, 3}, {3, 3}).pValue);
+  ASSERT_DOUBLE_EQ(1, timed::utils::mannWhitneyU({}, {1}).pValue);
+}
+
+TEST(StatisticsTest, bootstrapMedianRatio) {
+  std::vector<double> a;
+  std::vector<double> b;
+  for (int i = 0; i < 200; ++i) {
+    a.push_back(100 + i % 10);
+    b.push_back(2 * (100 + i % 10));
+  }
+  auto interval = timed::utils::bootstrapMedianRatio(a, b, 0.95, 500, 1);
+  ASSERT_LE(interval.low, 2.0);
+  ASSERT_GE(interval.high, 2.0);
+  ASSERT_GT(interval.low, 1.8);
+  ASSERT_LT(interval.high, 2.2);
+  // deterministic for a seed
+  auto again = timed::utils::bootstrapMedianRatio(a, b, 0.95, 500, 1);
+  ASSERT_EQ(interval.low, again.low);
+  ASSERT_EQ(interval.high, again.high);
+}
+
+TEST(StatisticsTest, wilcoxonSignedRank) {
+  // all differences positive: W is the sum of all ranks
+  std::vector<double> positive {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  auto result = timed::utils::wilcoxonSignedRank(positive);
+  ASSERT_DOUBLE_EQ(78, result.w);
+  ASSERT_GT(result.z, 0);
+  ASSERT_LT(result.pValue, 0.01);
+  // symmetric around zero, zeros are dropped
+  auto symmetric = timed::utils::wilcoxonSignedRank({-3, -2, -1, 0, 1, 2, 3});
+  ASSERT_DOUBLE_EQ(10.5, symmetric.w);
+  ASSERT_DOUBLE_EQ(1, symmetric.pValue);
+  ASSERT_DOUBLE_EQ(1, timed::utils::wilcoxonSignedRank({0, 0}).pValue);
+}
+
+TEST(StatisticsTest, bootstrapMedian) {
+  std::vector<double> vec;
+  for (int i = 0; i < 200; ++i) { vec.push_back(1 + 0.01 * (i % 11 - 5)); }
+  auto interval = timed::utils::bootstrapMedian(vec, 0.95, 500, 1);
+  ASSERT_LE(interval.low, 1.0);
+  ASSERT_GE(interval.high, 1.0);
+  ASSERT_GE(interval.low, 0.95);
+  ASSERT_LE(interval.high, 1.05);
+  ASSERT_DOUBLE_EQ(0, timed::utils::bootstrapMedian({}, 0.95, 500).high);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,30 @@
+// Copyright Leon Freist
+// Author Leon Freist <freist@informatik.uni-freiburg.de>
+//
+// This file is part of the "timed"-library which is licenced under the MIT-license. For more detail read LICENCE.
+
+#include <gtest/gtest.h>
+
+#include "timed/utils/Units.h"
+
+TEST(UnitsTest, formatSI) {
+  ASSERT_EQ("0.00 B/s", timed::utils::formatSI(0, "B/s"));
+  ASSERT_EQ("999.00 B/s", timed::utils::formatSI(999, "B/s"));
+  ASSERT_EQ("1.00 kB/s", timed::utils::formatSI(1000, "B/s"));
+  ASSERT_EQ("1.23 MB/s", timed::utils::formatSI(1234567, "B/s"));
+  ASSERT_EQ("2.50 Gops/s", timed::utils::formatSI(2.5e9, "ops/s"));
+  // largest prefix is kept for huge values
+  ASSERT_EQ("1000.00 EB", timed::utils::formatSI(1e21, "B"));
+}
+
+TEST(UnitsTest, formatIEC) {
+  ASSERT_EQ("1000.00 B/s", timed::utils::formatIEC(1000, "B/s"));
+  ASSERT_EQ("1.00 KiB/s", timed::utils::formatIEC(1024, "B/s"));
+  ASSERT_EQ("1.18 MiB/s", timed::utils::formatIEC(1234567, "B/s"));
+  ASSERT_EQ("1.00 GiB", timed::utils::formatIEC(1024.0 * 1024 * 1024, "B"));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}